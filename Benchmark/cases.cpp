@@ -0,0 +1,541 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include "headers/cases.h"
+#include "../JsonParser/headers/parser.h"
+#include "../JsonParser/headers/path.h"
+#include "../JsonParser/headers/push_parser.h"
+#include "../JsonParser/headers/snapshot.h"
+#include "../JsonParser/headers/tree_builder.h"
+#include "../JsonParser/headers/writer.h"
+
+namespace
+{
+	struct Position
+	{
+		double x = 0;
+		double y = 0;
+	};
+
+	struct Record
+	{
+		std::int64_t id = 0;
+		std::string name;
+		std::string email;
+		bool active = false;
+		double score = 0;
+		std::vector<std::string> tags;
+		Position position;
+		std::optional<std::string> note;
+	};
+}
+
+template <>
+struct Json::Binding<Position>
+{
+	static constexpr auto fields = std::make_tuple(
+		Json::field("x", &Position::x),
+		Json::field("y", &Position::y));
+};
+
+template <>
+struct Json::Binding<Record>
+{
+	static constexpr auto fields = std::make_tuple(
+		Json::field("id", &Record::id),
+		Json::field("name", &Record::name),
+		Json::field("email", &Record::email),
+		Json::field("active", &Record::active),
+		Json::field("score", &Record::score),
+		Json::field("tags", &Record::tags),
+		Json::field("position", &Record::position),
+		Json::field("note", &Record::note));
+};
+
+namespace
+{
+	using Benchmark::Case;
+	using Benchmark::Corpus;
+
+	const std::size_t pushChunkSize = 1 << 16;
+
+	/**
+	 * Results of the measured operations are added to it, so the compiler
+	 * cannot drop the work that produced them
+	 */
+	volatile std::size_t checksum = 0;
+
+	/**
+	 * A parser handler that only counts the events
+	 */
+	struct EventCounter
+	{
+		std::size_t count = 0;
+
+		void onObjectOpen() { count++; }
+		void onObjectClose() { count++; }
+		void onListOpen() { count++; }
+		void onListClose() { count++; }
+		void onKey(std::string_view) { count++; }
+		void onValue(bool) { count++; }
+		void onValue(std::int64_t) { count++; }
+		void onValue(std::uint64_t) { count++; }
+		void onValue(double) { count++; }
+		void onValue(std::string_view) { count++; }
+		void onValue(std::nullptr_t) { count++; }
+	};
+
+	/**
+	 * Reads every value of a tree, the way an application would
+	 */
+	std::size_t walk(const Json::Node& node)
+	{
+		switch (node.getType())
+		{
+			case Json::Node::Type::Boolean:
+				return bool(node) ? 1 : 0;
+			case Json::Node::Type::Number:
+				return std::size_t(double(node) != 0);
+			case Json::Node::Type::String:
+				return std::string(node).size();
+			case Json::Node::Type::List:
+			{
+				std::size_t result = 0;
+				for (const auto& element : node.elements())
+					result += walk(*element);
+				return result;
+			}
+			case Json::Node::Type::Object:
+			{
+				std::size_t result = 0;
+				for (const auto& [key, member] : node.items())
+					result += key.size() + walk(*member);
+				return result;
+			}
+			default:
+				return 0;
+		}
+	}
+
+	/**
+	 * Writes the corpus into a temporary file, which is deleted when the
+	 * returned path is released
+	 */
+	std::shared_ptr<const std::string> writeTemporaryFile(const Corpus& corpus, const char* extension)
+	{
+		const std::filesystem::path path = std::filesystem::temp_directory_path() / ("json-benchmark-" + corpus.name + extension);
+		{
+			std::ofstream file(path, std::ios::binary);
+			file.write(corpus.text.data(), corpus.text.size());
+		}
+
+		return std::shared_ptr<const std::string>(new std::string(path.string()), [](const std::string* fileName)
+		{
+			std::remove(fileName->c_str());
+			delete fileName;
+		});
+	}
+
+	std::shared_ptr<Json::Node> parseTree(const Corpus& corpus, Json::Parser::NumberConversion numberConversion = Json::Parser::NumberConversion::Eager)
+	{
+		Json::Parser parser;
+		return parser.parse(corpus.text.data(), corpus.text.size(), numberConversion);
+	}
+
+	/**
+	 * Parses the corpus the way the parser did before it pulled the tokens
+	 * on demand: the whole token list is built first, and the tree from it
+	 * afterwards. The corpora are valid JSON, so the grammar is not checked.
+	 */
+	std::shared_ptr<Json::Node> parseTwoPass(const Corpus& corpus)
+	{
+		Json::Tokenizer tokenizer(corpus.text.data(), corpus.text.size());
+		tokenizer.setNumberConversion(true);
+		const std::vector<Json::Token> tokens = tokenizer.tokenize();
+
+		Json::TreeBuilder builder;
+		for (std::size_t i = 0; i < tokens.size(); i++)
+		{
+			const Json::Token& token = tokens[i];
+			switch (token.getType())
+			{
+				case Json::Token::Type::ObjectOpen:
+					builder.onObjectOpen();
+					break;
+				case Json::Token::Type::ObjectClose:
+					builder.onObjectClose();
+					break;
+				case Json::Token::Type::ListOpen:
+					builder.onListOpen();
+					break;
+				case Json::Token::Type::ListClose:
+					builder.onListClose();
+					break;
+				case Json::Token::Type::Boolean:
+					builder.onValue(token.getValue() == "true");
+					break;
+				case Json::Token::Type::Null:
+					builder.onValue(nullptr);
+					break;
+				case Json::Token::Type::Number:
+				{
+					const Json::Number& number = token.getNumber();
+					if (number.getType() == Json::Number::Type::Integer)
+						builder.onValue(number.getInteger());
+					else if (number.getType() == Json::Number::Type::Unsigned)
+						builder.onValue(number.getUnsigned());
+					else
+						builder.onValue(number.getDouble());
+					break;
+				}
+				case Json::Token::Type::String:
+					if (i + 1 < tokens.size() && tokens[i + 1].getType() == Json::Token::Type::Colon)
+						builder.onKey(token.getValue());
+					else
+						builder.onValue(token.getValue());
+					break;
+				default:
+					break;
+			}
+		}
+		return builder.getRoot();
+	}
+
+	bool isDocument(const Corpus& corpus)
+	{
+		return corpus.shape != Corpus::Shape::Lines;
+	}
+
+	bool isRecordList(const Corpus& corpus)
+	{
+		return corpus.shape == Corpus::Shape::Records;
+	}
+
+	bool isLines(const Corpus& corpus)
+	{
+		return corpus.shape == Corpus::Shape::Lines;
+	}
+}
+
+/**
+ * Returns every benchmark case, in the order they are run
+ */
+std::vector<Case> Benchmark::getCases()
+{
+	std::vector<Case> cases;
+
+	cases.push_back(Case{ "tokenize", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		return [&corpus]
+		{
+			Json::Tokenizer tokenizer(corpus.text.data(), corpus.text.size());
+			tokenizer.setNumberConversion(true);
+
+			std::size_t count = 0;
+			while (tokenizer.hasMoreTokens())
+			{
+				tokenizer.getToken();
+				count++;
+			}
+			checksum += count;
+		};
+	} });
+
+	cases.push_back(Case{ "parse", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		return [&corpus]
+		{
+			checksum += parseTree(corpus)->size();
+		};
+	} });
+
+	cases.push_back(Case{ "parse-two-pass", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		return [&corpus]
+		{
+			checksum += parseTwoPass(corpus)->size();
+		};
+	} });
+
+	cases.push_back(Case{ "parse-file", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		std::shared_ptr<const std::string> fileName = writeTemporaryFile(corpus, ".json");
+		return [fileName]
+		{
+			Json::Parser parser;
+			checksum += parser.parse(*fileName)->size();
+		};
+	} });
+
+	cases.push_back(Case{ "parse-lazy-numbers", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		return [&corpus]
+		{
+			checksum += parseTree(corpus, Json::Parser::NumberConversion::Lazy)->size();
+		};
+	} });
+
+	cases.push_back(Case{ "parse-view", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		return [&corpus]
+		{
+			Json::Parser parser;
+			checksum += parser.parseView(corpus.text.data(), corpus.text.size()).getRoot()->size();
+		};
+	} });
+
+	cases.push_back(Case{ "parse-events", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		return [&corpus]
+		{
+			Json::Parser parser;
+			EventCounter counter;
+			parser.parse(corpus.text.data(), corpus.text.size(), counter);
+			checksum += counter.count;
+		};
+	} });
+
+	cases.push_back(Case{ "parse-push", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		return [&corpus]
+		{
+			EventCounter counter;
+			Json::PushParser<EventCounter> pushParser(counter);
+
+			for (std::size_t offset = 0; offset < corpus.text.size(); offset += pushChunkSize)
+			{
+				pushParser.feed(corpus.text.data() + offset, std::min(pushChunkSize, corpus.text.size() - offset));
+			}
+			pushParser.finish();
+			checksum += counter.count;
+		};
+	} });
+
+	cases.push_back(Case{ "parse-document", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		return [&corpus]
+		{
+			Json::Parser parser;
+			Json::Document document = parser.parseDocument(corpus.text.data(), corpus.text.size());
+			checksum += std::size_t(document.getRoot().getType());
+		};
+	} });
+
+	cases.push_back(Case{ "parse-document-flat", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		return [&corpus]
+		{
+			Json::Parser parser;
+			Json::Document document = parser.parseDocument(corpus.text.data(), corpus.text.size(), Json::Document::ObjectStorage::Flat);
+			checksum += std::size_t(document.getRoot().getType());
+		};
+	} });
+
+	cases.push_back(Case{ "parse-tape", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		return [&corpus]
+		{
+			Json::Parser parser;
+			Json::Tape tape = parser.parseTape(corpus.text.data(), corpus.text.size());
+			checksum += tape.getWords().size();
+		};
+	} });
+
+	cases.push_back(Case{ "parse-lazy", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		return [&corpus]
+		{
+			Json::LazyDocument document(corpus.text.data(), corpus.text.size());
+			checksum += std::size_t(document.getRoot()[0u].getType());
+		};
+	} });
+
+	// Thread count 0 is one thread per core, the others show the scaling
+	// against parse.
+	for (unsigned threadCount : { 0u, 1u, 2u, 4u })
+	{
+		const std::string suffix = threadCount == 0 ? "" : "-" + std::to_string(threadCount) + "-threads";
+
+		cases.push_back(Case{ "parse-parallel" + suffix, isDocument, [threadCount](const Corpus& corpus) -> Case::Operation
+		{
+			return [&corpus, threadCount]
+			{
+				Json::Parser parser;
+				checksum += parser.parseParallel(corpus.text.data(), corpus.text.size(), threadCount)->size();
+			};
+		} });
+	}
+
+	cases.push_back(Case{ "access-node", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		std::shared_ptr<Json::Node> root = parseTree(corpus);
+		return [root]
+		{
+			checksum += walk(*root);
+		};
+	} });
+
+	cases.push_back(Case{ "query-node", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		std::shared_ptr<Json::Node> root = parseTree(corpus);
+		std::shared_ptr<Json::Path> path = std::make_shared<Json::Path>(corpus.queryPath);
+		return [root, path]
+		{
+			checksum += path->findAll(*root).size();
+		};
+	} });
+
+	cases.push_back(Case{ "query-document", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		Json::Parser parser;
+		std::shared_ptr<Json::Document> document = std::make_shared<Json::Document>(parser.parseDocument(corpus.text.data(), corpus.text.size()));
+		std::shared_ptr<Json::Path> path = std::make_shared<Json::Path>(corpus.queryPath);
+		return [document, path]
+		{
+			checksum += path->findAll(document->getRoot()).size();
+		};
+	} });
+
+	cases.push_back(Case{ "to-string", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		std::shared_ptr<Json::Node> root = parseTree(corpus);
+		return [root]
+		{
+			checksum += root->toString().size();
+		};
+	} });
+
+	cases.push_back(Case{ "write-compact", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		std::shared_ptr<Json::Node> root = parseTree(corpus);
+		return [root]
+		{
+			std::string text;
+			{
+				Json::Writer writer(text);
+				writer.write(*root);
+			}
+			checksum += text.size();
+		};
+	} });
+
+	cases.push_back(Case{ "write-lazy-numbers", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		std::shared_ptr<Json::Node> root = parseTree(corpus, Json::Parser::NumberConversion::Lazy);
+		return [root]
+		{
+			std::string text;
+			{
+				Json::Writer writer(text);
+				writer.write(*root);
+			}
+			checksum += text.size();
+		};
+	} });
+
+	cases.push_back(Case{ "snapshot-load", isDocument, [](const Corpus& corpus) -> Case::Operation
+	{
+		std::shared_ptr<const std::string> fileName = writeTemporaryFile(corpus, ".snapshot");
+		Json::Parser parser;
+		Json::Snapshot::save(parser.parseTape(corpus.text.data(), corpus.text.size()), *fileName);
+		return [fileName]
+		{
+			Json::Snapshot snapshot(*fileName);
+			checksum += std::size_t(snapshot.getRoot()[0u].getType());
+		};
+	} });
+
+	cases.push_back(Case{ "bind", isRecordList, [](const Corpus& corpus) -> Case::Operation
+	{
+		return [&corpus]
+		{
+			Json::Parser parser;
+			checksum += parser.parseAs<std::vector<Record>>(corpus.text.data(), corpus.text.size()).size();
+		};
+	} });
+
+	cases.push_back(Case{ "bind-via-node", isRecordList, [](const Corpus& corpus) -> Case::Operation
+	{
+		return [&corpus]
+		{
+			std::shared_ptr<Json::Node> root = parseTree(corpus);
+			std::vector<Record> records;
+
+			for (const auto& element : root->elements())
+			{
+				Record record;
+				record.id = element->at("id")->getAs<std::int64_t>();
+				record.name = element->at("name")->getAs<std::string>();
+				record.email = element->at("email")->getAs<std::string>();
+				record.active = element->at("active")->getAs<bool>();
+				record.score = element->at("score")->getAs<double>();
+				for (const auto& tag : element->at("tags")->elements())
+					record.tags.push_back(tag->getAs<std::string>());
+				record.position.x = element->at("position")->at("x")->getAs<double>();
+				record.position.y = element->at("position")->at("y")->getAs<double>();
+				if (element->at("note")->getType() == Json::Node::Type::String)
+					record.note = element->at("note")->getAs<std::string>();
+				records.push_back(std::move(record));
+			}
+			checksum += records.size();
+		};
+	} });
+
+	// Thread count 0 is one thread per core, the others show the scaling
+	// against parse-lines-sequential.
+	for (unsigned threadCount : { 0u, 1u, 2u, 4u })
+	{
+		const std::string suffix = threadCount == 0 ? "" : "-" + std::to_string(threadCount) + "-threads";
+
+		cases.push_back(Case{ "parse-lines" + suffix, isLines, [threadCount](const Corpus& corpus) -> Case::Operation
+		{
+			return [&corpus, threadCount]
+			{
+				Json::Parser parser;
+				std::size_t count = 0;
+				parser.parseLines(corpus.text.data(), corpus.text.size(), [&count](std::shared_ptr<Json::Node>) { count++; }, Json::Parser::LineOrder::Ordered, threadCount);
+				checksum += count;
+			};
+		} });
+
+		cases.push_back(Case{ "parse-lines-unordered" + suffix, isLines, [threadCount](const Corpus& corpus) -> Case::Operation
+		{
+			return [&corpus, threadCount]
+			{
+				Json::Parser parser;
+				std::size_t count = 0;
+				parser.parseLines(corpus.text.data(), corpus.text.size(), [&count](std::shared_ptr<Json::Node>) { count++; }, Json::Parser::LineOrder::Unordered, threadCount);
+				checksum += count;
+			};
+		} });
+	}
+
+	cases.push_back(Case{ "parse-lines-sequential", isLines, [](const Corpus& corpus) -> Case::Operation
+	{
+		return [&corpus]
+		{
+			Json::Parser parser;
+			std::size_t count = 0;
+			std::size_t begin = 0;
+
+			while (begin < corpus.text.size())
+			{
+				std::size_t end = corpus.text.find('\n', begin);
+				if (end == std::string::npos)
+					end = corpus.text.size();
+
+				if (end > begin)
+				{
+					parser.parse(corpus.text.data() + begin, end - begin);
+					count++;
+				}
+				begin = end + 1;
+			}
+			checksum += count;
+		};
+	} });
+
+	return cases;
+}
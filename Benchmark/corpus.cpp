@@ -0,0 +1,287 @@
+#include <cmath>
+#include <random>
+#include "headers/corpus.h"
+#include "../JsonParser/headers/writer.h"
+
+namespace
+{
+	using Random = std::mt19937_64;
+
+	const unsigned deepNestingDepth = 128;
+	const unsigned wideMemberCount = 512;
+	const unsigned numbersPerList = 256;
+
+	const char* const words[] = {
+		"lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit",
+		"sed", "do", "eiusmod", "tempor", "incididunt", "ut", "labore", "et",
+		"magna", "aliqua", "enim", "minim", "veniam", "quis", "nostrud", "exercitation",
+		"árvíztűrő", "tükörfúrógép", "naïve", "café", "Ελληνικά", "日本語", "данные", "😀",
+		"\"quoted\"", "C:\\Temp", "tab\tseparated", "control\x01"
+	};
+
+	std::string makeWords(Random& random, unsigned minimum, unsigned maximum)
+	{
+		const unsigned count = minimum + unsigned(random() % (maximum - minimum + 1));
+		std::string result;
+
+		for (unsigned i = 0; i < count; i++)
+		{
+			if (i != 0)
+				result += (random() % 16 == 0) ? "\n" : " ";
+			result += words[random() % (sizeof(words) / sizeof(words[0]))];
+		}
+		return result;
+	}
+
+	std::string makeName(Random& random)
+	{
+		std::string name;
+		const unsigned length = 4 + unsigned(random() % 8);
+		for (unsigned i = 0; i < length; i++)
+		{
+			name += char('a' + random() % 26);
+		}
+		return name;
+	}
+
+	void writeDeep(Json::Writer& writer, Random& random, unsigned depth)
+	{
+		if (depth == 0)
+		{
+			writer.onValue(std::string_view("leaf"));
+		}
+		else if (depth % 2 == 0)
+		{
+			writer.onObjectOpen();
+			writer.onKey("depth");
+			writer.onValue(std::int64_t(depth));
+			writer.onKey("child");
+			writeDeep(writer, random, depth - 1);
+			writer.onObjectClose();
+		}
+		else
+		{
+			writer.onListOpen();
+			writer.onValue(random() % 2 == 0);
+			writeDeep(writer, random, depth - 1);
+			writer.onListClose();
+		}
+	}
+
+	void writeWide(Json::Writer& writer, Random& random)
+	{
+		writer.onObjectOpen();
+		for (unsigned i = 0; i < wideMemberCount; i++)
+		{
+			writer.onKey("field_" + std::to_string(i));
+			switch (i % 5)
+			{
+				case 0:
+					writer.onValue(std::int64_t(random() % 100000));
+					break;
+				case 1:
+					writer.onValue(std::string_view(makeName(random)));
+					break;
+				case 2:
+					writer.onValue(double(random() % 1000000) / 1000.0);
+					break;
+				case 3:
+					writer.onValue(random() % 2 == 0);
+					break;
+				default:
+					writer.onValue(nullptr);
+					break;
+			}
+		}
+		writer.onObjectClose();
+	}
+
+	void writeNumbers(Json::Writer& writer, Random& random)
+	{
+		std::uniform_real_distribution<double> real(-1e6, 1e6);
+		std::uniform_int_distribution<int> exponent(-30, 30);
+
+		writer.onListOpen();
+		for (unsigned i = 0; i < numbersPerList; i++)
+		{
+			switch (random() % 5)
+			{
+				case 0:
+					writer.onValue(std::int64_t(random() % 2001) - 1000);
+					break;
+				case 1:
+					writer.onValue(std::int64_t(random() >> 1));
+					break;
+				case 2:
+					writer.onValue(std::uint64_t(random() | (std::uint64_t(1) << 63)));
+					break;
+				case 3:
+					writer.onValue(real(random));
+					break;
+				default:
+					writer.onValue(real(random) * std::pow(10.0, exponent(random)));
+					break;
+			}
+		}
+		writer.onListClose();
+	}
+
+	void writeStrings(Json::Writer& writer, Random& random)
+	{
+		writer.onObjectOpen();
+		writer.onKey("title");
+		writer.onValue(std::string_view(makeWords(random, 3, 8)));
+		writer.onKey("author");
+		writer.onValue(std::string_view(makeName(random) + " " + makeName(random)));
+		writer.onKey("body");
+		writer.onValue(std::string_view(makeWords(random, 40, 120)));
+		writer.onKey("keywords");
+		writer.onListOpen();
+		for (unsigned i = random() % 6; i > 0; i--)
+		{
+			writer.onValue(std::string_view(makeWords(random, 1, 1)));
+		}
+		writer.onListClose();
+		writer.onObjectClose();
+	}
+
+	void writeRecord(Json::Writer& writer, Random& random, std::int64_t id)
+	{
+		writer.onObjectOpen();
+		writer.onKey("id");
+		writer.onValue(std::int64_t(1000000000000) + id);
+		writer.onKey("name");
+		const std::string name = makeName(random);
+		writer.onValue(std::string_view(name));
+		writer.onKey("email");
+		writer.onValue(std::string_view(name + "@example.com"));
+		writer.onKey("active");
+		writer.onValue(random() % 3 != 0);
+		writer.onKey("score");
+		writer.onValue(double(random() % 100000) / 100.0);
+		writer.onKey("tags");
+		writer.onListOpen();
+		for (unsigned i = random() % 5; i > 0; i--)
+		{
+			writer.onValue(std::string_view(words[random() % 16]));
+		}
+		writer.onListClose();
+		writer.onKey("position");
+		writer.onObjectOpen();
+		writer.onKey("x");
+		writer.onValue(double(std::int64_t(random() % 2000000) - 1000000) / 1000.0);
+		writer.onKey("y");
+		writer.onValue(double(std::int64_t(random() % 2000000) - 1000000) / 1000.0);
+		writer.onObjectClose();
+		writer.onKey("note");
+		if (random() % 4 == 0)
+			writer.onValue(std::string_view(makeWords(random, 2, 6)));
+		else
+			writer.onValue(nullptr);
+		writer.onObjectClose();
+	}
+
+	/**
+	 * Writes a list of generated elements until the text reaches the
+	 * target size
+	 */
+	template <typename GenerateElement>
+	std::string generateList(std::size_t targetSize, Json::Writer::Style style, GenerateElement generateElement)
+	{
+		std::string text;
+		{
+			Json::Writer writer(text, style);
+			writer.onListOpen();
+
+			std::int64_t count = 0;
+			do
+			{
+				generateElement(writer, count);
+				if (++count % 16 == 0)
+					writer.flush();
+			}
+			while (text.size() < targetSize);
+
+			writer.onListClose();
+			writer.flush();
+		}
+		return text;
+	}
+
+	std::string generateLines(std::size_t targetSize, Random& random, std::size_t& lineCount)
+	{
+		std::string text;
+		lineCount = 0;
+
+		while (text.size() < targetSize)
+		{
+			{
+				Json::Writer writer(text, Json::Writer::Style::Compact);
+				writeRecord(writer, random, std::int64_t(lineCount));
+			}
+			text += '\n';
+			lineCount++;
+		}
+		return text;
+	}
+}
+
+/**
+ * Generates one corpus of every shape
+ *
+ * The corpora only depend on the seed, so results of different versions
+ * of the parser are measured on the same inputs.
+ *
+ * @param targetSize approximate size of each corpus in bytes
+ * @param seed seed of the random generator
+ */
+std::vector<Benchmark::Corpus> Benchmark::generateCorpora(std::size_t targetSize, std::uint64_t seed)
+{
+	std::vector<Corpus> corpora;
+
+	{
+		Random random(seed);
+		corpora.push_back(Corpus{ "deep", Corpus::Shape::Deep, generateList(targetSize, Json::Writer::Style::Compact, [&](Json::Writer& writer, std::int64_t)
+		{
+			writeDeep(writer, random, deepNestingDepth);
+		}), 1, "$[*].child[1].child.depth" });
+	}
+	{
+		Random random(seed);
+		corpora.push_back(Corpus{ "wide", Corpus::Shape::Wide, generateList(targetSize, Json::Writer::Style::Compact, [&](Json::Writer& writer, std::int64_t)
+		{
+			writeWide(writer, random);
+		}), 1, "$[*].field_100" });
+	}
+	{
+		Random random(seed);
+		corpora.push_back(Corpus{ "numbers", Corpus::Shape::Numbers, generateList(targetSize, Json::Writer::Style::Compact, [&](Json::Writer& writer, std::int64_t)
+		{
+			writeNumbers(writer, random);
+		}), 1, "$[*][10]" });
+	}
+	{
+		Random random(seed);
+		corpora.push_back(Corpus{ "strings", Corpus::Shape::Strings, generateList(targetSize, Json::Writer::Style::Compact, [&](Json::Writer& writer, std::int64_t)
+		{
+			writeStrings(writer, random);
+		}), 1, "$[*].title" });
+	}
+	for (Json::Writer::Style style : { Json::Writer::Style::Compact, Json::Writer::Style::Pretty })
+	{
+		Random random(seed);
+		const bool isPretty = (style == Json::Writer::Style::Pretty);
+		corpora.push_back(Corpus{ isPretty ? "records-pretty" : "records", Corpus::Shape::Records, generateList(targetSize, style, [&](Json::Writer& writer, std::int64_t id)
+		{
+			writeRecord(writer, random, id);
+		}), 1, "$[?(@.active == true)].position.x" });
+	}
+	{
+		Random random(seed);
+		std::size_t lineCount;
+		std::string text = generateLines(targetSize, random, lineCount);
+		corpora.push_back(Corpus{ "lines", Corpus::Shape::Lines, std::move(text), lineCount, "" });
+	}
+
+	return corpora;
+}
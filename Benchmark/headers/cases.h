@@ -0,0 +1,29 @@
+#ifndef BENCHMARK_CASES_H
+#define BENCHMARK_CASES_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "corpus.h"
+
+namespace Benchmark
+{
+	/**
+	 * One operation measured on the corpora it applies to
+	 *
+	 * prepare() does the untimed work, such as parsing a document that is
+	 * only accessed by the measurement, and returns the timed operation.
+	 */
+	struct Case
+	{
+		using Operation = std::function<void()>;
+
+		std::string name;
+		std::function<bool(const Corpus& corpus)> accepts;
+		std::function<Operation(const Corpus& corpus)> prepare;
+	};
+
+	std::vector<Case> getCases();
+}
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef BENCHMARK_CORPUS_H
+#define BENCHMARK_CORPUS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+	/**
+	 * A generated JSON input of a given shape
+	 *
+	 * Every corpus except the JSON Lines one is a single document whose
+	 * root is a list, so it can also be parsed in parallel.
+	 */
+	struct Corpus
+	{
+		enum class Shape
+		{
+			Deep,
+			Wide,
+			Numbers,
+			Strings,
+			Records,
+			Lines
+		};
+
+		std::string name;
+		Shape shape;
+		std::string text;
+		std::size_t documentCount;
+		std::string queryPath;
+	};
+
+	std::vector<Corpus> generateCorpora(std::size_t targetSize, std::uint64_t seed);
+}
+
+#endif
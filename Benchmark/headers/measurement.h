@@ -0,0 +1,40 @@
+#ifndef BENCHMARK_MEASUREMENT_H
+#define BENCHMARK_MEASUREMENT_H
+
+#include <cstdint>
+#include <chrono>
+
+namespace Benchmark
+{
+	/**
+	 * Heap usage counted by the replaced global operator new and delete
+	 *
+	 * Allocations made with an extended alignment are not counted.
+	 */
+	struct AllocationCounters
+	{
+		std::uint64_t count;
+		std::uint64_t bytes;
+		std::uint64_t liveBytes;
+		std::uint64_t peakLiveBytes;
+	};
+
+	void resetAllocationCounters() noexcept;
+	AllocationCounters getAllocationCounters() noexcept;
+
+	void resetPeakResidentBytes() noexcept;
+	std::uint64_t getPeakResidentBytes() noexcept;
+
+	class Stopwatch
+	{
+	public:
+		Stopwatch() noexcept;
+
+		double getSeconds() const noexcept;
+
+	private:
+		std::chrono::steady_clock::time_point start;
+	};
+}
+
+#endif
@@ -0,0 +1,293 @@
+/**
+ * Measures the parser on generated corpora of different shapes
+ *
+ * Usage: Benchmark [--size=<MB>] [--iterations=<count>] [--seed=<seed>]
+ *                  [--filter=<text>] [--output=<file>] [--corpora=<directory>]
+ *
+ * Results are printed as a table to the standard error, and as JSON to
+ * the standard output (or the output file), so they can be compared
+ * across versions. --filter only runs the cases whose "corpus/case" name
+ * contains the text, --corpora writes the generated corpora into a
+ * directory and exits.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "headers/cases.h"
+#include "headers/corpus.h"
+#include "headers/measurement.h"
+#include "../JsonParser/headers/statistics.h"
+#include "../JsonParser/headers/writer.h"
+
+namespace
+{
+	struct Options
+	{
+		std::size_t size = 16;
+		unsigned iterations = 5;
+		std::uint64_t seed = 1;
+		std::string filter;
+		std::string output;
+		std::string corpora;
+	};
+
+	struct Result
+	{
+		std::string corpus;
+		std::string name;
+		std::size_t bytes;
+		std::size_t documents;
+		double seconds;
+		double minimumSeconds;
+		Benchmark::AllocationCounters allocations;
+		std::uint64_t peakResidentBytes;
+		std::string error;
+	};
+
+	bool readOption(const std::string& argument, const char* name, std::string& value)
+	{
+		const std::string prefix = std::string("--") + name + "=";
+		if (argument.compare(0, prefix.size(), prefix) != 0)
+			return false;
+
+		value = argument.substr(prefix.size());
+		return true;
+	}
+
+	Options readOptions(int argc, char* argv[])
+	{
+		Options options;
+
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string argument = argv[i];
+			std::string value;
+
+			if (readOption(argument, "size", value))
+				options.size = std::stoul(value);
+			else if (readOption(argument, "iterations", value))
+				options.iterations = std::max(1ul, std::stoul(value));
+			else if (readOption(argument, "seed", value))
+				options.seed = std::stoull(value);
+			else if (readOption(argument, "filter", value))
+				options.filter = value;
+			else if (readOption(argument, "output", value))
+				options.output = value;
+			else if (readOption(argument, "corpora", value))
+				options.corpora = value;
+			else
+				throw std::invalid_argument("Unknown argument: " + argument);
+		}
+
+		return options;
+	}
+
+	/**
+	 * Runs an operation once to warm up, then measures it the given
+	 * number of times
+	 *
+	 * The reported time is the median, the allocations are the ones of the
+	 * last run, and the heap peak is the highest of all runs.
+	 */
+	Result measure(const Benchmark::Case& benchmarkCase, const Benchmark::Corpus& corpus, unsigned iterations)
+	{
+		Result result = Result();
+		result.corpus = corpus.name;
+		result.name = benchmarkCase.name;
+		result.bytes = corpus.text.size();
+		result.documents = corpus.documentCount;
+
+		try
+		{
+			Benchmark::Case::Operation operation = benchmarkCase.prepare(corpus);
+			operation();
+
+			Benchmark::resetPeakResidentBytes();
+
+			std::vector<double> times;
+			std::uint64_t peakLiveBytes = 0;
+
+			for (unsigned i = 0; i < iterations; i++)
+			{
+				Benchmark::resetAllocationCounters();
+				const std::uint64_t liveBefore = Benchmark::getAllocationCounters().liveBytes;
+
+				Benchmark::Stopwatch stopwatch;
+				operation();
+				times.push_back(stopwatch.getSeconds());
+
+				result.allocations = Benchmark::getAllocationCounters();
+				peakLiveBytes = std::max(peakLiveBytes, result.allocations.peakLiveBytes - liveBefore);
+			}
+
+			result.allocations.peakLiveBytes = peakLiveBytes;
+			result.peakResidentBytes = Benchmark::getPeakResidentBytes();
+
+			std::sort(times.begin(), times.end());
+			result.seconds = times[times.size() / 2];
+			result.minimumSeconds = times.front();
+		}
+		catch (const std::exception& exception)
+		{
+			result.error = exception.what();
+		}
+
+		return result;
+	}
+
+	void printRow(const Result& result)
+	{
+		char row[256];
+
+		if (!result.error.empty())
+		{
+			std::snprintf(row, sizeof(row), "%-16s %-24s failed: ", result.corpus.c_str(), result.name.c_str());
+			std::cerr << row << result.error << std::endl;
+			return;
+		}
+
+		std::snprintf(row, sizeof(row), "%-16s %-24s %10.3f ms %10.1f MB/s %12.1f docs/s %12.1f allocs/doc %10.1f MB heap %10.1f MB rss",
+			result.corpus.c_str(),
+			result.name.c_str(),
+			result.seconds * 1e3,
+			result.bytes / 1e6 / result.seconds,
+			result.documents / result.seconds,
+			double(result.allocations.count) / result.documents,
+			result.allocations.peakLiveBytes / 1e6,
+			result.peakResidentBytes / 1e6);
+		std::cerr << row << std::endl;
+	}
+
+	void writeResults(std::ostream& stream, const Options& options, const std::vector<Result>& results)
+	{
+		Json::Writer writer(stream, Json::Writer::Style::Pretty);
+
+		writer.onObjectOpen();
+		writer.onKey("format");
+		writer.onValue(std::int64_t(1));
+		writer.onKey("corpusSize");
+		writer.onValue(std::uint64_t(options.size) << 20);
+		writer.onKey("seed");
+		writer.onValue(std::uint64_t(options.seed));
+		writer.onKey("iterations");
+		writer.onValue(std::int64_t(options.iterations));
+		writer.onKey("hardwareThreads");
+		writer.onValue(std::int64_t(std::thread::hardware_concurrency()));
+
+		writer.onKey("results");
+		writer.onListOpen();
+		for (const Result& result : results)
+		{
+			writer.onObjectOpen();
+			writer.onKey("corpus");
+			writer.onValue(std::string_view(result.corpus));
+			writer.onKey("case");
+			writer.onValue(std::string_view(result.name));
+			writer.onKey("bytes");
+			writer.onValue(std::uint64_t(result.bytes));
+			writer.onKey("documents");
+			writer.onValue(std::uint64_t(result.documents));
+
+			if (!result.error.empty())
+			{
+				writer.onKey("error");
+				writer.onValue(std::string_view(result.error));
+			}
+			else
+			{
+				writer.onKey("seconds");
+				writer.onValue(result.seconds);
+				writer.onKey("minimumSeconds");
+				writer.onValue(result.minimumSeconds);
+				writer.onKey("megabytesPerSecond");
+				writer.onValue(result.bytes / 1e6 / result.seconds);
+				writer.onKey("documentsPerSecond");
+				writer.onValue(result.documents / result.seconds);
+				writer.onKey("allocationsPerDocument");
+				writer.onValue(double(result.allocations.count) / result.documents);
+				writer.onKey("allocatedBytesPerDocument");
+				writer.onValue(double(result.allocations.bytes) / result.documents);
+				writer.onKey("peakHeapBytes");
+				writer.onValue(std::uint64_t(result.allocations.peakLiveBytes));
+				writer.onKey("peakResidentBytes");
+				writer.onValue(std::uint64_t(result.peakResidentBytes));
+			}
+			writer.onObjectClose();
+		}
+		writer.onListClose();
+		writer.onObjectClose();
+		writer.flush();
+
+		stream << std::endl;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	try
+	{
+		options = readOptions(argc, argv);
+	}
+	catch (const std::exception& exception)
+	{
+		std::cerr << exception.what() << std::endl;
+		return 1;
+	}
+
+	// Lets instrumented builds of the library report the allocations this
+	// program counts in its replaced operator new.
+	Json::ParseStatistics::setAllocationCounter([](std::uint64_t& count, std::uint64_t& bytes)
+	{
+		const Benchmark::AllocationCounters counters = Benchmark::getAllocationCounters();
+		count = counters.count;
+		bytes = counters.bytes;
+	});
+
+	Benchmark::Stopwatch generation;
+	const std::vector<Benchmark::Corpus> corpora = Benchmark::generateCorpora(options.size << 20, options.seed);
+	std::cerr << "Generated " << corpora.size() << " corpora of " << options.size << " MB in " << generation.getSeconds() << " s" << std::endl;
+
+	if (!options.corpora.empty())
+	{
+		for (const Benchmark::Corpus& corpus : corpora)
+		{
+			std::ofstream file(options.corpora + "/" + corpus.name + (corpus.shape == Benchmark::Corpus::Shape::Lines ? ".ndjson" : ".json"), std::ios::binary);
+			file.write(corpus.text.data(), corpus.text.size());
+		}
+		return 0;
+	}
+
+	std::vector<Result> results;
+
+	for (const Benchmark::Case& benchmarkCase : Benchmark::getCases())
+	{
+		for (const Benchmark::Corpus& corpus : corpora)
+		{
+			if (!benchmarkCase.accepts(corpus))
+				continue;
+			if ((corpus.name + "/" + benchmarkCase.name).find(options.filter) == std::string::npos)
+				continue;
+
+			results.push_back(measure(benchmarkCase, corpus, options.iterations));
+			printRow(results.back());
+		}
+	}
+
+	if (options.output.empty())
+	{
+		writeResults(std::cout, options, results);
+	}
+	else
+	{
+		std::ofstream file(options.output);
+		writeResults(file, options, results);
+	}
+
+	return 0;
+}
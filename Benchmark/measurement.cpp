@@ -0,0 +1,193 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <string>
+#include "headers/measurement.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+	/**
+	 * Every counted block starts with a header holding its size, so the
+	 * live bytes can be tracked without sized deallocation
+	 */
+	const std::size_t headerSize = alignof(std::max_align_t) > sizeof(std::size_t) ? alignof(std::max_align_t) : sizeof(std::size_t);
+
+	std::atomic<std::uint64_t> allocationCount{ 0 };
+	std::atomic<std::uint64_t> allocatedBytes{ 0 };
+	std::atomic<std::uint64_t> liveBytes{ 0 };
+	std::atomic<std::uint64_t> peakLiveBytes{ 0 };
+
+	void* allocate(std::size_t size) noexcept
+	{
+		char* block = static_cast<char*>(std::malloc(size + headerSize));
+		if (block == nullptr)
+			return nullptr;
+
+		std::memcpy(block, &size, sizeof(size));
+
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+		allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+		const std::uint64_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+		std::uint64_t peak = peakLiveBytes.load(std::memory_order_relaxed);
+		while (live > peak && !peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+		{
+		}
+
+		return block + headerSize;
+	}
+
+	void deallocate(void* pointer) noexcept
+	{
+		if (pointer == nullptr)
+			return;
+
+		char* block = static_cast<char*>(pointer) - headerSize;
+		std::size_t size;
+		std::memcpy(&size, block, sizeof(size));
+
+		liveBytes.fetch_sub(size, std::memory_order_relaxed);
+		std::free(block);
+	}
+
+	void* allocateOrThrow(std::size_t size)
+	{
+		void* pointer = allocate(size == 0 ? 1 : size);
+		if (pointer == nullptr)
+			throw std::bad_alloc();
+		return pointer;
+	}
+}
+
+void* operator new(std::size_t size)
+{
+	return allocateOrThrow(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return allocateOrThrow(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size == 0 ? 1 : size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	deallocate(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+	deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	deallocate(pointer);
+}
+
+/**
+ * Starts counting the allocations of a new measurement, the peak starts
+ * from the memory that is already live
+ */
+void Benchmark::resetAllocationCounters() noexcept
+{
+	allocationCount = 0;
+	allocatedBytes = 0;
+	peakLiveBytes = liveBytes.load();
+}
+
+Benchmark::AllocationCounters Benchmark::getAllocationCounters() noexcept
+{
+	return AllocationCounters{ allocationCount.load(), allocatedBytes.load(), liveBytes.load(), peakLiveBytes.load() };
+}
+
+/**
+ * Restarts the peak resident set size of the process from its current
+ * size, where the operating system supports it (Linux)
+ */
+void Benchmark::resetPeakResidentBytes() noexcept
+{
+#ifdef __linux__
+	std::ofstream clearRefs("/proc/self/clear_refs");
+	if (clearRefs)
+		clearRefs << "5";
+#endif
+}
+
+/**
+ * Returns the largest resident set size of the process since the last
+ * reset, or since it started
+ */
+std::uint64_t Benchmark::getPeakResidentBytes() noexcept
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize;
+	return 0;
+#elif defined(__linux__)
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line))
+	{
+		if (line.compare(0, 6, "VmHWM:") == 0)
+			return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+	}
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#ifdef __APPLE__
+	return (std::uint64_t)usage.ru_maxrss;
+#else
+	return (std::uint64_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+Benchmark::Stopwatch::Stopwatch() noexcept
+{
+	start = std::chrono::steady_clock::now();
+}
+
+double Benchmark::Stopwatch::getSeconds() const noexcept
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include "headers/arena.h"
+
+namespace
+{
+	const std::size_t maximumBlockSize = 1024 * 1024;
+}
+
+Json::Arena::Arena(std::size_t initialBlockSize)
+{
+	current = nullptr;
+	remaining = 0;
+	nextBlockSize = initialBlockSize;
+	allocatedBytes = 0;
+}
+
+Json::Arena::Arena(Arena&& other) noexcept
+	: blocks(std::move(other.blocks)), current(other.current), remaining(other.remaining),
+	nextBlockSize(other.nextBlockSize), allocatedBytes(other.allocatedBytes)
+{
+	other.current = nullptr;
+	other.remaining = 0;
+	other.allocatedBytes = 0;
+}
+
+Json::Arena& Json::Arena::operator=(Arena&& other) noexcept
+{
+	blocks = std::move(other.blocks);
+	current = std::exchange(other.current, nullptr);
+	remaining = std::exchange(other.remaining, 0);
+	nextBlockSize = other.nextBlockSize;
+	allocatedBytes = std::exchange(other.allocatedBytes, 0);
+	return *this;
+}
+
+/**
+ * Returns uninitialized memory that stays valid until the arena is destroyed
+ *
+ * @param size number of bytes to allocate
+ * @param alignment required alignment, a power of two
+ */
+void* Json::Arena::allocate(std::size_t size, std::size_t alignment)
+{
+	std::size_t padding = (alignment - reinterpret_cast<std::uintptr_t>(current) % alignment) % alignment;
+
+	if (padding + size > remaining)
+	{
+		addBlock(size + alignment);
+		padding = (alignment - reinterpret_cast<std::uintptr_t>(current) % alignment) % alignment;
+	}
+
+	char* result = current + padding;
+	current += padding + size;
+	remaining -= padding + size;
+	return result;
+}
+
+/**
+ * Copies a string into the arena, empty strings are not copied
+ */
+std::string_view Json::Arena::copyString(std::string_view string)
+{
+	if (string.empty())
+		return std::string_view();
+
+	char* copy = static_cast<char*>(allocate(string.size(), 1));
+	std::memcpy(copy, string.data(), string.size());
+	return std::string_view(copy, string.size());
+}
+
+/**
+ * Returns the total size of the blocks requested from the heap
+ */
+std::size_t Json::Arena::getAllocatedBytes() const noexcept
+{
+	return allocatedBytes;
+}
+
+/**
+ * Starts a new block, doubling the block size each time so the number
+ * of heap allocations grows only logarithmically with the document size
+ */
+void Json::Arena::addBlock(std::size_t minimumSize)
+{
+	const std::size_t size = std::max(nextBlockSize, minimumSize);
+
+	blocks.push_back(std::unique_ptr<char[]>(new char[size]));
+	current = blocks.back().get();
+	remaining = size;
+	allocatedBytes += size;
+
+	nextBlockSize = std::min(nextBlockSize * 2, maximumBlockSize);
+}
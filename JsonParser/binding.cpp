@@ -0,0 +1,179 @@
+#include "headers/binding.h"
+
+void Json::Binder::onObjectOpen()
+{
+	openContainer(true);
+}
+
+void Json::Binder::onObjectClose()
+{
+	closeContainer();
+}
+
+void Json::Binder::onListOpen()
+{
+	openContainer(false);
+}
+
+void Json::Binder::onListClose()
+{
+	closeContainer();
+}
+
+/**
+ * Looks up the member of the current object that receives the next
+ * value, unknown keys make the value skipped
+ */
+void Json::Binder::onKey(std::string_view key)
+{
+	if (skipDepth > 0)
+		return;
+
+	Frame& frame = frames.back();
+	frame.next = frame.container.type->getMember(frame.container.object, key);
+}
+
+void Json::Binder::onValue(bool value)
+{
+	Target target = nextTarget();
+	if (target.type == nullptr)
+		return;
+
+	target = unwrap(target);
+	if (target.type->setBoolean == nullptr)
+		throwMismatch(target, "a boolean");
+	target.type->setBoolean(target.object, value);
+}
+
+void Json::Binder::onValue(std::int64_t value)
+{
+	Target target = nextTarget();
+	if (target.type == nullptr)
+		return;
+
+	target = unwrap(target);
+	if (target.type->setInteger == nullptr)
+		throwMismatch(target, "an integer");
+	target.type->setInteger(target.object, value);
+}
+
+void Json::Binder::onValue(std::uint64_t value)
+{
+	Target target = nextTarget();
+	if (target.type == nullptr)
+		return;
+
+	target = unwrap(target);
+	if (target.type->setUnsigned == nullptr)
+		throwMismatch(target, "an integer");
+	target.type->setUnsigned(target.object, value);
+}
+
+void Json::Binder::onValue(double value)
+{
+	Target target = nextTarget();
+	if (target.type == nullptr)
+		return;
+
+	target = unwrap(target);
+	if (target.type->setDouble == nullptr)
+		throwMismatch(target, "a floating point number");
+	target.type->setDouble(target.object, value);
+}
+
+void Json::Binder::onValue(std::string_view value)
+{
+	Target target = nextTarget();
+	if (target.type == nullptr)
+		return;
+
+	target = unwrap(target);
+	if (target.type->setString == nullptr)
+		throwMismatch(target, "a string");
+	target.type->setString(target.object, value);
+}
+
+/**
+ * Resets optional members, null is not accepted by any other type
+ */
+void Json::Binder::onValue(std::nullptr_t)
+{
+	Target target = nextTarget();
+	if (target.type == nullptr)
+		return;
+
+	if (target.type->setNull == nullptr)
+		throwMismatch(target, "null");
+	target.type->setNull(target.object);
+}
+
+/**
+ * Returns the value that the next value of the input is read into
+ *
+ * Inside a list a new element is appended for it. The returned type is
+ * null if the value is skipped.
+ */
+Json::Binder::Target Json::Binder::nextTarget()
+{
+	if (skipDepth > 0)
+		return Target();
+
+	if (frames.empty())
+		return root;
+
+	Frame& frame = frames.back();
+	if (frame.container.type->appendElement != nullptr)
+		return frame.container.type->appendElement(frame.container.object);
+
+	return frame.next;
+}
+
+void Json::Binder::openContainer(bool isObject)
+{
+	Target target = nextTarget();
+	if (target.type == nullptr)
+	{
+		skipDepth++;
+		return;
+	}
+
+	target = unwrap(target);
+	if (isObject && target.type->getMember == nullptr)
+		throwMismatch(target, "an object");
+	if (!isObject && target.type->appendElement == nullptr)
+		throwMismatch(target, "a list");
+
+	if (target.type->clear != nullptr)
+		target.type->clear(target.object);
+
+	frames.push_back(Frame{ target, Target() });
+}
+
+void Json::Binder::closeContainer()
+{
+	if (skipDepth > 0)
+	{
+		skipDepth--;
+	}
+	else
+	{
+		frames.pop_back();
+	}
+}
+
+/**
+ * Steps into optional values, creating them if they are empty
+ */
+Json::Binder::Target Json::Binder::unwrap(Target target)
+{
+	while (target.type->unwrap != nullptr)
+	{
+		target = target.type->unwrap(target.object);
+	}
+	return target;
+}
+
+void Json::Binder::throwMismatch(const Target& target, const char* kind)
+{
+	throw Exception(std::string("Expected ") + target.type->name + ", found " + kind);
+}
@@ -0,0 +1,595 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include "headers/document.h"
+#include "headers/writer.h"
+
+namespace
+{
+	const std::size_t hashedObjectThreshold = 8;
+	const std::uint32_t emptySlot = 0;
+}
+
+Json::Key::Key() noexcept : hashValue(0)
+{
+}
+
+Json::Key::Key(std::string_view name, std::uint32_t hash) noexcept : name(name), hashValue(hash)
+{
+}
+
+std::string_view Json::Key::getName() const noexcept
+{
+	return name;
+}
+
+std::uint32_t Json::Key::getHash() const noexcept
+{
+	return hashValue;
+}
+
+/**
+ * Returns whether the key occurs in the document it was interned by
+ */
+bool Json::Key::isValid() const noexcept
+{
+	return name.data() != nullptr;
+}
+
+/**
+ * Hashes a key name with 32-bit FNV-1a
+ */
+std::uint32_t Json::Key::hash(std::string_view name) noexcept
+{
+	std::uint32_t hash = 2166136261u;
+	for (char c : name)
+	{
+		hash = (hash ^ std::uint8_t(c)) * 16777619u;
+	}
+	return hash;
+}
+
+Json::KeyTable::KeyTable() : slots(64), count(0)
+{
+}
+
+/**
+ * Returns the interned copy of a key, copying it into the arena the
+ * first time it is seen
+ *
+ * The copies are null terminated, so even empty keys get a unique address.
+ */
+Json::Key Json::KeyTable::intern(std::string_view name, Arena& arena)
+{
+	const std::uint32_t hash = Key::hash(name);
+	std::size_t slot = findSlot(name, hash);
+
+	if (!slots[slot].isValid())
+	{
+		if (2 * (count + 1) > slots.size())
+		{
+			grow();
+			slot = findSlot(name, hash);
+		}
+
+		char* copy = static_cast<char*>(arena.allocate(name.size() + 1, 1));
+		std::memcpy(copy, name.data(), name.size());
+		copy[name.size()] = '\0';
+
+		slots[slot] = Key(std::string_view(copy, name.size()), hash);
+		count++;
+	}
+	return slots[slot];
+}
+
+/**
+ * Returns the interned copy of a key, or an invalid key if it has not
+ * been interned
+ */
+Json::Key Json::KeyTable::find(std::string_view name) const noexcept
+{
+	return slots[findSlot(name, Key::hash(name))];
+}
+
+std::size_t Json::KeyTable::getSize() const noexcept
+{
+	return count;
+}
+
+std::size_t Json::KeyTable::findSlot(std::string_view name, std::uint32_t hash) const noexcept
+{
+	const std::size_t mask = slots.size() - 1;
+	std::size_t slot = hash & mask;
+
+	while (slots[slot].isValid() && (slots[slot].getHash() != hash || slots[slot].getName() != name))
+	{
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+void Json::KeyTable::grow()
+{
+	std::vector<Key> oldSlots(slots.size() * 2);
+	oldSlots.swap(slots);
+
+	for (const Key& key : oldSlots)
+	{
+		if (key.isValid())
+		{
+			slots[findSlot(key.getName(), key.getHash())] = key;
+		}
+	}
+}
+
+Json::Document::Document(ObjectStorage objectStorage) : objectStorage(objectStorage)
+{
+	Entry* entry = arena.allocateArray<Entry>(1);
+	*entry = Entry();
+	entry->type = Node::Type::Root;
+	root = entry;
+}
+
+Json::Element Json::Document::getRoot() const noexcept
+{
+	return Element(root);
+}
+
+/**
+ * Looks up the interned copy of a key, which makes lookups with it
+ * a comparison of addresses
+ *
+ * @returns the interned key, or an invalid key if no object of the
+ * document has such a member
+ */
+Json::Key Json::Document::intern(std::string_view key) const noexcept
+{
+	return keys.find(key);
+}
+
+/**
+ * Returns the number of slots in the index of a hashed object, a power
+ * of two that keeps the load factor at or below one half
+ */
+std::size_t Json::Document::getSlotCount(std::size_t memberCount) noexcept
+{
+	std::size_t slotCount = 16;
+	while (slotCount < 2 * memberCount)
+	{
+		slotCount *= 2;
+	}
+	return slotCount;
+}
+
+/**
+ * Returns the number of bytes the document holds on the heap
+ */
+std::size_t Json::Document::getAllocatedBytes() const noexcept
+{
+	return arena.getAllocatedBytes();
+}
+
+Json::Element::Element(const Document::Entry* entry) : entry(entry)
+{
+}
+
+Json::Element Json::Element::at(unsigned index) const
+{
+	return (*this)[index];
+}
+
+Json::Element Json::Element::at(std::string_view key) const
+{
+	if (entry->type == Node::Type::Object)
+	{
+		const Document::Member* member = findMember(key, entry->isHashed ? Key::hash(key) : 0, false);
+		if (member != nullptr)
+		{
+			return Element(&member->value);
+		}
+		throw Exception("Key \"" + std::string(key) + "\" does not exists in indexed JSON object");
+	}
+	else throw Exception("Requested map-like indexing on " + getTypeAsString() + " type JSON element");
+}
+
+/**
+ * Looks up a member by a key interned by the same document, comparing
+ * only the addresses of the keys
+ */
+Json::Element Json::Element::at(Key key) const
+{
+	if (entry->type == Node::Type::Object)
+	{
+		const Document::Member* member = key.isValid() ? findMember(key.getName(), key.getHash(), true) : nullptr;
+		if (member != nullptr)
+		{
+			return Element(&member->value);
+		}
+		throw Exception("Key \"" + std::string(key.getName()) + "\" does not exists in indexed JSON object");
+	}
+	else throw Exception("Requested map-like indexing on " + getTypeAsString() + " type JSON element");
+}
+
+/**
+ * Finds a member through the index of a hashed object, or by a linear
+ * search in a flat one
+ *
+ * @param compareAddress whether name is an interned key, which can be
+ * compared by its address instead of its characters
+ */
+const Json::Document::Member* Json::Element::findMember(std::string_view name, std::uint32_t hash, bool compareAddress) const noexcept
+{
+	const Document::Member* members = entry->members;
+
+	if (entry->isHashed)
+	{
+		const std::size_t slotCount = Document::getSlotCount(entry->size);
+		const Document::Slot* slots = reinterpret_cast<const Document::Slot*>(members) - slotCount;
+
+		for (std::size_t slot = hash & (slotCount - 1); slots[slot].member != emptySlot; slot = (slot + 1) & (slotCount - 1))
+		{
+			const Document::Member& member = members[slots[slot].member - 1];
+			if (slots[slot].hash == hash && (compareAddress ? member.key.data() == name.data() : member.key == name))
+			{
+				return &member;
+			}
+		}
+		return nullptr;
+	}
+
+	for (std::size_t i = 0; i < entry->size; i++)
+	{
+		if (compareAddress ? members[i].key.data() == name.data() : members[i].key == name)
+		{
+			return &members[i];
+		}
+	}
+	return nullptr;
+}
+
+Json::Element Json::Element::operator[](const unsigned int index) const
+{
+	if (entry->type == Node::Type::List)
+	{
+		if (index < entry->size)
+		{
+			return Element(&entry->elements[index]);
+		}
+		else
+		{
+			throw Exception("List type JSON element indexed out of range (index: " + std::to_string(index) + ", size: " + std::to_string(entry->size) + ")");
+		}
+	}
+	else throw Exception("Requested vector-like indexing on " + getTypeAsString() + " type JSON element");
+}
+
+Json::Element Json::Element::operator[](const char* key) const
+{
+	return at(std::string_view(key));
+}
+
+Json::Element::operator bool() const
+{
+	if (entry->type == Node::Type::Boolean)
+	{
+		return entry->boolean;
+	}
+	else throw Exception("Cannot convert " + getTypeAsString() + " element to bool");
+}
+
+/**
+ * Converts a number element to int
+ *
+ * @throws an exception if the element is not a number, or if its value
+ * does not fit into an int
+ */
+Json::Element::operator int() const
+{
+	if (entry->type != Node::Type::Number)
+	{
+		throw Exception("Cannot convert " + getTypeAsString() + " element to int");
+	}
+	if (!entry->isInteger)
+	{
+		int result;
+		if (!Number::truncate(entry->number, result))
+			throw Exception("Number " + toString() + " does not fit into an int");
+		return result;
+	}
+
+	std::int64_t value = *this;
+	if (value < std::numeric_limits<int>::min() || std::numeric_limits<int>::max() < value)
+	{
+		throw Exception("Integer " + toString() + " does not fit into an int");
+	}
+	return (int)value;
+}
+
+/**
+ * Converts a number element to a 64-bit signed integer, the fraction of
+ * a double is truncated
+ *
+ * @throws an exception if the element is not a number, or if its value
+ * does not fit into an std::int64_t
+ */
+Json::Element::operator std::int64_t() const
+{
+	if (entry->type == Node::Type::Number)
+	{
+		if (!entry->isInteger)
+		{
+			std::int64_t result;
+			if (!Number::truncate(entry->number, result))
+				throw Exception("Number " + toString() + " does not fit into an std::int64_t");
+			return result;
+		}
+		if (!entry->isUnsigned)
+			return entry->integer;
+		throw Exception("Integer " + toString() + " does not fit into an std::int64_t");
+	}
+	else throw Exception("Cannot convert " + getTypeAsString() + " element to std::int64_t");
+}
+
+/**
+ * Converts a number element to a 64-bit unsigned integer, the fraction
+ * of a double is truncated
+ *
+ * @throws an exception if the element is not a number, or if its value
+ * is negative or does not fit into an std::uint64_t
+ */
+Json::Element::operator std::uint64_t() const
+{
+	if (entry->type == Node::Type::Number)
+	{
+		if (!entry->isInteger)
+		{
+			std::uint64_t result;
+			if (!Number::truncate(entry->number, result))
+				throw Exception("Number " + toString() + " does not fit into an std::uint64_t");
+			return result;
+		}
+		if (entry->isUnsigned)
+			return entry->unsignedInteger;
+		if (entry->integer >= 0)
+			return (std::uint64_t)entry->integer;
+		throw Exception("Integer " + toString() + " does not fit into an std::uint64_t");
+	}
+	else throw Exception("Cannot convert " + getTypeAsString() + " element to std::uint64_t");
+}
+
+Json::Element::operator double() const
+{
+	if (entry->type == Node::Type::Number)
+	{
+		if (!entry->isInteger)
+			return entry->number;
+		return entry->isUnsigned ? (double)entry->unsignedInteger : (double)entry->integer;
+	}
+	else throw Exception("Cannot convert " + getTypeAsString() + " element to double");
+}
+
+Json::Element::operator std::string() const
+{
+	return std::string(std::string_view(*this));
+}
+
+Json::Element::operator std::string_view() const
+{
+	if (entry->type == Node::Type::String)
+	{
+		return std::string_view(entry->string, entry->size);
+	}
+	else throw Exception("Cannot convert " + getTypeAsString() + " element to std::string");
+}
+
+Json::Node::Type Json::Element::getType() const noexcept
+{
+	return entry->type;
+}
+
+std::string Json::Element::getTypeAsString() const noexcept
+{
+	switch (entry->type)
+	{
+		case Node::Type::Boolean:
+			return "Boolean";
+		case Node::Type::Number:
+			if (!entry->isInteger)
+				return "Number (double)";
+			return entry->isUnsigned ? "Number (uint64)" : "Number (int64)";
+		case Node::Type::Null:
+			return "Null";
+		case Node::Type::String:
+			return "String";
+		case Node::Type::List:
+			return "List";
+		case Node::Type::Object:
+			return "Object";
+		case Node::Type::Root:
+			return "Root";
+		default:
+			return "Undefined";
+	}
+}
+
+/**
+ * Returns the element as indented JSON text
+ *
+ * @param indentation the nesting level the text is indented from
+ */
+std::string Json::Element::toString(unsigned indentation) const
+{
+	std::string output;
+	Writer writer(output, Writer::Style::Pretty);
+	writer.setIndentation(indentation);
+	writer.write(*this);
+	writer.flush();
+	return output;
+}
+
+Json::DocumentBuilder::DocumentBuilder(Document& document) : document(document)
+{
+}
+
+void Json::DocumentBuilder::onObjectOpen()
+{
+	openContainer(Node::Type::Object);
+}
+
+/**
+ * Copies the members of the object into the arena, preceded by an index
+ * of their hashes if the object is large and hashed storage is selected
+ */
+void Json::DocumentBuilder::onObjectClose()
+{
+	const Container container = hierarchy.back();
+	hierarchy.pop_back();
+
+	const std::size_t count = members.size() - container.firstChild;
+	const bool isHashed = document.objectStorage == Document::ObjectStorage::Hashed && count > hashedObjectThreshold;
+	const std::size_t slotCount = isHashed ? Document::getSlotCount(count) : 0;
+
+	void* memory = document.arena.allocate(slotCount * sizeof(Document::Slot) + count * sizeof(Document::Member), alignof(Document::Member));
+	Document::Slot* slots = static_cast<Document::Slot*>(memory);
+	Document::Member* children = reinterpret_cast<Document::Member*>(slots + slotCount);
+
+	std::copy(members.begin() + container.firstChild, members.end(), children);
+
+	if (isHashed)
+	{
+		std::fill(slots, slots + slotCount, Document::Slot{ 0, emptySlot });
+		for (std::size_t i = 0; i < count; i++)
+		{
+			const std::uint32_t hash = memberHashes[container.firstChild + i];
+			std::size_t slot = hash & (slotCount - 1);
+			while (slots[slot].member != emptySlot)
+			{
+				slot = (slot + 1) & (slotCount - 1);
+			}
+			slots[slot] = { hash, std::uint32_t(i + 1) };
+		}
+	}
+
+	members.resize(container.firstChild);
+	memberHashes.resize(container.firstChild);
+
+	Document::Entry entry = Document::Entry();
+	entry.type = Node::Type::Object;
+	entry.isHashed = isHashed;
+	entry.members = children;
+	entry.size = count;
+
+	lastKey = container.key;
+	addEntry(entry);
+}
+
+void Json::DocumentBuilder::onListOpen()
+{
+	openContainer(Node::Type::List);
+}
+
+void Json::DocumentBuilder::onListClose()
+{
+	const Container container = hierarchy.back();
+	hierarchy.pop_back();
+
+	const std::size_t count = elements.size() - container.firstChild;
+	Document::Entry* children = document.arena.allocateArray<Document::Entry>(count);
+	std::copy(elements.begin() + container.firstChild, elements.end(), children);
+	elements.resize(container.firstChild);
+
+	Document::Entry entry = Document::Entry();
+	entry.type = Node::Type::List;
+	entry.elements = children;
+	entry.size = count;
+
+	lastKey = container.key;
+	addEntry(entry);
+}
+
+void Json::DocumentBuilder::onKey(std::string_view key)
+{
+	lastKey = document.keys.intern(key, document.arena);
+}
+
+void Json::DocumentBuilder::onValue(bool value)
+{
+	Document::Entry entry = Document::Entry();
+	entry.type = Node::Type::Boolean;
+	entry.boolean = value;
+	addEntry(entry);
+}
+
+void Json::DocumentBuilder::onValue(std::int64_t value)
+{
+	Document::Entry entry = Document::Entry();
+	entry.type = Node::Type::Number;
+	entry.isInteger = true;
+	entry.integer = value;
+	addEntry(entry);
+}
+
+void Json::DocumentBuilder::onValue(std::uint64_t value)
+{
+	Document::Entry entry = Document::Entry();
+	entry.type = Node::Type::Number;
+	entry.isInteger = true;
+	entry.isUnsigned = true;
+	entry.unsignedInteger = value;
+	addEntry(entry);
+}
+
+void Json::DocumentBuilder::onValue(double value)
+{
+	Document::Entry entry = Document::Entry();
+	entry.type = Node::Type::Number;
+	entry.number = value;
+	addEntry(entry);
+}
+
+void Json::DocumentBuilder::onValue(std::string_view value)
+{
+	const std::string_view copy = document.arena.copyString(value);
+
+	Document::Entry entry = Document::Entry();
+	entry.type = Node::Type::String;
+	entry.string = copy.data();
+	entry.size = copy.size();
+	addEntry(entry);
+}
+
+void Json::DocumentBuilder::onValue(std::nullptr_t)
+{
+	Document::Entry entry = Document::Entry();
+	entry.type = Node::Type::Null;
+	addEntry(entry);
+}
+
+/**
+ * Remembers the key the container belongs to, because the keys of its
+ * own members replace the last key until the container is closed
+ */
+void Json::DocumentBuilder::openContainer(Node::Type type)
+{
+	const std::size_t firstChild = (type == Node::Type::List) ? elements.size() : members.size();
+	hierarchy.push_back({ type, firstChild, lastKey });
+}
+
+void Json::DocumentBuilder::addEntry(const Document::Entry& entry)
+{
+	if (hierarchy.empty())
+	{
+		Document::Entry* root = document.arena.allocateArray<Document::Entry>(1);
+		*root = entry;
+		document.root = root;
+	}
+	else if (hierarchy.back().type == Node::Type::List)
+	{
+		elements.push_back(entry);
+	}
+	else
+	{
+		members.push_back({ lastKey.getName(), entry });
+		memberHashes.push_back(lastKey.getHash());
+	}
+}
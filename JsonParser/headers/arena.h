@@ -0,0 +1,48 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace Json
+{
+	/**
+	 * A bump allocator that hands out memory from large blocks and frees
+	 * all of it at once when it is destroyed
+	 *
+	 * Objects placed in the arena are never destructed, so it may only
+	 * hold trivially destructible types.
+	 */
+	class Arena
+	{
+	private:
+		std::vector<std::unique_ptr<char[]>> blocks;
+		char* current;
+		std::size_t remaining;
+		std::size_t nextBlockSize;
+		std::size_t allocatedBytes;
+
+		void addBlock(std::size_t minimumSize);
+
+	public:
+		Arena(std::size_t initialBlockSize = 4096);
+		Arena(Arena&& other) noexcept;
+		Arena& operator=(Arena&& other) noexcept;
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		void* allocate(std::size_t size, std::size_t alignment);
+		std::string_view copyString(std::string_view string);
+		std::size_t getAllocatedBytes() const noexcept;
+
+		template <typename T>
+		T* allocateArray(std::size_t count)
+		{
+			return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+		}
+	};
+}
+
+#endif
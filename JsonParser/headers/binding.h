@@ -0,0 +1,302 @@
+#ifndef JSON_BINDING_H
+#define JSON_BINDING_H
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include <exception>
+
+namespace Json
+{
+	/**
+	 * Maps a JSON key to a data member, created with Json::field()
+	 */
+	template <typename Class, typename T>
+	struct Field
+	{
+		using Type = T;
+
+		std::string_view name;
+		T Class::* member;
+	};
+
+	template <typename Class, typename T>
+	constexpr Field<Class, T> field(std::string_view name, T Class::* member) noexcept
+	{
+		return Field<Class, T>{ name, member };
+	}
+
+	/**
+	 * Describes how a user type is read from a JSON object
+	 *
+	 * Specialize it with a tuple of fields for every type that should be
+	 * deserialized:
+	 *
+	 *   template <>
+	 *   struct Json::Binding<Image>
+	 *   {
+	 *       static constexpr auto fields = std::make_tuple(
+	 *           Json::field("Width", &Image::Width),
+	 *           Json::field("IDs", &Image::IDs));
+	 *   };
+	 */
+	template <typename T>
+	struct Binding;
+
+	/**
+	 * Deserializes the tokens accepted by the parser straight into a user
+	 * type, without building a tree of nodes
+	 *
+	 * Supported members are bool, integers, floating point numbers,
+	 * std::string, std::vector, std::optional, std::map with string keys
+	 * and types with a Json::Binding. Unknown keys are skipped, and
+	 * members whose key is missing keep their value.
+	 */
+	class Binder
+	{
+	public:
+		template <typename T>
+		explicit Binder(T& value);
+
+		void onObjectOpen();
+		void onObjectClose();
+		void onListOpen();
+		void onListClose();
+		void onKey(std::string_view key);
+		void onValue(bool value);
+		void onValue(std::int64_t value);
+		void onValue(std::uint64_t value);
+		void onValue(double value);
+		void onValue(std::string_view value);
+		void onValue(std::nullptr_t value);
+
+	private:
+		class Exception : public std::exception
+		{
+		private:
+			std::string whatBuffer;
+
+		public:
+			Exception(std::string description)
+			{
+				std::ostringstream oss;
+				oss << "[JSON Binding Error] " << description;
+				whatBuffer = oss.str();
+			}
+			const char* what() const noexcept override
+			{
+				return whatBuffer.c_str();
+			}
+		};
+
+		struct TargetType;
+
+		/**
+		 * A value to be filled, a null type means that the value is skipped
+		 */
+		struct Target
+		{
+			void* object;
+			const TargetType* type;
+		};
+
+		/**
+		 * The operations of a bound type, a null function means that the
+		 * type cannot be read from that kind of JSON value
+		 */
+		struct TargetType
+		{
+			const char* name;
+			void (*setBoolean)(void* object, bool value);
+			void (*setInteger)(void* object, std::int64_t value);
+			void (*setUnsigned)(void* object, std::uint64_t value);
+			void (*setDouble)(void* object, double value);
+			void (*setString)(void* object, std::string_view value);
+			void (*setNull)(void* object);
+			Target (*unwrap)(void* object);
+			void (*clear)(void* object);
+			Target (*getMember)(void* object, std::string_view key);
+			Target (*appendElement)(void* object);
+		};
+
+		struct Frame
+		{
+			Target container;
+			Target next;
+		};
+
+		template <typename T>
+		struct IsVector : std::false_type {};
+
+		template <typename T>
+		struct IsVector<std::vector<T>> : std::true_type {};
+
+		template <typename T>
+		struct IsOptional : std::false_type {};
+
+		template <typename T>
+		struct IsOptional<std::optional<T>> : std::true_type {};
+
+		template <typename T>
+		struct IsStringMap : std::false_type {};
+
+		template <typename T, typename Compare>
+		struct IsStringMap<std::map<std::string, T, Compare>> : std::true_type {};
+
+		template <typename T>
+		static const TargetType& typeOf() noexcept;
+
+		template <typename T>
+		static constexpr TargetType makeType() noexcept;
+
+		template <typename T>
+		static bool fitsInto(std::int64_t value) noexcept;
+
+		template <typename T>
+		static bool fitsInto(std::uint64_t value) noexcept;
+
+		Target nextTarget();
+		void openContainer(bool isObject);
+		void closeContainer();
+		static Target unwrap(Target target);
+		[[noreturn]] static void throwMismatch(const Target& target, const char* kind);
+
+		Target root;
+		std::vector<Frame> frames;
+		std::size_t skipDepth;
+	};
+
+	/**
+	 * @param value the object that receives the parsed document
+	 */
+	template <typename T>
+	Binder::Binder(T& value)
+	{
+		root = Target{ &value, &typeOf<T>() };
+		skipDepth = 0;
+	}
+
+	template <typename T>
+	const Binder::TargetType& Binder::typeOf() noexcept
+	{
+		static constexpr TargetType type = makeType<T>();
+		return type;
+	}
+
+	template <typename T>
+	bool Binder::fitsInto(std::int64_t value) noexcept
+	{
+		if constexpr (std::is_signed_v<T>)
+			return std::numeric_limits<T>::min() <= value && value <= std::numeric_limits<T>::max();
+		else
+			return value >= 0 && (std::uint64_t)value <= std::numeric_limits<T>::max();
+	}
+
+	template <typename T>
+	bool Binder::fitsInto(std::uint64_t value) noexcept
+	{
+		return value <= (std::uint64_t)std::numeric_limits<T>::max();
+	}
+
+	/**
+	 * Builds the table of operations of a type at compile time
+	 */
+	template <typename T>
+	constexpr Binder::TargetType Binder::makeType() noexcept
+	{
+		TargetType type = TargetType();
+
+		if constexpr (std::is_same_v<T, bool>)
+		{
+			type.name = "a boolean";
+			type.setBoolean = [](void* object, bool value) { *static_cast<T*>(object) = value; };
+		}
+		else if constexpr (std::is_integral_v<T>)
+		{
+			type.name = "an integer";
+			type.setInteger = [](void* object, std::int64_t value)
+			{
+				if (!fitsInto<T>(value))
+					throw Exception("Integer " + std::to_string(value) + " does not fit into the member");
+				*static_cast<T*>(object) = (T)value;
+			};
+			type.setUnsigned = [](void* object, std::uint64_t value)
+			{
+				if (!fitsInto<T>(value))
+					throw Exception("Integer " + std::to_string(value) + " does not fit into the member");
+				*static_cast<T*>(object) = (T)value;
+			};
+		}
+		else if constexpr (std::is_floating_point_v<T>)
+		{
+			type.name = "a number";
+			type.setInteger = [](void* object, std::int64_t value) { *static_cast<T*>(object) = (T)value; };
+			type.setUnsigned = [](void* object, std::uint64_t value) { *static_cast<T*>(object) = (T)value; };
+			type.setDouble = [](void* object, double value) { *static_cast<T*>(object) = (T)value; };
+		}
+		else if constexpr (std::is_same_v<T, std::string>)
+		{
+			type.name = "a string";
+			type.setString = [](void* object, std::string_view value) { static_cast<T*>(object)->assign(value); };
+		}
+		else if constexpr (IsOptional<T>::value)
+		{
+			type.name = "an optional value";
+			type.setNull = [](void* object) { static_cast<T*>(object)->reset(); };
+			type.unwrap = [](void* object)
+			{
+				T& optional = *static_cast<T*>(object);
+				if (!optional.has_value())
+					optional.emplace();
+				return Target{ &*optional, &typeOf<typename T::value_type>() };
+			};
+		}
+		else if constexpr (IsVector<T>::value)
+		{
+			static_assert(!std::is_same_v<typename T::value_type, bool>, "std::vector<bool> cannot be bound, its elements are not addressable");
+
+			type.name = "a list";
+			type.clear = [](void* object) { static_cast<T*>(object)->clear(); };
+			type.appendElement = [](void* object)
+			{
+				T& list = *static_cast<T*>(object);
+				list.emplace_back();
+				return Target{ &list.back(), &typeOf<typename T::value_type>() };
+			};
+		}
+		else if constexpr (IsStringMap<T>::value)
+		{
+			type.name = "an object";
+			type.clear = [](void* object) { static_cast<T*>(object)->clear(); };
+			type.getMember = [](void* object, std::string_view key)
+			{
+				T& map = *static_cast<T*>(object);
+				return Target{ &map[std::string(key)], &typeOf<typename T::mapped_type>() };
+			};
+		}
+		else
+		{
+			type.name = "an object";
+			type.getMember = [](void* object, std::string_view key)
+			{
+				Target member = Target();
+				std::apply([object, key, &member](const auto&... fields)
+				{
+					((fields.name == key && (member = Target{ &(static_cast<T*>(object)->*fields.member), &typeOf<typename std::decay_t<decltype(fields)>::Type>() }, true)) || ...);
+				}, Binding<T>::fields);
+				return member;
+			};
+		}
+
+		return type;
+	}
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef JSON_CHARACTER_CLASS_H
+#define JSON_CHARACTER_CLASS_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace Json
+{
+	/**
+	 * The classes of characters the tokenizer tells apart, as bit flags of
+	 * a 256-entry table, so classifying a character is one lookup
+	 */
+	namespace CharacterClass
+	{
+		constexpr std::uint8_t WhiteSpace = 1 << 0;    // space, \t, \n, \r
+		constexpr std::uint8_t Structural = 1 << 1;    // { } [ ] : ,
+		constexpr std::uint8_t Delimiter = 1 << 2;     // can end a scalar: whitespace , ] }
+		constexpr std::uint8_t StringSpecial = 1 << 3; // ends a run of plain string characters: " \ and control characters
+		constexpr std::uint8_t NumberStart = 1 << 4;   // - 0-9
+
+		constexpr std::array<std::uint8_t, 256> makeTable() noexcept
+		{
+			std::array<std::uint8_t, 256> table = {};
+
+			for (unsigned char c : { ' ', '\t', '\n', '\r' })
+				table[c] |= WhiteSpace | Delimiter;
+			for (unsigned char c : { '{', '}', '[', ']', ':', ',' })
+				table[c] |= Structural;
+			for (unsigned char c : { ',', ']', '}' })
+				table[c] |= Delimiter;
+			for (unsigned c = 0; c < 0x20; c++)
+				table[c] |= StringSpecial;
+			table[std::size_t('"')] |= StringSpecial;
+			table[std::size_t('\\')] |= StringSpecial;
+			for (unsigned char c = '0'; c <= '9'; c++)
+				table[c] |= NumberStart;
+			table[std::size_t('-')] |= NumberStart;
+
+			return table;
+		}
+
+		inline constexpr std::array<std::uint8_t, 256> table = makeTable();
+
+		inline bool is(char c, std::uint8_t characterClass) noexcept
+		{
+			return (table[static_cast<unsigned char>(c)] & characterClass) != 0;
+		}
+
+		/**
+		 * Returns the first character at or after the pointer that is not
+		 * whitespace
+		 *
+		 * Runs of spaces, such as the indentation of pretty printed JSON,
+		 * are skipped eight bytes at a time.
+		 */
+		inline const char* skipWhiteSpace(const char* p, const char* end) noexcept
+		{
+			constexpr std::uint64_t spaces = 0x2020202020202020;
+
+			while (end - p >= 8)
+			{
+				std::uint64_t word;
+				std::memcpy(&word, p, 8);
+				if (word != spaces)
+					break;
+				p += 8;
+			}
+
+			while (p != end && is(*p, WhiteSpace))
+				p++;
+			return p;
+		}
+
+		/**
+		 * Returns the first quote, backslash or control character at or
+		 * after the pointer, or the end
+		 *
+		 * Eight bytes are checked at a time with integer arithmetic, so
+		 * the scan is fast without vector instructions too. Only the words
+		 * that hold such a character are looked at byte by byte.
+		 */
+		inline const char* findStringSpecial(const char* p, const char* end) noexcept
+		{
+			constexpr std::uint64_t ones = 0x0101010101010101;
+			constexpr std::uint64_t highBits = 0x8080808080808080;
+
+			while (end - p >= 8)
+			{
+				std::uint64_t word;
+				std::memcpy(&word, p, 8);
+
+				const std::uint64_t quotes = word ^ (ones * '"');
+				const std::uint64_t backslashes = word ^ (ones * '\\');
+				const std::uint64_t found = ((quotes - ones) & ~quotes) | ((backslashes - ones) & ~backslashes) | ((word - ones * 0x20) & ~word);
+
+				if ((found & highBits) != 0)
+					break;
+				p += 8;
+			}
+
+			while (p != end && !is(*p, StringSpecial))
+				p++;
+			return p;
+		}
+	}
+}
+
+#endif
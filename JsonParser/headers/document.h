@@ -0,0 +1,242 @@
+#ifndef JSON_DOCUMENT_H
+#define JSON_DOCUMENT_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <vector>
+#include <exception>
+#include "arena.h"
+#include "node.h"
+
+namespace Json
+{
+	class Element;
+	class DocumentBuilder;
+	class KeyTable;
+
+	/**
+	 * An object key interned by a Json::Document
+	 *
+	 * Every distinct key of a document is stored once, so keys obtained
+	 * from Document::intern() are compared by their address, and carry
+	 * their precomputed hash.
+	 */
+	class Key
+	{
+		friend class KeyTable;
+
+	public:
+		Key() noexcept;
+
+		std::string_view getName() const noexcept;
+		std::uint32_t getHash() const noexcept;
+		bool isValid() const noexcept;
+
+		static std::uint32_t hash(std::string_view name) noexcept;
+
+	private:
+		Key(std::string_view name, std::uint32_t hash) noexcept;
+
+		std::string_view name;
+		std::uint32_t hashValue;
+	};
+
+	/**
+	 * An open addressing hash set of the keys of a document
+	 */
+	class KeyTable
+	{
+	private:
+		std::vector<Key> slots;
+		std::size_t count;
+
+		std::size_t findSlot(std::string_view name, std::uint32_t hash) const noexcept;
+		void grow();
+
+	public:
+		KeyTable();
+
+		Key intern(std::string_view name, Arena& arena);
+		Key find(std::string_view name) const noexcept;
+		std::size_t getSize() const noexcept;
+	};
+
+	/**
+	 * A parsed JSON document whose values, strings and containers are all
+	 * allocated in a single arena
+	 *
+	 * Everything is freed at once when the document is destroyed. The
+	 * values are reached through Element handles, which do not own
+	 * anything and must not outlive the document.
+	 */
+	class Document
+	{
+		friend class Element;
+		friend class DocumentBuilder;
+
+	public:
+		/**
+		 * How the members of the objects are stored
+		 *
+		 * Flat objects are arrays of members searched linearly, which is the
+		 * fastest for small objects. Hashed objects with more than a handful
+		 * of members get an open addressing index in front of their members.
+		 */
+		enum class ObjectStorage
+		{
+			Flat,
+			Hashed
+		};
+
+		Document(ObjectStorage objectStorage = ObjectStorage::Hashed);
+
+		Element getRoot() const noexcept;
+		Key intern(std::string_view key) const noexcept;
+		std::size_t getAllocatedBytes() const noexcept;
+
+	private:
+		struct Member;
+
+		struct Slot
+		{
+			std::uint32_t hash;
+			std::uint32_t member;
+		};
+
+		struct Entry
+		{
+			Node::Type type;
+			bool isInteger;
+			bool isUnsigned;
+			bool isHashed;
+			union
+			{
+				bool boolean;
+				std::int64_t integer;
+				std::uint64_t unsignedInteger;
+				double number;
+				const char* string;
+				const Entry* elements;
+				const Member* members;
+			};
+			std::size_t size;
+		};
+
+		struct Member
+		{
+			std::string_view key;
+			Entry value;
+		};
+
+		Arena arena;
+		KeyTable keys;
+		ObjectStorage objectStorage;
+		const Entry* root;
+
+		static std::size_t getSlotCount(std::size_t memberCount) noexcept;
+	};
+
+	/**
+	 * A non-owning handle to a value inside a Json::Document
+	 */
+	class Element
+	{
+		friend class Document;
+		friend class Path;
+		friend class Writer;
+
+	public:
+		Element operator[](const unsigned int index) const;
+		Element operator[](const char* key) const;
+		operator bool() const;
+		operator int() const;
+		operator std::int64_t() const;
+		operator std::uint64_t() const;
+		operator double() const;
+		operator std::string() const;
+		operator std::string_view() const;
+
+		Element at(unsigned index) const;
+		Element at(std::string_view key) const;
+		Element at(Key key) const;
+
+		template <typename T>
+		T getAs() const { return (*this); }
+
+		std::string getTypeAsString() const noexcept;
+		std::string toString(unsigned indentation = 0) const;
+		Node::Type getType() const noexcept;
+
+	private:
+		class Exception : public std::exception
+		{
+		private:
+			std::string whatBuffer;
+
+		public:
+			Exception(std::string description)
+			{
+				std::ostringstream oss;
+				oss << "[JSON Document Error] " << description;
+				whatBuffer = oss.str();
+			}
+			const char* what() const noexcept override
+			{
+				return whatBuffer.c_str();
+			}
+		};
+
+		Element(const Document::Entry* entry);
+
+		const Document::Entry* entry;
+
+		const Document::Member* findMember(std::string_view name, std::uint32_t hash, bool compareAddress) const noexcept;
+	};
+
+	/**
+	 * Fills a Json::Document from the tokens accepted by the parser
+	 *
+	 * The children of the open containers are collected on a stack, and
+	 * copied into the arena as one contiguous array when the container
+	 * closes.
+	 */
+	class DocumentBuilder
+	{
+	private:
+		struct Container
+		{
+			Node::Type type;
+			std::size_t firstChild;
+			Key key;
+		};
+
+		void addEntry(const Document::Entry& entry);
+		void openContainer(Node::Type type);
+
+		Document& document;
+		std::vector<Container> hierarchy;
+		std::vector<Document::Entry> elements;
+		std::vector<Document::Member> members;
+		std::vector<std::uint32_t> memberHashes;
+		Key lastKey;
+
+	public:
+		DocumentBuilder(Document& document);
+
+		void onObjectOpen();
+		void onObjectClose();
+		void onListOpen();
+		void onListClose();
+		void onKey(std::string_view key);
+		void onValue(bool value);
+		void onValue(std::int64_t value);
+		void onValue(std::uint64_t value);
+		void onValue(double value);
+		void onValue(std::string_view value);
+		void onValue(std::nullptr_t value);
+	};
+}
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef JSON_LAZY_DOCUMENT_H
+#define JSON_LAZY_DOCUMENT_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <vector>
+#include <memory>
+#include <exception>
+#include "node.h"
+#include "mapped_file.h"
+#include "structural_index.h"
+#include "number.h"
+
+namespace Json
+{
+	class LazyElement;
+
+	/**
+	 * A JSON document that is only validated and indexed up front
+	 *
+	 * The constructor builds the structural index of the input, checks the
+	 * order of the tokens and matches every opening bracket with its closing
+	 * one. Values are read only when they are accessed, and everything an
+	 * access passes over is skipped using the matched brackets. The text of
+	 * scalars is validated when it is read.
+	 */
+	class LazyDocument
+	{
+	private:
+		class Exception : public std::exception
+		{
+		private:
+			std::string whatBuffer;
+
+		public:
+			Exception(std::string description)
+			{
+				std::ostringstream oss;
+				oss << "[JSON Lazy Document Error] " << description;
+				whatBuffer = oss.str();
+			}
+			const char* what() const noexcept override
+			{
+				return whatBuffer.c_str();
+			}
+		};
+
+		std::unique_ptr<MappedFile> file;
+		const char* data;
+		std::size_t size;
+		std::unique_ptr<StructuralIndex> index;
+		std::vector<std::size_t> matches;
+
+		void buildIndex();
+
+	public:
+		LazyDocument(std::string jsonPath);
+		LazyDocument(const char* data, std::size_t size);
+
+		LazyElement getRoot() const noexcept;
+	};
+
+	/**
+	 * A handle to a value of a Json::LazyDocument, which reads the value
+	 * only when it is accessed
+	 *
+	 * The handle does not own the document, it must not outlive it.
+	 */
+	class LazyElement
+	{
+	public:
+		LazyElement(const char* data, std::size_t size, const StructuralIndex* index, const std::size_t* matches, std::size_t entry) noexcept;
+
+		LazyElement operator[](const unsigned int index) const;
+		LazyElement operator[](const char* key) const;
+		operator bool() const;
+		operator int() const;
+		operator std::int64_t() const;
+		operator std::uint64_t() const;
+		operator double() const;
+		operator std::string() const;
+
+		LazyElement at(unsigned index) const;
+		LazyElement at(std::string_view key) const;
+
+		template <typename T>
+		T getAs() const { return (*this); }
+
+		std::shared_ptr<Node> materialize() const;
+		std::string getTypeAsString() const noexcept;
+		Node::Type getType() const noexcept;
+
+	private:
+		class Exception : public std::exception
+		{
+		private:
+			std::string whatBuffer;
+
+		public:
+			Exception(std::string description)
+			{
+				std::ostringstream oss;
+				oss << "[JSON Lazy Document Error] " << description;
+				whatBuffer = oss.str();
+			}
+			const char* what() const noexcept override
+			{
+				return whatBuffer.c_str();
+			}
+		};
+
+		const char* data;
+		std::size_t size;
+		const StructuralIndex* index;
+		const std::size_t* matches;
+		std::size_t entry;
+
+		Number getNumber() const;
+		char getCharacter(std::size_t entry) const noexcept;
+		std::size_t skip(std::size_t entry) const noexcept;
+		std::string_view getText() const;
+		std::string_view getStringContent() const;
+		LazyElement withEntry(std::size_t entry) const noexcept;
+	};
+}
+
+#endif
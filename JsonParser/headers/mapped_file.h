@@ -0,0 +1,65 @@
+#ifndef JSON_MAPPED_FILE_H
+#define JSON_MAPPED_FILE_H
+
+#include <string>
+#include <sstream>
+#include <exception>
+
+namespace Json
+{
+	/**
+	 * A read-only memory mapping of a whole file
+	 *
+	 * The mapping is advised for sequential access, so the operating
+	 * system can read ahead while the tokenizer scans the bytes. Files that
+	 * cannot be mapped, such as pipes, or files of virtual file systems
+	 * that report a size of zero, are read into memory instead.
+	 */
+	class MappedFile
+	{
+	private:
+		class Exception : public std::exception
+		{
+		private:
+			std::string whatBuffer;
+
+		public:
+			Exception(std::string description)
+			{
+				std::ostringstream oss;
+				oss << "[JSON File Error] " << description;
+				whatBuffer = oss.str();
+			}
+			const char* what() const noexcept override
+			{
+				return whatBuffer.c_str();
+			}
+		};
+
+		const char* data;
+		std::size_t size;
+		bool isMapped;
+		std::string contents;
+
+#ifdef _WIN32
+		void* fileHandle;
+		void* mappingHandle;
+#else
+		int fileDescriptor;
+#endif
+
+		void close() noexcept;
+		void readContents(const std::string& fileName);
+
+	public:
+		MappedFile(std::string fileName);
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile();
+
+		const char* getData() const noexcept;
+		std::size_t getSize() const noexcept;
+	};
+}
+
+#endif
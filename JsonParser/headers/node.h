@@ -1,32 +1,43 @@
 #ifndef JSON_NODE_H
 #define JSON_NODE_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <variant>
 #include <vector>
 #include <map>
 #include <memory>
 #include <exception>
+#include "number.h"
 
 namespace Json
 {
 	class Node;
 
 	using List = std::vector<std::shared_ptr<Node>>;
-	using Object = std::map<std::string, std::shared_ptr<Node>>;
+	using Object = std::map<std::string, std::shared_ptr<Node>, std::less<>>;
 	using Value = std::variant<
 		bool,           // Boolean
 		int,            // Number
+		std::int64_t,   // Number
+		std::uint64_t,  // Number
 		double,         // Number
+		LazyNumber,     // Number, converted when it is read
 		std::nullptr_t, // Null
 		std::string,    // String
+		std::string_view, // String, referring to the input it was parsed from
 		List,           // List
 		Object          // Object
 	>;
 
 	class Node
 	{
+		friend class TreeBuilder;
+		friend class Writer;
+		friend class TapeBuilder;
+		friend class Path;
 		friend class Parser;
 
 	public:
@@ -44,15 +55,23 @@ namespace Json
 		Node();
 		Node(Value value);
 
-		std::shared_ptr<Node> operator[](const unsigned int index);
-		std::shared_ptr<Node> operator[](const char* key);
+		const std::shared_ptr<Node>& operator[](const unsigned int index) const;
+		const std::shared_ptr<Node>& operator[](const char* key) const;
 		operator bool() const;
 		operator int() const;
+		operator std::int64_t() const;
+		operator std::uint64_t() const;
 		operator double() const;
 		operator std::string() const;
+		operator std::string_view() const;
 
-		std::shared_ptr<Node> at(unsigned index);
-		std::shared_ptr<Node> at(std::string key);
+		const std::shared_ptr<Node>& at(unsigned index) const;
+		const std::shared_ptr<Node>& at(std::string_view key) const;
+
+		const List& elements() const;
+		const Object& items() const;
+		Object::const_iterator find(std::string_view key) const;
+		std::size_t size() const;
 
 		template <typename T>
 		T getAs() { return (*this); }
@@ -0,0 +1,127 @@
+#ifndef JSON_NUMBER_H
+#define JSON_NUMBER_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <exception>
+
+namespace Json
+{
+	/**
+	 * A JSON number decoded to the exact C++ type that can hold it
+	 *
+	 * Integers become std::int64_t, or std::uint64_t if they are too large
+	 * for it. Numbers with a fraction or an exponent, and integers out of
+	 * the range of both, become double.
+	 */
+	class Number
+	{
+	public:
+		enum class Type
+		{
+			Integer,
+			Unsigned,
+			Double
+		};
+
+		Number() noexcept;
+		explicit Number(std::int64_t value) noexcept;
+		explicit Number(std::uint64_t value) noexcept;
+		explicit Number(double value) noexcept;
+
+		static const char* parse(const char* begin, const char* end, Number& number) noexcept;
+		static const char* scan(const char* begin, const char* end) noexcept;
+
+		template <typename Target>
+		static bool truncate(double source, Target& target) noexcept;
+
+		Type getType() const noexcept;
+		std::int64_t getInteger() const noexcept;
+		std::uint64_t getUnsigned() const noexcept;
+		double getDouble() const noexcept;
+		bool isOutOfRange() const noexcept;
+
+	private:
+		Type type;
+		union
+		{
+			std::int64_t integer;
+			std::uint64_t unsignedInteger;
+			double floating;
+		};
+	};
+
+	/**
+	 * A JSON number kept as its original text, converted only when it
+	 * is first read
+	 *
+	 * The text is not copied, it is a view of the memory the number was
+	 * read from. Parser handlers receive views of the input, and the node
+	 * of a tree keeps the memory its number refers to alive, but a copy of
+	 * the number taken out of its node must not outlive that node.
+	 *
+	 * The converted value is cached, so converting the same number from
+	 * several threads at once is not safe.
+	 */
+	class LazyNumber
+	{
+	public:
+		explicit LazyNumber(std::string_view text) noexcept;
+
+		std::string_view getText() const noexcept;
+		const Number& getNumber() const;
+
+	private:
+		class Exception : public std::exception
+		{
+		private:
+			std::string whatBuffer;
+
+		public:
+			Exception(std::string description)
+			{
+				std::ostringstream oss;
+				oss << "[JSON Number Error] " << description;
+				whatBuffer = oss.str();
+			}
+			const char* what() const noexcept override
+			{
+				return whatBuffer.c_str();
+			}
+		};
+
+		std::string_view text;
+		mutable Number number;
+		mutable bool isConverted;
+	};
+
+	/**
+	 * Converts a double to an integer type with its fraction truncated, if
+	 * the result fits into it
+	 *
+	 * The minimum of every integer type and its maximum plus one are powers
+	 * of two (or zero), so both bounds are exact doubles. NaN fits into
+	 * none of them.
+	 *
+	 * @returns false, leaving target unchanged, if the value does not fit
+	 */
+	template <typename Target>
+	bool Number::truncate(double source, Target& target) noexcept
+	{
+		const double truncated = std::trunc(source);
+		const double lower = double(std::numeric_limits<Target>::min());
+		const double upper = 2.0 * double(std::numeric_limits<Target>::max() / 2 + 1);
+
+		if (!(lower <= truncated && truncated < upper))
+			return false;
+
+		target = Target(truncated);
+		return true;
+	}
+}
+
+#endif
@@ -1,15 +1,35 @@
 #ifndef JSON_PARSER_H
 #define JSON_PARSER_H
 
+#include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <functional>
+#include <type_traits>
+#include <utility>
 #include <fstream>
 #include <sstream>
+#include <vector>
 #include "node.h"
+#include "document.h"
+#include "tape.h"
+#include "lazy_document.h"
+#include "view_document.h"
+#include "tokenizer.h"
+#include "binding.h"
+#include "statistics.h"
 
 namespace Json
 {
+	template <typename Handler>
+	class PushParser;
+
 	class Parser
 	{
+		template <typename Handler>
+		friend class PushParser;
+
 	private:
 		class Exception : public std::exception
 		{
@@ -29,7 +49,7 @@ namespace Json
 			}
 		};
 
-		enum class State
+		enum class State : std::uint8_t
 		{
 			Start,
 			ObjectOpen,
@@ -50,25 +70,480 @@ namespace Json
 			List
 		};
 
-		std::string getFullStateAsString() const noexcept;
+		static constexpr std::size_t stateCount = std::size_t(State::Undefined) + 1;
+		static constexpr std::size_t tokenTypeCount = std::size_t(Token::Type::End) + 1;
+		static constexpr std::size_t containerCount = 4;
+
+		/**
+		 * The state after a token, indexed by the state before it, the type
+		 * of the token and the innermost container (the root, an object, a
+		 * list, or a root that may also be a scalar), or Undefined if the
+		 * token cannot follow
+		 */
+		using TransitionTable = std::array<std::array<std::array<State, containerCount>, tokenTypeCount>, stateCount>;
+
+		static constexpr TransitionTable makeTransitionTable() noexcept;
+		static const TransitionTable transitions;
+
 		std::string stateToString(State state) const noexcept;
-		bool checkPreviousState(const std::vector<State>& allowedStates) const noexcept;
-		void requirePreviousState(const std::vector<State>& allowedStates) const;
-		void addChildNode(std::shared_ptr<Node> node);
-		bool currentlyInAList() const noexcept;
-		bool currentlyInAnObject() const noexcept;
-		std::shared_ptr<Node> getParentNode() const noexcept;
-
-		std::vector<std::shared_ptr<Node>> hierarchy;
-		State lastState;
+		std::string hierarchyToString(Hierarchy hierarchy) const noexcept;
+		std::size_t getContainer() const noexcept;
+		[[noreturn]] void rejectToken(const Token& token, std::size_t offset) const;
+
+		template <typename Handler, typename = void>
+		struct AcceptsLazyNumbers : std::false_type {};
+
+		template <typename Handler>
+		struct AcceptsLazyNumbers<Handler, std::void_t<decltype(std::declval<Handler&>().onValue(std::declval<LazyNumber>()))>> : std::true_type {};
+
+		template <typename Handler>
+		void parse(Tokenizer& tokenizer, Handler& handler);
+
+		template <typename Handler>
+		void accept(const Token& token, Handler& handler, bool isNumberConverted, std::size_t offset);
+
+		void reset() noexcept;
+		std::shared_ptr<Node> parseListElements(const char* data, std::size_t size, std::size_t offset);
+
+#ifdef JSON_INSTRUMENTATION
+		template <typename Handler>
+		void parseInstrumented(Tokenizer& tokenizer, Handler& handler);
+#endif
+
+		std::vector<Hierarchy> hierarchy;
 		State state;
-		std::string lastKey;
+		bool acceptsScalarRoot;
+		ParseStatistics statistics;
 
 	public:
+		/**
+		 * Eager numbers are converted while they are parsed. Lazy numbers
+		 * keep their text and are converted when they are first read,
+		 * and are written back exactly as they were in the input.
+		 */
+		enum class NumberConversion
+		{
+			Eager,
+			Lazy
+		};
+
+		/**
+		 * Ordered reports the documents of a JSON Lines input in the order
+		 * of the lines, Unordered as soon as they are parsed
+		 */
+		enum class LineOrder
+		{
+			Ordered,
+			Unordered
+		};
+
+		using DocumentCallback = std::function<void(std::shared_ptr<Node> document)>;
+
 		Parser();
 
-		std::shared_ptr<Json::Node> parse(std::string jsonPath);
+		std::shared_ptr<Json::Node> parse(std::string jsonPath, NumberConversion numberConversion = NumberConversion::Eager);
+		std::shared_ptr<Json::Node> parse(const char* data, std::size_t size, NumberConversion numberConversion = NumberConversion::Eager);
+		std::shared_ptr<Json::Node> parseString(std::string_view json, NumberConversion numberConversion = NumberConversion::Eager);
+
+		ViewDocument parseView(std::string jsonPath, NumberConversion numberConversion = NumberConversion::Eager);
+		ViewDocument parseView(const char* data, std::size_t size, NumberConversion numberConversion = NumberConversion::Eager);
+		ViewDocument parseViewString(std::string json, NumberConversion numberConversion = NumberConversion::Eager);
+
+		Document parseDocument(std::string jsonPath, Document::ObjectStorage objectStorage = Document::ObjectStorage::Hashed);
+		Document parseDocument(const char* data, std::size_t size, Document::ObjectStorage objectStorage = Document::ObjectStorage::Hashed);
+
+		Tape parseTape(std::string jsonPath);
+		Tape parseTape(const char* data, std::size_t size);
+
+		LazyDocument parseLazy(std::string jsonPath);
+		LazyDocument parseLazy(const char* data, std::size_t size);
+
+		std::shared_ptr<Json::Node> parseParallel(std::string jsonPath, unsigned threadCount = 0);
+		std::shared_ptr<Json::Node> parseParallel(const char* data, std::size_t size, unsigned threadCount = 0);
+
+		void parseLines(std::string jsonPath, const DocumentCallback& onDocument, LineOrder order = LineOrder::Ordered, unsigned threadCount = 0);
+		void parseLines(const char* data, std::size_t size, const DocumentCallback& onDocument, LineOrder order = LineOrder::Ordered, unsigned threadCount = 0);
+
+		template <typename Handler>
+		void parse(std::string jsonPath, Handler& handler);
+
+		template <typename Handler>
+		void parse(const char* data, std::size_t size, Handler& handler);
+
+		template <typename T>
+		T parseAs(std::string jsonPath);
+
+		template <typename T>
+		T parseAs(const char* data, std::size_t size);
+
+		const ParseStatistics& getStatistics() const noexcept;
+
+	private:
+		std::shared_ptr<Node> parse(Tokenizer& tokenizer, NumberConversion numberConversion);
+		ViewDocument parse(ViewDocument document, NumberConversion numberConversion);
 	};
+
+	/**
+	 * Parses a JSON file without building any tree, reporting every
+	 * value to the handler as it is read
+	 *
+	 * The handler is called without virtual dispatch, so it only has to
+	 * provide these member functions:
+	 *
+	 *   onObjectOpen(), onObjectClose(), onListOpen(), onListClose(),
+	 *   onKey(std::string_view) and onValue() for bool, std::int64_t,
+	 *   std::uint64_t, double, std::string_view and std::nullptr_t values.
+	 *
+	 * Integers are reported as std::int64_t, and as std::uint64_t only if
+	 * they are above its range.
+	 *
+	 * The string views passed to the handler are only valid during the call.
+	 *
+	 * @param jsonPath path of the JSON file
+	 * @param handler receives the events of the document in order
+	 */
+	template <typename Handler>
+	void Parser::parse(std::string jsonPath, Handler& handler)
+	{
+		Tokenizer tokenizer = Tokenizer(jsonPath);
+		parse(tokenizer, handler);
+	}
+
+	template <typename Handler>
+	void Parser::parse(const char* data, std::size_t size, Handler& handler)
+	{
+		Tokenizer tokenizer = Tokenizer(data, size);
+		parse(tokenizer, handler);
+	}
+
+	/**
+	 * Parses a JSON file straight into a user type, without building a
+	 * tree of nodes
+	 *
+	 * The type has to be default constructible, and objects have to be
+	 * described by a specialization of Json::Binding.
+	 *
+	 * @param jsonPath path of the JSON file
+	 * @returns the deserialized value
+	 * @throws an exception if the input is not valid JSON, or does not
+	 * match the type
+	 */
+	template <typename T>
+	T Parser::parseAs(std::string jsonPath)
+	{
+		T value = T();
+		Binder binder(value);
+		parse(jsonPath, binder);
+		return value;
+	}
+
+	template <typename T>
+	T Parser::parseAs(const char* data, std::size_t size)
+	{
+		T value = T();
+		Binder binder(value);
+		parse(data, size, binder);
+		return value;
+	}
+
+	/**
+	 * Runs the grammar of the parser over the tokens, and reports every
+	 * accepted token to the handler
+	 */
+	template <typename Handler>
+	void Parser::parse(Tokenizer& tokenizer, Handler& handler)
+	{
+		if constexpr (!AcceptsLazyNumbers<Handler>::value)
+		{
+			tokenizer.setNumberConversion(true);
+		}
+
+		reset();
+
+#ifdef JSON_INSTRUMENTATION
+		parseInstrumented(tokenizer, handler);
+#else
+		while (tokenizer.hasMoreTokens())
+		{
+			const Token token = tokenizer.getToken();
+			accept(token, handler, tokenizer.isConvertingNumbers(), token.getOffset());
+		}
+#endif
+	}
+
+#ifdef JSON_INSTRUMENTATION
+	/**
+	 * Runs the token loop with one token in every sampleInterval timed, and
+	 * fills the statistics of the parse
+	 *
+	 * Reading the clock around every token would cost more than many of the
+	 * tokens themselves. Only the whole loop is timed in full, and it is
+	 * split between the stages in the proportions measured on the sampled
+	 * tokens.
+	 */
+	template <typename Handler>
+	void Parser::parseInstrumented(Tokenizer& tokenizer, Handler& handler)
+	{
+		using Clock = std::chrono::steady_clock;
+		constexpr std::uint64_t sampleInterval = 64;
+
+		statistics = ParseStatistics();
+		statistics.bytes = tokenizer.getInputSize();
+
+		const std::uint64_t allocationsBefore = ParseStatistics::getAllocationCount();
+		const std::uint64_t allocatedBytesBefore = ParseStatistics::getAllocatedBytes();
+
+		InstrumentedHandler<Handler> instrumented(handler, statistics);
+		Clock::duration tokenizeTime{};
+		Clock::duration acceptTime{};
+		const Clock::time_point loopStart = Clock::now();
+
+		while (tokenizer.hasMoreTokens())
+		{
+			if (statistics.tokens++ % sampleInterval != 0)
+			{
+				const Token token = tokenizer.getToken();
+				accept(token, instrumented, tokenizer.isConvertingNumbers(), token.getOffset());
+				continue;
+			}
+
+			const Clock::time_point tokenStart = Clock::now();
+			const Token token = tokenizer.getToken();
+			const Clock::time_point acceptStart = Clock::now();
+			instrumented.setSampling(true);
+			accept(token, instrumented, tokenizer.isConvertingNumbers(), token.getOffset());
+			instrumented.setSampling(false);
+
+			tokenizeTime += acceptStart - tokenStart;
+			acceptTime += Clock::now() - acceptStart;
+		}
+
+		const double loopSeconds = std::chrono::duration<double>(Clock::now() - loopStart).count();
+		const double loopOffset = std::chrono::duration<double>(loopStart - tokenizer.openStart).count();
+
+		const double sampledTokenize = std::chrono::duration<double>(tokenizeTime).count();
+		const double sampledBuild = instrumented.getHandlerSeconds();
+		const double sampledGrammar = std::chrono::duration<double>(acceptTime).count() - sampledBuild;
+		const double sampledSeconds = sampledTokenize + sampledGrammar + sampledBuild;
+		const double scale = sampledSeconds > 0 ? loopSeconds / sampledSeconds : 0;
+
+		const double tokenizeSeconds = sampledTokenize * scale;
+		const double grammarSeconds = sampledGrammar * scale;
+		const double buildSeconds = sampledBuild * scale;
+
+		statistics.stages.push_back({ "open", 0, tokenizer.openSeconds });
+		statistics.stages.push_back({ "tokenize", loopOffset, tokenizeSeconds });
+		statistics.stages.push_back({ "grammar", loopOffset + tokenizeSeconds, grammarSeconds });
+		statistics.stages.push_back({ "build", loopOffset + tokenizeSeconds + grammarSeconds, buildSeconds });
+
+		statistics.allocations = ParseStatistics::getAllocationCount() - allocationsBefore;
+		statistics.allocatedBytes = ParseStatistics::getAllocatedBytes() - allocatedBytesBefore;
+	}
+#endif
+
+	/**
+	 * Builds the grammar of JSON as a table of transitions
+	 *
+	 * A value may start at the root, after a colon inside an object, or
+	 * after an opening bracket or a comma inside a list. Only objects and
+	 * lists are accepted at the root, except for the documents of JSON
+	 * Lines, which may be any value.
+	 */
+	constexpr Parser::TransitionTable Parser::makeTransitionTable() noexcept
+	{
+		constexpr std::size_t root = 0;
+		constexpr std::size_t object = 1;
+		constexpr std::size_t list = 2;
+		constexpr std::size_t scalarRoot = 3;
+
+		TransitionTable table = {};
+		for (auto& tokenTypes : table)
+		{
+			for (auto& containers : tokenTypes)
+			{
+				for (State& next : containers)
+					next = State::Undefined;
+			}
+		}
+
+		auto set = [&table](State previous, Token::Type type, std::size_t container, State next)
+		{
+			table[std::size_t(previous)][std::size_t(type)][container] = next;
+		};
+
+		struct Position
+		{
+			State previous;
+			std::size_t container;
+		};
+
+		const Position valuePositions[] = {
+			{ State::Colon, object },
+			{ State::ListOpen, list },
+			{ State::Comma, list }
+		};
+		for (const Position& position : valuePositions)
+		{
+			set(position.previous, Token::Type::ObjectOpen, position.container, State::ObjectOpen);
+			set(position.previous, Token::Type::ListOpen, position.container, State::ListOpen);
+			set(position.previous, Token::Type::Null, position.container, State::Value);
+			set(position.previous, Token::Type::Boolean, position.container, State::Value);
+			set(position.previous, Token::Type::Number, position.container, State::Value);
+			set(position.previous, Token::Type::String, position.container, State::Value);
+		}
+		set(State::Start, Token::Type::ObjectOpen, root, State::ObjectOpen);
+		set(State::Start, Token::Type::ListOpen, root, State::ListOpen);
+
+		set(State::ObjectOpen, Token::Type::String, object, State::Key);
+		set(State::Comma, Token::Type::String, object, State::Key);
+		set(State::Key, Token::Type::Colon, object, State::Colon);
+
+		set(State::ObjectOpen, Token::Type::ObjectClose, object, State::ObjectClose);
+		set(State::ListOpen, Token::Type::ListClose, list, State::ListClose);
+
+		for (State previous : { State::Value, State::ObjectClose, State::ListClose })
+		{
+			set(previous, Token::Type::Comma, object, State::Comma);
+			set(previous, Token::Type::Comma, list, State::Comma);
+			set(previous, Token::Type::ObjectClose, object, State::ObjectClose);
+			set(previous, Token::Type::ListClose, list, State::ListClose);
+		}
+
+		set(State::Start, Token::Type::End, root, State::End);
+		set(State::ObjectClose, Token::Type::End, root, State::End);
+		set(State::ListClose, Token::Type::End, root, State::End);
+
+		for (Token::Type type : { Token::Type::Null, Token::Type::Boolean, Token::Type::Number, Token::Type::String })
+		{
+			set(State::Start, type, scalarRoot, State::Value);
+		}
+		set(State::Start, Token::Type::ObjectOpen, scalarRoot, State::ObjectOpen);
+		set(State::Start, Token::Type::ListOpen, scalarRoot, State::ListOpen);
+		for (State previous : { State::Start, State::Value, State::ObjectClose, State::ListClose })
+		{
+			set(previous, Token::Type::End, scalarRoot, State::End);
+		}
+
+		return table;
+	}
+
+	inline constexpr Parser::TransitionTable Parser::transitions = Parser::makeTransitionTable();
+
+	/**
+	 * Returns the index of the innermost container in the transition
+	 * table: 0 for the root, 1 for an object, 2 for a list and 3 for a
+	 * root that may be a scalar
+	 */
+	inline std::size_t Parser::getContainer() const noexcept
+	{
+		if (hierarchy.empty())
+			return acceptsScalarRoot ? 3 : 0;
+		return 1 + std::size_t(hierarchy.back());
+	}
+
+	/**
+	 * Advances the grammar by one token, and reports the token to the
+	 * handler if it is accepted
+	 *
+	 * @param token the next token of the input
+	 * @param handler receives the events of the document
+	 * @param isNumberConverted whether number tokens hold their converted
+	 * value, or only their text
+	 * @param offset byte offset of the token in the input, for the error
+	 * message
+	 * @throws an exception if the token cannot follow the previous ones
+	 */
+	template <typename Handler>
+	void Parser::accept(const Token& token, Handler& handler, bool isNumberConverted, std::size_t offset)
+	{
+		const State next = transitions[std::size_t(state)][std::size_t(token.getType())][getContainer()];
+		if (next == State::Undefined)
+		{
+			rejectToken(token, offset);
+		}
+
+		state = next;
+
+		switch (token.getType())
+		{
+			case Token::Type::ObjectOpen:
+			{
+				hierarchy.push_back(Hierarchy::Object);
+				handler.onObjectOpen();
+				break;
+			}
+			case Token::Type::ObjectClose:
+			{
+				hierarchy.pop_back();
+				handler.onObjectClose();
+				break;
+			}
+			case Token::Type::ListOpen:
+			{
+				hierarchy.push_back(Hierarchy::List);
+				handler.onListOpen();
+				break;
+			}
+			case Token::Type::ListClose:
+			{
+				hierarchy.pop_back();
+				handler.onListClose();
+				break;
+			}
+			case Token::Type::Boolean:
+			{
+				handler.onValue(token.getValue() == "true");
+				break;
+			}
+			case Token::Type::Number:
+			{
+				if constexpr (AcceptsLazyNumbers<Handler>::value)
+				{
+					if (!isNumberConverted)
+					{
+						handler.onValue(LazyNumber(token.getValue()));
+						break;
+					}
+				}
+
+				const Number& number = token.getNumber();
+				if (number.getType() == Number::Type::Integer)
+				{
+					handler.onValue(number.getInteger());
+				}
+				else if (number.getType() == Number::Type::Unsigned)
+				{
+					handler.onValue(number.getUnsigned());
+				}
+				else
+				{
+					handler.onValue(number.getDouble());
+				}
+				break;
+			}
+			case Token::Type::String:
+			{
+				if (next == State::Key)
+				{
+					handler.onKey(token.getValue());
+				}
+				else
+				{
+					handler.onValue(token.getValue());
+				}
+				break;
+			}
+			case Token::Type::Null:
+			{
+				handler.onValue(nullptr);
+				break;
+			}
+			case Token::Type::Comma:
+			case Token::Type::Colon:
+			case Token::Type::End:
+				break;
+		}
+	}
 }
 
 #endif
@@ -0,0 +1,140 @@
+#ifndef JSON_PATH_H
+#define JSON_PATH_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <vector>
+#include <optional>
+#include <type_traits>
+#include <exception>
+#include "node.h"
+#include "document.h"
+
+namespace Json
+{
+	/**
+	 * A compiled query that selects values inside a document
+	 *
+	 * Two syntaxes are accepted:
+	 *
+	 *   /users/0/age            a JSON Pointer (RFC 6901)
+	 *   $.users[*].age          a path with wildcards and filters, where
+	 *                           the steps are .name, ['name'], [index],
+	 *                           [*], .* and [?(@.field <op> literal)]
+	 *
+	 * Filters keep the elements of a list (or the values of an object)
+	 * whose field compares to the literal with ==, !=, <, <=, > or >=, or
+	 * which have the field at all if no comparison is given. Literals are
+	 * numbers, quoted strings, true, false and null.
+	 *
+	 * The expression is parsed once, with the hashes of the keys computed
+	 * up front, so a path can be evaluated against many documents without
+	 * parsing or allocating anything per step.
+	 */
+	class Path
+	{
+	public:
+		explicit Path(std::string_view expression);
+
+		const Node* find(const Node& root) const;
+		std::vector<const Node*> findAll(const Node& root) const;
+
+		std::optional<Element> find(Element root) const;
+		std::vector<Element> findAll(Element root) const;
+
+		const std::string& getExpression() const noexcept;
+
+	private:
+		class Exception : public std::exception
+		{
+		private:
+			std::string whatBuffer;
+
+		public:
+			Exception(std::string description)
+			{
+				std::ostringstream oss;
+				oss << "[JSON Path Error] " << description;
+				whatBuffer = oss.str();
+			}
+			const char* what() const noexcept override
+			{
+				return whatBuffer.c_str();
+			}
+		};
+
+		struct Name
+		{
+			std::string name;
+			std::uint32_t hash;
+		};
+
+		enum class Comparison
+		{
+			Exists,
+			Equal,
+			NotEqual,
+			Less,
+			LessOrEqual,
+			Greater,
+			GreaterOrEqual
+		};
+
+		struct Step
+		{
+			enum class Type
+			{
+				Member,
+				Index,
+				Wildcard,
+				Filter
+			};
+
+			Type type;
+			Name member;
+			bool isIndex;
+			std::size_t index;
+
+			std::vector<Name> field;
+			Comparison comparison;
+			Node::Type literalType;
+			Number number;
+			std::string string;
+			bool boolean;
+		};
+
+		std::string expression;
+		std::vector<Step> steps;
+
+		void compilePointer(std::string_view pointer);
+		void compilePath(std::string_view path);
+		std::size_t compileFilter(std::string_view path, std::size_t position, Step& step);
+		std::size_t compileLiteral(std::string_view path, std::size_t position, Step& step);
+		static Name makeName(std::string name);
+
+		template <typename Handle, typename Callback>
+		bool visit(Handle value, std::size_t step, Callback& onMatch) const;
+
+		template <typename Handle>
+		bool matches(Handle value, const Step& step) const;
+
+		template <typename T>
+		static bool compare(T left, Comparison comparison, T right) noexcept;
+
+		template <typename Handle, typename Callback>
+		static bool forEachChild(Handle value, Callback callback);
+
+		static bool getMember(const Node* node, const Name& name, const Node*& member);
+		static bool getMember(Element element, const Name& name, Element& member);
+		static bool getElement(const Node* node, std::size_t index, const Node*& element);
+		static bool getElement(Element list, std::size_t index, Element& element);
+		static std::string_view getString(const Node* node) noexcept;
+		static std::string_view getString(Element element) noexcept;
+		static Number getNumber(const Node* node);
+		static Number getNumber(Element element) noexcept;
+	};
+}
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef JSON_PUSH_PARSER_H
+#define JSON_PUSH_PARSER_H
+
+#include <string>
+#include <sstream>
+#include <exception>
+#include "parser.h"
+
+namespace Json
+{
+	/**
+	 * Parses JSON that arrives in chunks, reporting the values to a handler
+	 * as soon as they are complete
+	 *
+	 * The grammar state is kept between the calls of feed(), and a token
+	 * that is cut by the end of a chunk is completed with the next one.
+	 * Only such an incomplete token is copied, the rest of each chunk is
+	 * tokenized where it is.
+	 *
+	 * The handler has the same member functions as the ones passed to
+	 * Parser::parse().
+	 */
+	template <typename Handler>
+	class PushParser
+	{
+	public:
+		explicit PushParser(Handler& handler);
+
+		void feed(const char* data, std::size_t size);
+		void finish();
+
+	private:
+		class Exception : public std::exception
+		{
+		private:
+			std::string whatBuffer;
+
+		public:
+			Exception(std::string description)
+			{
+				std::ostringstream oss;
+				oss << "[JSON Push Parser Error] " << description;
+				whatBuffer = oss.str();
+			}
+			const char* what() const noexcept override
+			{
+				return whatBuffer.c_str();
+			}
+		};
+
+		Parser parser;
+		Handler& handler;
+		std::string pending;
+		std::size_t parsedSize;
+		bool inString;
+		bool isEscaped;
+		bool isFinished;
+
+		void tokenize(const char* data, std::size_t size, bool isLast);
+	};
+
+	template <typename Handler>
+	PushParser<Handler>::PushParser(Handler& handler) : handler(handler)
+	{
+		parsedSize = 0;
+		inString = false;
+		isEscaped = false;
+		isFinished = false;
+		parser.reset();
+	}
+
+	/**
+	 * Parses the next chunk of the input
+	 *
+	 * The chunk is only read during the call. Everything up to its last
+	 * bracket, comma or colon outside of a string is parsed right away;
+	 * the characters after it are kept until the next chunk arrives.
+	 *
+	 * @throws an exception if the input is not valid JSON
+	 */
+	template <typename Handler>
+	void PushParser<Handler>::feed(const char* data, std::size_t size)
+	{
+		if (isFinished)
+		{
+			throw Exception("Received data after finish()");
+		}
+
+		const char* end = data + size;
+		const char* firstBoundary = nullptr;
+		const char* lastBoundary = nullptr;
+
+		for (const char* p = data; p != end; p++)
+		{
+			const char c = *p;
+
+			if (inString)
+			{
+				if (isEscaped)
+					isEscaped = false;
+				else if (c == '\\')
+					isEscaped = true;
+				else if (c == '"')
+					inString = false;
+			}
+			else if (c == '"')
+			{
+				inString = true;
+			}
+			else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ',' || c == ':')
+			{
+				if (firstBoundary == nullptr)
+					firstBoundary = p + 1;
+				lastBoundary = p + 1;
+			}
+		}
+
+		if (firstBoundary == nullptr)
+		{
+			pending.append(data, size);
+			return;
+		}
+
+		if (pending.empty())
+		{
+			tokenize(data, lastBoundary - data, false);
+		}
+		else
+		{
+			pending.append(data, firstBoundary - data);
+			tokenize(pending.data(), pending.size(), false);
+			tokenize(firstBoundary, lastBoundary - firstBoundary, false);
+		}
+
+		pending.assign(lastBoundary, end);
+	}
+
+	/**
+	 * Parses the rest of the input, and checks that it ended with a
+	 * complete document
+	 *
+	 * @throws an exception if the input is not valid JSON
+	 */
+	template <typename Handler>
+	void PushParser<Handler>::finish()
+	{
+		if (isFinished)
+		{
+			throw Exception("finish() was called more than once");
+		}
+
+		isFinished = true;
+		tokenize(pending.data(), pending.size(), true);
+		pending.clear();
+	}
+
+	/**
+	 * Runs the grammar over the tokens of a piece of the input that ends
+	 * on a token boundary
+	 *
+	 * @param isLast whether the end of the piece is the end of the input
+	 */
+	template <typename Handler>
+	void PushParser<Handler>::tokenize(const char* data, std::size_t size, bool isLast)
+	{
+		Tokenizer tokenizer(data, size);
+
+		while (tokenizer.hasMoreTokens())
+		{
+			const Token token = tokenizer.getToken();
+			if (token.getType() == Token::Type::End && !isLast)
+				break;
+
+			parser.accept(token, handler, tokenizer.isConvertingNumbers(), parsedSize + token.getOffset());
+		}
+
+		parsedSize += size;
+	}
+}
+
+#endif
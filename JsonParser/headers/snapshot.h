@@ -0,0 +1,82 @@
+#ifndef JSON_SNAPSHOT_H
+#define JSON_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <sstream>
+#include <exception>
+#include "node.h"
+#include "tape.h"
+#include "mapped_file.h"
+
+namespace Json
+{
+	/**
+	 * A parsed document saved to a file in binary form, which is memory
+	 * mapped and used in place when it is loaded
+	 *
+	 * The file holds a header followed by the words and the string buffer
+	 * of a Json::Tape. The tape only refers to its values by index and
+	 * offset, so loading a snapshot does not copy or rebuild anything. The
+	 * tape is only read once, to check that its links and offsets stay
+	 * inside the file.
+	 *
+	 *   8 bytes    "JSONSNAP"
+	 *   4 bytes    format version
+	 *   4 bytes    0x01020304, written in the byte order of the machine
+	 *   8 bytes    number of words
+	 *   8 bytes    size of the string buffer in bytes
+	 *
+	 * Snapshots are meant to be read back by the machine that wrote them,
+	 * or one with the same byte order.
+	 */
+	class Snapshot
+	{
+	public:
+		explicit Snapshot(std::string fileName);
+
+		TapeElement getRoot() const noexcept;
+		std::size_t getSizeInBytes() const noexcept;
+
+		static void save(const Tape& tape, std::string fileName);
+		static void save(const Node& root, std::string fileName);
+
+	private:
+		class Exception : public std::exception
+		{
+		private:
+			std::string whatBuffer;
+
+		public:
+			Exception(std::string description)
+			{
+				std::ostringstream oss;
+				oss << "[JSON Snapshot Error] " << description;
+				whatBuffer = oss.str();
+			}
+			const char* what() const noexcept override
+			{
+				return whatBuffer.c_str();
+			}
+		};
+
+		struct Header
+		{
+			char magic[8];
+			std::uint32_t version;
+			std::uint32_t byteOrder;
+			std::uint64_t wordCount;
+			std::uint64_t stringSize;
+		};
+
+		static const std::uint32_t currentVersion = 1;
+		static const std::uint32_t byteOrderMark = 0x01020304;
+
+		MappedFile file;
+		const std::uint64_t* words;
+		std::size_t wordCount;
+		const char* strings;
+	};
+}
+
+#endif
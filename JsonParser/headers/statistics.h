@@ -0,0 +1,183 @@
+#ifndef JSON_STATISTICS_H
+#define JSON_STATISTICS_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "node.h"
+
+namespace Json
+{
+	/**
+	 * Measurements of the last parse of a Json::Parser
+	 *
+	 * They are only collected when the library is built with
+	 * JSON_INSTRUMENTATION defined. Without it the parser contains no
+	 * measuring code at all, and every counter stays zero.
+	 *
+	 * The stages are open, the time spent opening (mapping) the file, and
+	 * then tokenize, reading the tokens, grammar, checking them against the
+	 * grammar, and build, building the result in the handler. The last three
+	 * are interleaved token by token, so they are reported as totals laid
+	 * out one after the other. Together they take the measured time of the
+	 * whole token loop, split in the proportions measured on a sample of
+	 * the tokens.
+	 *
+	 * Allocations are only counted if the program sets an allocation
+	 * counter, the library does not replace the global operator new.
+	 */
+	struct ParseStatistics
+	{
+		struct Stage
+		{
+			std::string name;
+			double start;
+			double seconds;
+		};
+
+#ifdef JSON_INSTRUMENTATION
+		static constexpr bool isCollected = true;
+#else
+		static constexpr bool isCollected = false;
+#endif
+
+		std::vector<Stage> stages;
+		std::uint64_t bytes = 0;
+		std::uint64_t tokens = 0;
+		std::array<std::uint64_t, 7> nodeCounts = {};
+		std::uint64_t allocations = 0;
+		std::uint64_t allocatedBytes = 0;
+		std::size_t maxDepth = 0;
+
+		std::uint64_t getNodeCount(Node::Type type) const noexcept;
+		double getSeconds() const noexcept;
+
+		void writeChromeTrace(std::ostream& stream) const;
+
+		/**
+		 * Reports the number of allocations and allocated bytes so far
+		 */
+		using AllocationCounter = void (*)(std::uint64_t& count, std::uint64_t& bytes);
+
+		static void setAllocationCounter(AllocationCounter counter) noexcept;
+		static std::uint64_t getAllocationCount() noexcept;
+		static std::uint64_t getAllocatedBytes() noexcept;
+	};
+
+#ifdef JSON_INSTRUMENTATION
+	/**
+	 * Forwards the events of the parser to a handler, timing the handler
+	 * and counting the values it receives
+	 */
+	template <typename Handler>
+	class InstrumentedHandler
+	{
+	public:
+		InstrumentedHandler(Handler& handler, ParseStatistics& statistics) noexcept : handler(handler), statistics(statistics)
+		{
+			depth = 0;
+			isSampling = false;
+		}
+
+		void onObjectOpen()
+		{
+			open(Node::Type::Object);
+			measure([this] { handler.onObjectOpen(); });
+		}
+
+		void onObjectClose()
+		{
+			depth--;
+			measure([this] { handler.onObjectClose(); });
+		}
+
+		void onListOpen()
+		{
+			open(Node::Type::List);
+			measure([this] { handler.onListOpen(); });
+		}
+
+		void onListClose()
+		{
+			depth--;
+			measure([this] { handler.onListClose(); });
+		}
+
+		void onKey(std::string_view key)
+		{
+			measure([this, key] { handler.onKey(key); });
+		}
+
+		/**
+		 * Only accepts the value types the handler accepts, so the parser
+		 * sees the same handler interface through the wrapper
+		 */
+		template <typename T>
+		auto onValue(T value) -> decltype(std::declval<Handler&>().onValue(std::move(value)))
+		{
+			using Value = std::decay_t<T>;
+
+			if constexpr (std::is_same_v<Value, bool>)
+				statistics.nodeCounts[std::size_t(Node::Type::Boolean)]++;
+			else if constexpr (std::is_same_v<Value, std::string_view>)
+				statistics.nodeCounts[std::size_t(Node::Type::String)]++;
+			else if constexpr (std::is_same_v<Value, std::nullptr_t>)
+				statistics.nodeCounts[std::size_t(Node::Type::Null)]++;
+			else
+				statistics.nodeCounts[std::size_t(Node::Type::Number)]++;
+
+			measure([this, &value] { handler.onValue(std::move(value)); });
+		}
+
+		/**
+		 * Sets whether the events that follow are timed, only the events
+		 * of the sampled tokens are
+		 */
+		void setSampling(bool enabled) noexcept
+		{
+			isSampling = enabled;
+		}
+
+		double getHandlerSeconds() const noexcept
+		{
+			return std::chrono::duration<double>(handlerTime).count();
+		}
+
+	private:
+		Handler& handler;
+		ParseStatistics& statistics;
+		std::size_t depth;
+		bool isSampling;
+		std::chrono::steady_clock::duration handlerTime{};
+
+		void open(Node::Type type) noexcept
+		{
+			statistics.nodeCounts[std::size_t(type)]++;
+			if (++depth > statistics.maxDepth)
+				statistics.maxDepth = depth;
+		}
+
+		template <typename Event>
+		void measure(Event event)
+		{
+			if (!isSampling)
+			{
+				event();
+				return;
+			}
+
+			const auto start = std::chrono::steady_clock::now();
+			event();
+			handlerTime += std::chrono::steady_clock::now() - start;
+		}
+	};
+#endif
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef JSON_STRING_SCANNER_H
+#define JSON_STRING_SCANNER_H
+
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <exception>
+#include "structural_index.h"
+
+namespace Json
+{
+	/**
+	 * Reads the strings of a JSON text: finds their closing quote, decodes
+	 * their escape sequences and validates their UTF-8 encoding
+	 *
+	 * The quotes, backslashes and control characters are searched for 32
+	 * bytes at a time with AVX2, 16 bytes at a time with SSE2, and 8 bytes
+	 * at a time otherwise. Strings without escape sequences can be read as a
+	 * view of the input instead of a copy, and strings with only ASCII
+	 * characters are not validated any further.
+	 */
+	class StringScanner
+	{
+	public:
+		using Implementation = StructuralIndex::Implementation;
+
+		static const char* read(const char* begin, const char* end, std::string& output, const char* origin);
+		static const char* read(const char* begin, const char* end, std::string& output, const char* origin, Implementation implementation);
+		static const char* read(const char* begin, const char* end, std::string& output, std::string_view& text, const char* origin);
+		static const char* read(const char* begin, const char* end, std::string& output, std::string_view& text, const char* origin, Implementation implementation);
+
+		static bool isValidUtf8(const char* begin, const char* end) noexcept;
+		static bool isValidUtf8(const char* begin, const char* end, Implementation implementation) noexcept;
+
+	private:
+		class Exception : public std::exception
+		{
+		private:
+			std::string whatBuffer;
+
+		public:
+			Exception(std::string description)
+			{
+				std::ostringstream oss;
+				oss << "[JSON String Error] " << description;
+				whatBuffer = oss.str();
+			}
+			const char* what() const noexcept override
+			{
+				return whatBuffer.c_str();
+			}
+		};
+
+		static const char* readEscape(const char* escape, const char* end, std::string& output, const char* origin);
+		static void appendCodePoint(std::uint32_t codePoint, std::string& output);
+	};
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef JSON_STRUCTURAL_INDEX_H
+#define JSON_STRUCTURAL_INDEX_H
+
+#include <cstdint>
+#include <vector>
+
+namespace Json
+{
+	/**
+	 * The positions of every token start in a JSON text
+	 *
+	 * The input is classified 64 bytes at a time. Backslashes are used to
+	 * find the escaped quotes, the remaining quotes to mask out the string
+	 * contents. What remains are the structural characters ({}[]:,), the
+	 * opening quotes of strings and the first characters of scalars (numbers,
+	 * literals and stray characters), in the order they appear.
+	 */
+	class StructuralIndex
+	{
+	public:
+		enum class Implementation
+		{
+			Scalar,
+			Sse2,
+			Avx2
+		};
+
+		/**
+		 * The state of a scan carried from one 64 byte block to the next
+		 */
+		struct Carry
+		{
+			std::uint64_t escaped = 0;
+			std::uint64_t inString = 0;
+			std::uint64_t boundary = 1;
+		};
+
+		/**
+		 * Indexes a JSON text one window at a time while the positions are
+		 * consumed in order
+		 *
+		 * Only the positions of the current window are held, as 32-bit
+		 * offsets from its start, so the memory used does not grow with the
+		 * input.
+		 */
+		class Stream
+		{
+		public:
+			Stream(const char* data, std::size_t size);
+			Stream(const char* data, std::size_t size, Implementation implementation);
+
+			bool next(std::size_t& position);
+
+		private:
+			static constexpr std::size_t windowSize = 64 * 1024;
+
+			const char* data;
+			std::size_t size;
+			Implementation implementation;
+			Carry carry;
+			std::size_t scanned;
+			std::size_t base;
+			std::vector<std::uint32_t> offsets;
+			std::size_t cursor;
+
+			bool refill();
+		};
+
+		StructuralIndex(const char* data, std::size_t size);
+		StructuralIndex(const char* data, std::size_t size, Implementation implementation);
+
+		static Implementation getBestImplementation() noexcept;
+		static bool isAccelerated() noexcept;
+
+		std::size_t getSize() const noexcept;
+		std::size_t operator[](std::size_t index) const noexcept;
+
+	private:
+		std::vector<std::size_t> positions;
+	};
+
+	/**
+	 * Returns the next position in the input, or false once all of them
+	 * were returned
+	 */
+	inline bool StructuralIndex::Stream::next(std::size_t& position)
+	{
+		if (cursor == offsets.size() && !refill())
+			return false;
+
+		position = base + offsets[cursor++];
+		return true;
+	}
+}
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef JSON_TAPE_H
+#define JSON_TAPE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <vector>
+#include <exception>
+#include "node.h"
+
+namespace Json
+{
+	class TapeElement;
+
+	/**
+	 * A compact, read-only representation of a parsed JSON document
+	 *
+	 * Every value is stored as 64-bit words on a flat tape: the upper 8
+	 * bits hold a tag character, the lower 56 bits a payload.
+	 *
+	 *   { and [    payload is the index of the word after the matching close
+	 *   } and ]    payload is the index of the matching open
+	 *   "          payload is the offset of the string in the string buffer,
+	 *              where it is stored as a 32-bit length and the bytes
+	 *   l, u, d    followed by a word holding an std::int64_t, an
+	 *              std::uint64_t or a double
+	 *   t, f, n    true, false and null
+	 *
+	 * Object members are stored as a key string followed by the value, so a
+	 * container can be skipped by jumping to the payload of its open word.
+	 */
+	class Tape
+	{
+		friend class TapeBuilder;
+
+	public:
+		TapeElement getRoot() const noexcept;
+		std::size_t getSizeInBytes() const noexcept;
+
+		const std::vector<std::uint64_t>& getWords() const noexcept;
+		const std::vector<char>& getStrings() const noexcept;
+
+	private:
+		std::vector<std::uint64_t> words;
+		std::vector<char> strings;
+	};
+
+	/**
+	 * A handle to a value on a tape, with the accessors of Json::Node
+	 *
+	 * The handle does not own the tape, it must not outlive it.
+	 */
+	class TapeElement
+	{
+		friend class Writer;
+
+	public:
+		TapeElement(const std::uint64_t* words, std::size_t wordCount, const char* strings, std::size_t index) noexcept;
+
+		TapeElement operator[](const unsigned int index) const;
+		TapeElement operator[](const char* key) const;
+		operator bool() const;
+		operator int() const;
+		operator std::int64_t() const;
+		operator std::uint64_t() const;
+		operator double() const;
+		operator std::string() const;
+		operator std::string_view() const;
+
+		TapeElement at(unsigned index) const;
+		TapeElement at(std::string_view key) const;
+
+		template <typename T>
+		T getAs() const { return (*this); }
+
+		std::string getTypeAsString() const noexcept;
+		std::string toString(unsigned indentation = 0) const;
+		Node::Type getType() const noexcept;
+
+	private:
+		class Exception : public std::exception
+		{
+		private:
+			std::string whatBuffer;
+
+		public:
+			Exception(std::string description)
+			{
+				std::ostringstream oss;
+				oss << "[JSON Tape Error] " << description;
+				whatBuffer = oss.str();
+			}
+			const char* what() const noexcept override
+			{
+				return whatBuffer.c_str();
+			}
+		};
+
+		const std::uint64_t* words;
+		std::size_t wordCount;
+		const char* strings;
+		std::size_t index;
+
+		char getTag() const noexcept;
+		std::uint64_t getPayload() const noexcept;
+		std::size_t getNextIndex() const noexcept;
+		std::string_view getString() const noexcept;
+		TapeElement withIndex(std::size_t index) const noexcept;
+	};
+
+	/**
+	 * Writes the tokens accepted by the parser, or an existing tree of
+	 * nodes, onto a Json::Tape
+	 */
+	class TapeBuilder
+	{
+	private:
+		class Exception : public std::exception
+		{
+		private:
+			std::string whatBuffer;
+
+		public:
+			Exception(std::string description)
+			{
+				std::ostringstream oss;
+				oss << "[JSON Tape Error] " << description;
+				whatBuffer = oss.str();
+			}
+			const char* what() const noexcept override
+			{
+				return whatBuffer.c_str();
+			}
+		};
+
+		void addWord(char tag, std::uint64_t payload);
+		void addString(std::string_view string);
+		void openContainer(char tag);
+		void closeContainer(char tag);
+
+		Tape& tape;
+		std::vector<std::size_t> openings;
+
+	public:
+		TapeBuilder(Tape& tape);
+
+		void onObjectOpen();
+		void onObjectClose();
+		void onListOpen();
+		void onListClose();
+		void onKey(std::string_view key);
+		void onValue(bool value);
+		void onValue(std::int64_t value);
+		void onValue(std::uint64_t value);
+		void onValue(double value);
+		void onValue(std::string_view value);
+		void onValue(std::nullptr_t value);
+
+		void write(const Node& node);
+	};
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef JSON_THREAD_POOL_H
+#define JSON_THREAD_POOL_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace Json
+{
+	/**
+	 * A fixed set of worker threads that run submitted tasks in the order
+	 * they were submitted
+	 *
+	 * The destructor waits for every submitted task to finish.
+	 */
+	class ThreadPool
+	{
+	public:
+		explicit ThreadPool(unsigned threadCount = 0);
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		~ThreadPool();
+
+		void submit(std::function<void()> task);
+		unsigned getThreadCount() const noexcept;
+
+	private:
+		std::vector<std::thread> threads;
+		std::queue<std::function<void()>> tasks;
+		std::mutex mutex;
+		std::condition_variable available;
+		bool stopping;
+
+		void work();
+	};
+}
+
+#endif
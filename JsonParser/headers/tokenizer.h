@@ -1,11 +1,17 @@
 #ifndef TOKENIZER_H
 #define TOKENIZER_H
 
+#include <array>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <sstream>
 #include <vector>
+#include <memory>
+#include <chrono>
 #include <exception>
+#include "mapped_file.h"
+#include "number.h"
 
 namespace Json
 {
@@ -30,19 +36,29 @@ namespace Json
 		};
 
 		Type getType() const noexcept;
-		std::string getValue() const noexcept;
+		std::string_view getValue() const noexcept;
+		const Number& getNumber() const noexcept;
+		std::size_t getOffset() const noexcept;
 		std::string toString() const noexcept;
 
 	private:
 		std::string value;
+		std::string_view source;
+		Number number;
 		Type type;
+		std::size_t offset;
 	};
 
 	class Tokenizer
 	{
 	private:
 		bool checkNextNCharacters(unsigned int n, std::string expected);
+		std::string readSpan(const std::array<bool, 256>& stops, bool inclusive);
+		void readString(Token& token);
+		void readLiteral(Token& token, std::string_view literal, const char* description);
+		static bool isDelimiter(char c) noexcept;
 		void moveReader(int distance);
+		char readCharacter() noexcept;
 
 		class Exception : public std::exception
 		{
@@ -62,9 +78,15 @@ namespace Json
 			}
 		};
 
+		std::unique_ptr<MappedFile> file;
+		const char* begin;
+		const char* end;
+		const char* reader;
+		bool reachedEnd;
+		bool convertsNumbers;
+
 	public:
-		unsigned int previousReaderPosition;
-		std::fstream file;
+		std::size_t previousReaderPosition;
 
 		char getNextNonWhiteSpaceCharacter();
 		void rollBackToken();
@@ -73,9 +95,22 @@ namespace Json
 		bool hasMoreTokens() noexcept;
 		std::string readUntil(std::string characters, bool inclusive);
 		std::string readWhile(std::string characters, bool inclusive);
+		void setNumberConversion(bool enabled) noexcept;
+		bool isConvertingNumbers() const noexcept;
+		std::size_t getInputSize() const noexcept;
+
+		/**
+		 * When and for how long the input was opened, only measured with
+		 * JSON_INSTRUMENTATION defined, but always present so the layout of
+		 * the class does not depend on the flag
+		 */
+		std::chrono::steady_clock::time_point openStart;
+		double openSeconds;
 
 		Tokenizer(std::string fileName);
-		~Tokenizer();
+		Tokenizer(const char* data, std::size_t size);
+		Tokenizer(const Tokenizer&) = delete;
+		Tokenizer& operator=(const Tokenizer&) = delete;
 		std::vector<Token> tokenize();
 	};
 }
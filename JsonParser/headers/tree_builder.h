@@ -0,0 +1,61 @@
+#ifndef JSON_TREE_BUILDER_H
+#define JSON_TREE_BUILDER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <memory>
+#include "node.h"
+#include "arena.h"
+
+namespace Json
+{
+	/**
+	 * Builds a tree of shared Json::Node objects from the tokens accepted
+	 * by the parser
+	 *
+	 * When it is given the input of the parser, string values that lie in
+	 * the input are stored as views of it instead of copies, and every node
+	 * shares the ownership of the input. Keys are always copied.
+	 */
+	class TreeBuilder
+	{
+	private:
+		void addChildNode(std::shared_ptr<Node> node);
+		void openNode(std::shared_ptr<Node> node);
+		std::shared_ptr<Node> makeNode(Value value) const;
+
+		std::vector<std::shared_ptr<Node>> hierarchy;
+		std::shared_ptr<Node> root;
+		std::string lastKey;
+		const char* sourceBegin;
+		const char* sourceEnd;
+		std::shared_ptr<const void> sourceOwner;
+		std::shared_ptr<Arena> numberTexts;
+
+		bool isInSource(std::string_view value) const noexcept;
+
+	public:
+		TreeBuilder();
+		TreeBuilder(const char* sourceBegin, const char* sourceEnd, std::shared_ptr<const void> sourceOwner);
+
+		void onObjectOpen();
+		void onObjectClose();
+		void onListOpen();
+		void onListClose();
+		void onKey(std::string_view key);
+		void onValue(bool value);
+		void onValue(std::int64_t value);
+		void onValue(std::uint64_t value);
+		void onValue(double value);
+		void onValue(LazyNumber value);
+		void onValue(std::string_view value);
+		void onValue(std::nullptr_t value);
+
+		std::shared_ptr<Node> getRoot() const noexcept;
+	};
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef JSON_VIEW_DOCUMENT_H
+#define JSON_VIEW_DOCUMENT_H
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include "node.h"
+#include "mapped_file.h"
+
+namespace Json
+{
+	class Parser;
+
+	/**
+	 * A tree of nodes parsed by Parser::parseView(), together with the
+	 * input its strings refer to
+	 *
+	 * String values without escape sequences are not copied, their nodes
+	 * hold views of the input instead. The document keeps the input alive:
+	 * a mapped file or a string it was given is owned by the document, and
+	 * every node of the tree shares this ownership, so a node reached from
+	 * the root stays valid after the document and the root are destroyed.
+	 * Input that is only borrowed from the caller has to outlive every node
+	 * of the tree.
+	 *
+	 * Only the values are views: the keys of objects are copied, because
+	 * Json::Object maps std::string keys.
+	 */
+	class ViewDocument
+	{
+		friend class Parser;
+
+	public:
+		std::shared_ptr<Node> getRoot() const noexcept;
+		std::string_view getInput() const noexcept;
+
+	private:
+		struct Storage
+		{
+			std::unique_ptr<MappedFile> file;
+			std::string text;
+			std::string_view input;
+		};
+
+		ViewDocument(std::unique_ptr<MappedFile> file);
+		ViewDocument(std::string text);
+		ViewDocument(std::string_view input);
+
+		std::shared_ptr<Storage> storage;
+		std::shared_ptr<Node> root;
+	};
+}
+
+#endif
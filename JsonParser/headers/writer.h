@@ -0,0 +1,118 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <ostream>
+#include <functional>
+#include <vector>
+#include <exception>
+#include "node.h"
+
+namespace Json
+{
+	class Element;
+	class TapeElement;
+
+	/**
+	 * Serializes JSON into a stream, a string or a caller-supplied sink
+	 *
+	 * The output is collected in a buffer and handed to the destination
+	 * whenever the buffer fills up, so a document of any size can be
+	 * written without holding its text in memory. The buffer grows with the
+	 * output up to a fixed size, so writing a small value stays cheap.
+	 *
+	 * The writer has the member functions of a parser handler, so it can
+	 * also be driven by Parser::parse() to reformat a file as it is read.
+	 */
+	class Writer
+	{
+	public:
+		enum class Style
+		{
+			Compact,
+			Pretty
+		};
+
+		using Sink = std::function<void(const char* data, std::size_t size)>;
+
+		Writer(std::ostream& stream, Style style = Style::Compact);
+		Writer(std::string& output, Style style = Style::Compact);
+		Writer(Sink sink, Style style = Style::Compact);
+		Writer(const Writer&) = delete;
+		Writer& operator=(const Writer&) = delete;
+		~Writer();
+
+		void write(const Node& node);
+		void write(const Element& element);
+		void write(const TapeElement& element);
+		void flush();
+		void setIndentation(unsigned level) noexcept;
+
+		static std::string escape(std::string_view value);
+
+		void onObjectOpen();
+		void onObjectClose();
+		void onListOpen();
+		void onListClose();
+		void onKey(std::string_view key);
+		void onValue(bool value);
+		void onValue(std::int64_t value);
+		void onValue(std::uint64_t value);
+		void onValue(double value);
+		void onValue(const LazyNumber& value);
+		void onValue(std::string_view value);
+		void onValue(std::nullptr_t value);
+
+	private:
+		class Exception : public std::exception
+		{
+		private:
+			std::string whatBuffer;
+
+		public:
+			Exception(std::string description)
+			{
+				std::ostringstream oss;
+				oss << "[JSON Writer Error] " << description;
+				whatBuffer = oss.str();
+			}
+			const char* what() const noexcept override
+			{
+				return whatBuffer.c_str();
+			}
+		};
+
+		struct Container
+		{
+			char closingBracket;
+			bool isEmpty;
+		};
+
+		static constexpr std::size_t initialBufferSize = 256;
+		static constexpr std::size_t bufferSize = 1 << 16;
+
+		Sink sink;
+		Style style;
+		std::vector<char> buffer;
+		std::size_t used;
+
+		std::vector<Container> containers;
+		unsigned indentation;
+		bool afterKey;
+
+		void reserve(std::size_t size);
+		void put(char c);
+		void put(const char* data, std::size_t size);
+		void putIndentation();
+		void putString(std::string_view value);
+		void putSeparator();
+		void beginValue();
+		void openContainer(char bracket);
+		void closeContainer(char bracket);
+	};
+}
+
+#endif
@@ -0,0 +1,537 @@
+#include "headers/lazy_document.h"
+#include "headers/parser.h"
+#include "headers/string_scanner.h"
+#include <limits>
+
+namespace
+{
+	bool isScalarStart(char c) noexcept
+	{
+		switch (c)
+		{
+			case '{': case '}': case '[': case ']': case ':': case ',': case '"':
+				return false;
+			default:
+				return true;
+		}
+	}
+
+	/**
+	 * Names a value by its first character, as the parser names its tokens
+	 */
+	std::string describeValue(char c)
+	{
+		switch (c)
+		{
+			case '"':
+				return "a string";
+			case 't': case 'f':
+				return "a boolean";
+			case 'n':
+				return "null";
+			default:
+				return "a number";
+		}
+	}
+}
+
+/**
+ * Maps the given JSON file and indexes it
+ *
+ * @param jsonPath path of the JSON file
+ */
+Json::LazyDocument::LazyDocument(std::string jsonPath)
+{
+	file = std::make_unique<MappedFile>(jsonPath);
+	data = file->getData();
+	size = file->getSize();
+
+	buildIndex();
+}
+
+/**
+ * Indexes JSON text that is already in memory
+ *
+ * The text is not copied, so it has to outlive the document.
+ *
+ * @param data pointer to the first character of the JSON text
+ * @param size length of the JSON text in bytes
+ */
+Json::LazyDocument::LazyDocument(const char* data, std::size_t size) : data(data), size(size)
+{
+	buildIndex();
+}
+
+Json::LazyElement Json::LazyDocument::getRoot() const noexcept
+{
+	return LazyElement(data, size, index.get(), matches.data(), 0);
+}
+
+/**
+ * Checks the order of the tokens by looking only at their first
+ * characters, and matches the brackets of the containers
+ *
+ * Like Json::Parser, it only accepts an object or a list at the root.
+ *
+ * @throws an exception if the root is not an object or a list, the
+ * tokens are in an illegal order or the brackets are unbalanced
+ */
+void Json::LazyDocument::buildIndex()
+{
+	enum class Expect
+	{
+		Value,
+		ValueOrClose,
+		Key,
+		KeyOrClose,
+		Colon,
+		CommaOrClose,
+		Nothing
+	};
+
+	index = std::make_unique<StructuralIndex>(data, size);
+	matches.assign(index->getSize(), 0);
+
+	std::vector<std::size_t> openings;
+	Expect expect = Expect::Value;
+
+	for (std::size_t entry = 0; entry < index->getSize(); entry++)
+	{
+		const std::size_t position = (*index)[entry];
+		const char c = data[position];
+		const bool inObject = !openings.empty() && data[(*index)[openings.back()]] == '{';
+		bool valid = false;
+
+		switch (expect)
+		{
+			case Expect::Value:
+			case Expect::ValueOrClose:
+			{
+				if (c == '{' || c == '[')
+				{
+					openings.push_back(entry);
+					expect = (c == '{') ? Expect::KeyOrClose : Expect::ValueOrClose;
+					valid = true;
+				}
+				else if (openings.empty() && (c == '"' || isScalarStart(c)))
+				{
+					throw Exception("Expected an object or a list at the root, found " + describeValue(c) + " at byte " + std::to_string(position));
+				}
+				else if (c == '"' || isScalarStart(c))
+				{
+					expect = Expect::CommaOrClose;
+					valid = true;
+				}
+				else if (c == ']' && expect == Expect::ValueOrClose)
+				{
+					valid = true;
+				}
+				break;
+			}
+			case Expect::Key:
+			case Expect::KeyOrClose:
+			{
+				if (c == '"')
+				{
+					expect = Expect::Colon;
+					valid = true;
+				}
+				else if (c == '}' && expect == Expect::KeyOrClose)
+				{
+					valid = true;
+				}
+				break;
+			}
+			case Expect::Colon:
+			{
+				valid = (c == ':');
+				expect = Expect::Value;
+				break;
+			}
+			case Expect::CommaOrClose:
+			{
+				if (c == ',')
+				{
+					expect = inObject ? Expect::Key : Expect::Value;
+					valid = true;
+				}
+				else if ((c == '}' && inObject) || (c == ']' && !inObject))
+				{
+					valid = true;
+				}
+				break;
+			}
+			case Expect::Nothing:
+				break;
+		}
+
+		if (!valid)
+		{
+			throw Exception("Unexpected \"" + std::string(1, c) + "\" at byte " + std::to_string(position));
+		}
+
+		if (c == '}' || c == ']')
+		{
+			matches[openings.back()] = entry;
+			openings.pop_back();
+			expect = openings.empty() ? Expect::Nothing : Expect::CommaOrClose;
+		}
+	}
+
+	if (expect != Expect::Nothing && index->getSize() != 0)
+	{
+		throw Exception("Reached the end of the input inside an unfinished value");
+	}
+}
+
+/**
+ * Creates a handle to the value starting at an entry of a structural index
+ *
+ * @param data the JSON text
+ * @param size length of the JSON text in bytes
+ * @param index the structural index of the text
+ * @param matches the entry of the closing bracket for every opening one
+ * @param entry the index entry the value starts at
+ */
+Json::LazyElement::LazyElement(const char* data, std::size_t size, const StructuralIndex* index, const std::size_t* matches, std::size_t entry) noexcept
+	: data(data), size(size), index(index), matches(matches), entry(entry)
+{
+}
+
+Json::LazyElement Json::LazyElement::at(unsigned index) const
+{
+	return (*this)[index];
+}
+
+Json::LazyElement Json::LazyElement::at(std::string_view key) const
+{
+	if (getCharacter(entry) == '{')
+	{
+		std::size_t current = entry + 1;
+
+		while (getCharacter(current) == '"')
+		{
+			const LazyElement value = withEntry(current + 2);
+			const LazyElement name = withEntry(current);
+			const std::string_view content = name.getStringContent();
+			const bool isEscaped = content.find('\\') != std::string_view::npos;
+
+			if (isEscaped ? std::string(name) == key : content == key)
+			{
+				return value;
+			}
+
+			current = skip(current + 2);
+			if (getCharacter(current) != ',')
+				break;
+			current++;
+		}
+		throw Exception("Key \"" + std::string(key) + "\" does not exists in indexed JSON object");
+	}
+	else throw Exception("Requested map-like indexing on " + getTypeAsString() + " type JSON element");
+}
+
+Json::LazyElement Json::LazyElement::operator[](const unsigned int index) const
+{
+	if (getCharacter(entry) == '[')
+	{
+		std::size_t current = entry + 1;
+		unsigned position = 0;
+
+		while (getCharacter(current) != ']')
+		{
+			if (position == index)
+			{
+				return withEntry(current);
+			}
+
+			position++;
+			current = skip(current);
+			if (getCharacter(current) != ',')
+				break;
+			current++;
+		}
+		throw Exception("List type JSON element indexed out of range (index: " + std::to_string(index) + ", size: " + std::to_string(position) + ")");
+	}
+	else throw Exception("Requested vector-like indexing on " + getTypeAsString() + " type JSON element");
+}
+
+Json::LazyElement Json::LazyElement::operator[](const char* key) const
+{
+	return at(std::string_view(key));
+}
+
+Json::LazyElement::operator bool() const
+{
+	if (getType() == Node::Type::Boolean)
+	{
+		const std::string_view text = getText();
+		if (text == "true")
+			return true;
+		if (text == "false")
+			return false;
+		throw Exception("Misspelled Boolean value: found \"" + std::string(text) + "\"");
+	}
+	else throw Exception("Cannot convert " + getTypeAsString() + " element to bool");
+}
+
+/**
+ * Converts a number element to int
+ *
+ * @throws an exception if the element is not a number, or if its value
+ * does not fit into an int
+ */
+Json::LazyElement::operator int() const
+{
+	const Number number = getNumber();
+	if (number.getType() == Number::Type::Double)
+	{
+		int result;
+		if (!Number::truncate(number.getDouble(), result))
+			throw Exception("Number " + std::string(getText()) + " does not fit into an int");
+		return result;
+	}
+	if (number.getType() == Number::Type::Unsigned
+		|| number.getInteger() < std::numeric_limits<int>::min()
+		|| std::numeric_limits<int>::max() < number.getInteger())
+	{
+		throw Exception("Integer " + std::string(getText()) + " does not fit into an int");
+	}
+	return (int)number.getInteger();
+}
+
+/**
+ * Converts a number element to a 64-bit signed integer, the fraction of
+ * a double is truncated
+ *
+ * @throws an exception if the element is not a number, or if its value
+ * does not fit into an std::int64_t
+ */
+Json::LazyElement::operator std::int64_t() const
+{
+	const Number number = getNumber();
+	std::int64_t result;
+	switch (number.getType())
+	{
+		case Number::Type::Integer:
+			return number.getInteger();
+		case Number::Type::Double:
+			if (!Number::truncate(number.getDouble(), result))
+				throw Exception("Number " + std::string(getText()) + " does not fit into an std::int64_t");
+			return result;
+		default:
+			throw Exception("Integer " + std::string(getText()) + " does not fit into an std::int64_t");
+	}
+}
+
+/**
+ * Converts a number element to a 64-bit unsigned integer, the fraction
+ * of a double is truncated
+ *
+ * @throws an exception if the element is not a number, or if its value
+ * is negative or does not fit into an std::uint64_t
+ */
+Json::LazyElement::operator std::uint64_t() const
+{
+	const Number number = getNumber();
+	std::uint64_t result;
+	switch (number.getType())
+	{
+		case Number::Type::Unsigned:
+			return number.getUnsigned();
+		case Number::Type::Double:
+			if (!Number::truncate(number.getDouble(), result))
+				throw Exception("Number " + std::string(getText()) + " does not fit into an std::uint64_t");
+			return result;
+		default:
+			if (number.getInteger() < 0)
+				throw Exception("Integer " + std::string(getText()) + " does not fit into an std::uint64_t");
+			return (std::uint64_t)number.getInteger();
+	}
+}
+
+Json::LazyElement::operator double() const
+{
+	const Number number = getNumber();
+	switch (number.getType())
+	{
+		case Number::Type::Integer:
+			return (double)number.getInteger();
+		case Number::Type::Unsigned:
+			return (double)number.getUnsigned();
+		default:
+			return number.getDouble();
+	}
+}
+
+Json::LazyElement::operator std::string() const
+{
+	if (getType() == Node::Type::String)
+	{
+		std::string result;
+		StringScanner::read(data + (*index)[entry] + 1, data + size, result, data);
+		return result;
+	}
+	else throw Exception("Cannot convert " + getTypeAsString() + " element to std::string");
+}
+
+/**
+ * Parses the value into a tree of nodes
+ *
+ * @returns the root node of the value
+ */
+std::shared_ptr<Json::Node> Json::LazyElement::materialize() const
+{
+	switch (getType())
+	{
+		case Node::Type::Object:
+		case Node::Type::List:
+		{
+			const std::size_t begin = (*index)[entry];
+			const std::size_t end = (*index)[matches[entry]] + 1;
+			return Parser().parse(data + begin, end - begin);
+		}
+		case Node::Type::Boolean:
+			return std::make_shared<Node>(bool(*this));
+		case Node::Type::Number:
+		{
+			const Number number = getNumber();
+			if (number.getType() == Number::Type::Double)
+				return std::make_shared<Node>(number.getDouble());
+			if (number.getType() == Number::Type::Unsigned)
+				return std::make_shared<Node>(number.getUnsigned());
+			if (std::numeric_limits<int>::min() <= number.getInteger() && number.getInteger() <= std::numeric_limits<int>::max())
+				return std::make_shared<Node>((int)number.getInteger());
+			return std::make_shared<Node>(number.getInteger());
+		}
+		case Node::Type::String:
+			return std::make_shared<Node>(std::string(*this));
+		case Node::Type::Null:
+			return std::make_shared<Node>(nullptr);
+		default:
+			return std::make_shared<Node>();
+	}
+}
+
+Json::Node::Type Json::LazyElement::getType() const noexcept
+{
+	if (entry >= index->getSize())
+		return Node::Type::Root;
+
+	switch (getCharacter(entry))
+	{
+		case '{':
+			return Node::Type::Object;
+		case '[':
+			return Node::Type::List;
+		case '"':
+			return Node::Type::String;
+		case 't':
+		case 'f':
+			return Node::Type::Boolean;
+		case 'n':
+			return Node::Type::Null;
+		default:
+			return Node::Type::Number;
+	}
+}
+
+std::string Json::LazyElement::getTypeAsString() const noexcept
+{
+	switch (getType())
+	{
+		case Node::Type::Boolean:
+			return "Boolean";
+		case Node::Type::Number:
+			return "Number";
+		case Node::Type::Null:
+			return "Null";
+		case Node::Type::String:
+			return "String";
+		case Node::Type::List:
+			return "List";
+		case Node::Type::Object:
+			return "Object";
+		default:
+			return "Root";
+	}
+}
+
+Json::Number Json::LazyElement::getNumber() const
+{
+	if (getType() == Node::Type::Number)
+	{
+		const std::string_view text = getText();
+		Number number;
+
+		if (Number::parse(text.data(), text.data() + text.size(), number) != text.data() + text.size())
+		{
+			throw Exception("Could not convert \"" + std::string(text) + "\" to a number");
+		}
+		if (number.isOutOfRange())
+		{
+			throw Exception("Number " + std::string(text) + " is out of the range of double");
+		}
+		return number;
+	}
+	else throw Exception("Cannot convert " + getTypeAsString() + " element to a number");
+}
+
+char Json::LazyElement::getCharacter(std::size_t entry) const noexcept
+{
+	if (entry >= index->getSize())
+		return 0;
+	return data[(*index)[entry]];
+}
+
+/**
+ * Returns the entry after the value starting at the given entry,
+ * jumping over containers with the matched brackets
+ */
+std::size_t Json::LazyElement::skip(std::size_t entry) const noexcept
+{
+	const char c = getCharacter(entry);
+	if (c == '{' || c == '[')
+		return matches[entry] + 1;
+	return entry + 1;
+}
+
+/**
+ * Returns the text of a scalar, which ends where the next token starts
+ */
+std::string_view Json::LazyElement::getText() const
+{
+	const std::size_t begin = (*index)[entry];
+	std::size_t end = (entry + 1 < index->getSize()) ? (*index)[entry + 1] : size;
+
+	while (end > begin && (data[end - 1] == ' ' || data[end - 1] == '\n' || data[end - 1] == '\r' || data[end - 1] == '\t'))
+		end--;
+
+	return std::string_view(data + begin, end - begin);
+}
+
+/**
+ * Returns the characters between the quotes of a string
+ */
+std::string_view Json::LazyElement::getStringContent() const
+{
+	const std::size_t begin = (*index)[entry] + 1;
+	std::size_t end = begin;
+
+	while (end < size && data[end] != '"')
+	{
+		end += (data[end] == '\\') ? 2 : 1;
+	}
+
+	if (end >= size)
+	{
+		throw Exception("Found a string without a closing quote");
+	}
+
+	return std::string_view(data + begin, end - begin);
+}
+
+Json::LazyElement Json::LazyElement::withEntry(std::size_t entry) const noexcept
+{
+	return LazyElement(data, size, index, matches, entry);
+}
@@ -31,9 +31,8 @@ int main(int argc, char* argv[])
 	std::cout << thirdID << std::endl; // 234
 
 
-	// Iterate through the elements of a list:
-	auto IDs = json->at("Image")->at("IDs")->getAs<Json::List>();
-	for (auto element : IDs)
+	// Iterate through the elements of a list (without copying the list):
+	for (const auto& element : json->at("Image")->at("IDs")->elements())
 	{
 		int currentID = element->getAs<int>();
 
@@ -41,10 +40,9 @@ int main(int argc, char* argv[])
 	}
 
 
-	// Iterate through the children nodes of an object:
-	auto thumbnail = json->at("Image")->at("Thumbnail")->getAs<Json::Object>();
-	for (auto node : thumbnail)
+	// Iterate through the children nodes of an object (without copying the object):
+	for (const auto& [key, node] : json->at("Image")->at("Thumbnail")->items())
 	{
-		/* ... */
+		std::cout << key << ": " << node->getTypeAsString() << std::endl;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include <cerrno>
+#include "headers/mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Maps the given file into memory for reading
+ *
+ * Empty files are not mapped, they are represented by an empty range.
+ * Files that are not regular files, or report a size of zero, are read
+ * into memory instead, since their size is not known up front.
+ *
+ * @param fileName path of the file to map
+ * @throws an exception if the file cannot be opened or mapped
+ */
+Json::MappedFile::MappedFile(std::string fileName)
+{
+	data = "";
+	size = 0;
+	isMapped = false;
+
+#ifdef _WIN32
+	mappingHandle = nullptr;
+	fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		throw Exception("Failed to open JSON file: \"" + fileName + "\"");
+	}
+
+	LARGE_INTEGER fileSize;
+	if (GetFileType(fileHandle) != FILE_TYPE_DISK || !GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		readContents(fileName);
+		return;
+	}
+
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	const void* view = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+	if (view == nullptr)
+	{
+		close();
+		throw Exception("Failed to map JSON file: \"" + fileName + "\"");
+	}
+
+	data = static_cast<const char*>(view);
+	size = static_cast<std::size_t>(fileSize.QuadPart);
+	isMapped = true;
+#else
+	fileDescriptor = open(fileName.c_str(), O_RDONLY);
+
+	if (fileDescriptor < 0)
+	{
+		throw Exception("Failed to open JSON file: \"" + fileName + "\"");
+	}
+
+	struct stat status;
+	if (fstat(fileDescriptor, &status) != 0)
+	{
+		close();
+		throw Exception("Failed to query the size of JSON file: \"" + fileName + "\"");
+	}
+
+	if (!S_ISREG(status.st_mode) || status.st_size == 0)
+	{
+		readContents(fileName);
+		return;
+	}
+
+	void* view = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+	if (view == MAP_FAILED)
+	{
+		close();
+		throw Exception("Failed to map JSON file: \"" + fileName + "\"");
+	}
+
+	posix_madvise(view, static_cast<std::size_t>(status.st_size), POSIX_MADV_SEQUENTIAL);
+
+	data = static_cast<const char*>(view);
+	size = static_cast<std::size_t>(status.st_size);
+	isMapped = true;
+#endif
+}
+
+Json::MappedFile::~MappedFile()
+{
+	close();
+}
+
+void Json::MappedFile::close() noexcept
+{
+#ifdef _WIN32
+	if (isMapped)
+		UnmapViewOfFile(data);
+	if (mappingHandle != nullptr)
+		CloseHandle(mappingHandle);
+	if (fileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(fileHandle);
+
+	mappingHandle = nullptr;
+	fileHandle = INVALID_HANDLE_VALUE;
+#else
+	if (isMapped)
+		munmap(const_cast<char*>(data), size);
+	if (fileDescriptor >= 0)
+		::close(fileDescriptor);
+
+	fileDescriptor = -1;
+#endif
+
+	data = "";
+	size = 0;
+	isMapped = false;
+}
+
+/**
+ * Reads the rest of the open file into memory and closes it, for the
+ * files that cannot be mapped
+ *
+ * The file is read through the handle that is already open, so the data
+ * of a pipe is not lost by opening it again.
+ */
+void Json::MappedFile::readContents(const std::string& fileName)
+{
+	char buffer[1 << 16];
+
+#ifdef _WIN32
+	for (;;)
+	{
+		DWORD count = 0;
+		if (!ReadFile(fileHandle, buffer, sizeof(buffer), &count, nullptr))
+		{
+			if (GetLastError() == ERROR_BROKEN_PIPE)
+				break;
+
+			close();
+			throw Exception("Failed to read JSON file: \"" + fileName + "\"");
+		}
+		if (count == 0)
+			break;
+		contents.append(buffer, count);
+	}
+#else
+	for (;;)
+	{
+		const ssize_t count = ::read(fileDescriptor, buffer, sizeof(buffer));
+		if (count < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			close();
+			throw Exception("Failed to read JSON file: \"" + fileName + "\"");
+		}
+		if (count == 0)
+			break;
+		contents.append(buffer, static_cast<std::size_t>(count));
+	}
+#endif
+
+	close();
+	data = contents.data();
+	size = contents.size();
+}
+
+const char* Json::MappedFile::getData() const noexcept
+{
+	return data;
+}
+
+std::size_t Json::MappedFile::getSize() const noexcept
+{
+	return size;
+}
@@ -1,46 +1,132 @@
 #include <stdexcept>
+#include <limits>
+#include <type_traits>
+#include <utility>
 #include "headers/node.h"
+#include "headers/writer.h"
+
+namespace
+{
+	/**
+	 * Converts an integer to another integer type, if its value fits into it
+	 */
+	template <typename Target, typename Source>
+	bool convertInteger(Source source, Target& target) noexcept
+	{
+		if constexpr (std::is_signed_v<Source> == std::is_signed_v<Target>)
+		{
+			if (source < std::numeric_limits<Target>::min() || source > std::numeric_limits<Target>::max())
+				return false;
+		}
+		else if constexpr (std::is_signed_v<Source>)
+		{
+			if (source < 0 || std::make_unsigned_t<Source>(source) > std::numeric_limits<Target>::max())
+				return false;
+		}
+		else
+		{
+			if (source > std::make_unsigned_t<Target>(std::numeric_limits<Target>::max()))
+				return false;
+		}
+
+		target = Target(source);
+		return true;
+	}
+
+	template <typename Target>
+	bool convertNumber(const Json::Number& number, Target& target) noexcept
+	{
+		switch (number.getType())
+		{
+			case Json::Number::Type::Integer:
+				return convertInteger(number.getInteger(), target);
+			case Json::Number::Type::Unsigned:
+				return convertInteger(number.getUnsigned(), target);
+			default:
+				return Json::Number::truncate(number.getDouble(), target);
+		}
+	}
+
+	/**
+	 * Converts the number alternative of a value to an integer type, lazy
+	 * numbers are converted from their cached Number
+	 *
+	 * @returns false if the value does not fit into the type
+	 */
+	template <typename Target>
+	bool convertNumber(const Json::Value& value, Target& target)
+	{
+		if (std::holds_alternative<Json::LazyNumber>(value))
+			return convertNumber(std::get<Json::LazyNumber>(value).getNumber(), target);
+		if (std::holds_alternative<int>(value))
+			return convertInteger(std::get<int>(value), target);
+		if (std::holds_alternative<std::int64_t>(value))
+			return convertInteger(std::get<std::int64_t>(value), target);
+		if (std::holds_alternative<std::uint64_t>(value))
+			return convertInteger(std::get<std::uint64_t>(value), target);
+		return Json::Number::truncate(std::get<double>(value), target);
+	}
+}
 
 Json::Node::Node()
 {
 	type = Json::Node::Type::Root;
 }
 
-Json::Node::Node(Value value) : value(value)
+Json::Node::Node(Value value) : value(std::move(value))
 {
 	type = Type::Root;
 
-	if (std::holds_alternative<bool>(value))
+	if (std::holds_alternative<bool>(this->value))
 		type = Type::Boolean;
-	if (std::holds_alternative<int>(value))
+	if (std::holds_alternative<int>(this->value))
 		type = Type::Number;
-	if (std::holds_alternative<double>(value))
+	if (std::holds_alternative<std::int64_t>(this->value))
 		type = Type::Number;
-	if (std::holds_alternative<std::nullptr_t>(value))
+	if (std::holds_alternative<std::uint64_t>(this->value))
+		type = Type::Number;
+	if (std::holds_alternative<double>(this->value))
+		type = Type::Number;
+	if (std::holds_alternative<LazyNumber>(this->value))
+		type = Type::Number;
+	if (std::holds_alternative<std::nullptr_t>(this->value))
 		type = Type::Null;
-	if (std::holds_alternative<std::string>(value))
+	if (std::holds_alternative<std::string>(this->value) || std::holds_alternative<std::string_view>(this->value))
 		type = Type::String;
-	if (std::holds_alternative<List>(value))
+	if (std::holds_alternative<List>(this->value))
 		type = Type::List;
-	if (std::holds_alternative<Object>(value))
+	if (std::holds_alternative<Object>(this->value))
 		type = Type::Object;
 }
 
-std::shared_ptr<Json::Node> Json::Node::at(unsigned index)
+const std::shared_ptr<Json::Node>& Json::Node::at(unsigned index) const
 {
 	return (*this)[index];
 }
 
-std::shared_ptr<Json::Node> Json::Node::at(std::string key)
+const std::shared_ptr<Json::Node>& Json::Node::at(std::string_view key) const
 {
-	return (*this)[key.c_str()];
+	if (std::holds_alternative<Object>(value))
+	{
+		const Object& map = std::get<Object>(value);
+		auto pos = map.find(key);
+		if (pos != map.end())
+		{
+			return pos->second;
+		}
+		else
+		{
+			throw Exception("Key \"" + std::string(key) + "\" does not exists in indexed JSON object");
+		}
+	}
+	else throw Exception("Requested map-like indexing on " + getTypeAsString() + " type JSON node");
 }
 
-std::shared_ptr<Json::Node> Json::Node::operator[](const unsigned int index)
+const std::shared_ptr<Json::Node>& Json::Node::operator[](const unsigned int index) const
 {
 	if (std::holds_alternative<List>(value))
 	{
-		auto list = std::get<List>(value);
+		const List& list = std::get<List>(value);
 		if (index < list.size())
 		{
 			return list[index];
@@ -53,22 +139,62 @@ std::shared_ptr<Json::Node> Json::Node::operator[](const unsigned int index)
 	else throw Exception("Requested vector-like indexing on " + getTypeAsString() + " type JSON node");
 }
 
-std::shared_ptr<Json::Node> Json::Node::operator[](const char* key)
+const std::shared_ptr<Json::Node>& Json::Node::operator[](const char* key) const
+{
+	return at(std::string_view(key));
+}
+
+/**
+ * Returns the elements of a list node without copying them
+ *
+ * @returns a reference to the elements, valid as long as the node is
+ * @throws an exception if the node is not a list
+ */
+const Json::List& Json::Node::elements() const
+{
+	if (std::holds_alternative<List>(value))
+	{
+		return std::get<List>(value);
+	}
+	else throw Exception("Requested the elements of " + getTypeAsString() + " type JSON node");
+}
+
+/**
+ * Returns the key-node pairs of an object node without copying them
+ *
+ * @returns a reference to the members, valid as long as the node is
+ * @throws an exception if the node is not an object
+ */
+const Json::Object& Json::Node::items() const
 {
 	if (std::holds_alternative<Object>(value))
 	{
-		auto map = std::get<Object>(value);
-		auto pos = map.find(key);
-		if (pos != map.end())
-		{
-			return pos->second;
-		}
-		else
-		{
-			throw Exception("Key \"" + std::string(key) + "\" does not exists in indexed JSON object");
-		}
+		return std::get<Object>(value);
 	}
-	else throw Exception("Requested map-like indexing on " + getTypeAsString() + " type JSON node");
+	else throw Exception("Requested the items of " + getTypeAsString() + " type JSON node");
+}
+
+/**
+ * Looks up a key of an object node without allocating a key string
+ *
+ * @returns an iterator to the member, or items().end() if the key is missing
+ * @throws an exception if the node is not an object
+ */
+Json::Object::const_iterator Json::Node::find(std::string_view key) const
+{
+	return items().find(key);
+}
+
+/**
+ * Returns the number of elements of a list or members of an object
+ */
+std::size_t Json::Node::size() const
+{
+	if (std::holds_alternative<List>(value))
+		return std::get<List>(value).size();
+	if (std::holds_alternative<Object>(value))
+		return std::get<Object>(value).size();
+	throw Exception("Requested the size of " + getTypeAsString() + " type JSON node");
 }
 
 Json::Node::operator bool() const
@@ -80,21 +206,82 @@ Json::Node::operator bool() const
 	else throw Exception("Cannot convert " + getTypeAsString() + " node to bool");
 }
 
+/**
+ * Converts a number node to int, the fraction of a double is truncated
+ *
+ * @throws an exception if the node is not a number, or if its value does
+ * not fit into an int
+ */
 Json::Node::operator int() const
 {
-	if (std::holds_alternative<int>(value))
+	if (type != Type::Number)
 	{
-		return std::get<int>(value);
+		throw Exception("Cannot convert " + getTypeAsString() + " node to int");
 	}
-	else if (std::holds_alternative<double>(value))
+
+	int result;
+	if (!convertNumber(value, result))
 	{
-		return (int)std::get<double>(value);
+		throw Exception("Number " + toString() + " does not fit into an int");
 	}
-	else throw Exception("Cannot convert " + getTypeAsString() + " node to int");
+	return result;
+}
+
+/**
+ * Converts a number node to a 64-bit signed integer, the fraction of a
+ * double is truncated
+ *
+ * @throws an exception if the node is not a number, or if its value does
+ * not fit into an std::int64_t
+ */
+Json::Node::operator std::int64_t() const
+{
+	if (type != Type::Number)
+	{
+		throw Exception("Cannot convert " + getTypeAsString() + " node to std::int64_t");
+	}
+
+	std::int64_t result;
+	if (!convertNumber(value, result))
+	{
+		throw Exception("Number " + toString() + " does not fit into an std::int64_t");
+	}
+	return result;
+}
+
+/**
+ * Converts a number node to a 64-bit unsigned integer, the fraction of a
+ * double is truncated
+ *
+ * @throws an exception if the node is not a number, or if its value is
+ * negative or does not fit into an std::uint64_t
+ */
+Json::Node::operator std::uint64_t() const
+{
+	if (type != Type::Number)
+	{
+		throw Exception("Cannot convert " + getTypeAsString() + " node to std::uint64_t");
+	}
+
+	std::uint64_t result;
+	if (!convertNumber(value, result))
+	{
+		throw Exception("Number " + toString() + " does not fit into an std::uint64_t");
+	}
+	return result;
 }
 
 Json::Node::operator double() const
 {
+	if (std::holds_alternative<LazyNumber>(value))
+	{
+		const Number& number = std::get<LazyNumber>(value).getNumber();
+		if (number.getType() == Number::Type::Integer)
+			return (double)number.getInteger();
+		if (number.getType() == Number::Type::Unsigned)
+			return (double)number.getUnsigned();
+		return number.getDouble();
+	}
 	if (std::holds_alternative<double>(value))
 	{
 		return std::get<double>(value);
@@ -103,6 +290,14 @@ Json::Node::operator double() const
 	{
 		return (double)std::get<int>(value);
 	}
+	else if (std::holds_alternative<std::int64_t>(value))
+	{
+		return (double)std::get<std::int64_t>(value);
+	}
+	else if (std::holds_alternative<std::uint64_t>(value))
+	{
+		return (double)std::get<std::uint64_t>(value);
+	}
 	else throw Exception("Cannot convert " + getTypeAsString() + " node to double");
 }
 
@@ -112,9 +307,33 @@ Json::Node::operator std::string() const
 	{
 		return std::get<std::string>(value);
 	}
+	else if (std::holds_alternative<std::string_view>(value))
+	{
+		return std::string(std::get<std::string_view>(value));
+	}
 	else throw Exception("Cannot convert " + getTypeAsString() + " node to std::string");
 }
 
+/**
+ * Returns the characters of a string node without copying them
+ *
+ * @returns a view valid as long as the node is, and for strings parsed by
+ * Parser::parseView() as long as their Json::ViewDocument is
+ * @throws an exception if the node is not a string
+ */
+Json::Node::operator std::string_view() const
+{
+	if (std::holds_alternative<std::string>(value))
+	{
+		return std::get<std::string>(value);
+	}
+	else if (std::holds_alternative<std::string_view>(value))
+	{
+		return std::get<std::string_view>(value);
+	}
+	else throw Exception("Cannot convert " + getTypeAsString() + " node to std::string_view");
+}
+
 Json::Node::operator Json::List() const
 {
 	if (std::holds_alternative<List>(value))
@@ -176,12 +395,20 @@ std::string Json::Node::getTypeAsString() const noexcept
 		return "Boolean";
 	if (std::holds_alternative<int>(value))
 		return "Number (int)";
+	if (std::holds_alternative<std::int64_t>(value))
+		return "Number (int64)";
+	if (std::holds_alternative<std::uint64_t>(value))
+		return "Number (uint64)";
 	if (std::holds_alternative<double>(value))
 		return "Number (double)";
+	if (std::holds_alternative<LazyNumber>(value))
+		return "Number (lazy)";
 	if (std::holds_alternative<std::nullptr_t>(value))
 		return "Null";
 	if (std::holds_alternative<std::string>(value))
 		return "String";
+	if (std::holds_alternative<std::string_view>(value))
+		return "String (view)";
 	if (std::holds_alternative<List>(value))
 		return "List";
 	if (std::holds_alternative<Object>(value))
@@ -189,76 +416,17 @@ std::string Json::Node::getTypeAsString() const noexcept
 	return "Undefined";
 }
 
+/**
+ * Returns the node as indented JSON text
+ *
+ * @param indentation the nesting level the text is indented from
+ */
 std::string Json::Node::toString(unsigned indentation) const
 {
-	std::string tabs;
-	std::string output = "";
-
-	for (unsigned i = 0; i < indentation; i++)
-		tabs += "  ";
-
-	switch (type)
-	{
-		case Type::String:
-		{
-			output += "\"" + std::get<std::string>(value) + "\"";
-			break;
-		}
-		case Type::Number:
-		{
-			if (std::holds_alternative<double>(value))
-			{
-				output += std::to_string(std::get<double>(value));
-			}
-			else if (std::holds_alternative<int>(value))
-			{
-				output += std::to_string(std::get<int>(value));
-			}
-			break;
-		}
-		case Type::Boolean:
-		{
-			output += (std::get<bool>(value) ? "true" : "false");
-			break;
-		}
-		case Type::Null:
-		{
-			output += "null";
-			break;
-		}
-		case Type::List:
-		{
-			output += "[\n";
-			unsigned int index = 0;
-			for (auto node : std::get<List>(value))
-			{
-				output += tabs + "  " + node->toString(indentation + 1);
-				if (index < std::get<List>(value).size() - 1)
-				{
-					output += ",\n";
-				}
-				index++;
-			}
-			output += "\n" + tabs + "]";
-			break;
-		}
-		case Type::Object:
-		{
-			output += "{\n";
-			for (auto iter = std::get<Object>(value).begin(); iter != std::get<Object>(value).end(); iter++)
-			{
-				output += tabs + "  " + "\"" + iter->first + "\": ";
-				output += iter->second->toString(indentation + 1);
-				auto next = iter;
-				if ((++next) != std::get<Object>(value).end())
-				{
-					output += ",";
-				}
-				output += "\n";
-			}
-			output += tabs + "}";
-			break;
-		}
-	}
+	std::string output;
+	Writer writer(output, Writer::Style::Pretty);
+	writer.setIndentation(indentation);
+	writer.write(*this);
+	writer.flush();
 	return output;
-}
\ No newline at end of file
+}
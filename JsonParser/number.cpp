@@ -0,0 +1,352 @@
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include "headers/number.h"
+
+namespace
+{
+	const int maximumExactDigits = 19;
+
+	const double powersOfTen[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	bool isDigit(char c) noexcept
+	{
+		return '0' <= c && c <= '9';
+	}
+
+	/**
+	 * Returns whether a number that does not fit into a double is too
+	 * large for it, rather than too small
+	 *
+	 * The decimal exponent of its first significant digit is enough to
+	 * tell, the limits of double are hundreds of orders of magnitude
+	 * apart.
+	 */
+	bool isTooLarge(const char* begin, const char* end) noexcept
+	{
+		const char* p = begin;
+		if (*p == '-')
+			p++;
+
+		const char* integer = p;
+		while (p != end && isDigit(*p))
+			p++;
+
+		long magnitude = 0;
+		if (*integer != '0')
+		{
+			magnitude = long(p - integer);
+		}
+		else if (p != end && *p == '.')
+		{
+			for (const char* q = p + 1; q != end && *q == '0'; q++)
+				magnitude--;
+		}
+
+		while (p != end && *p != 'e' && *p != 'E')
+			p++;
+		if (p == end)
+			return magnitude > 0;
+
+		p++;
+		const bool negativeExponent = (*p == '-');
+		if (*p == '-' || *p == '+')
+			p++;
+
+		long exponent = 0;
+		for (; p != end && isDigit(*p); p++)
+		{
+			if (exponent < 100000)
+				exponent = exponent * 10 + (*p - '0');
+		}
+		return magnitude + (negativeExponent ? -exponent : exponent) > 0;
+	}
+}
+
+Json::Number::Number() noexcept : type(Type::Integer), integer(0)
+{
+}
+
+Json::Number::Number(std::int64_t value) noexcept : type(Type::Integer), integer(value)
+{
+}
+
+Json::Number::Number(std::uint64_t value) noexcept : type(Type::Unsigned), unsignedInteger(value)
+{
+}
+
+Json::Number::Number(double value) noexcept : type(Type::Double), floating(value)
+{
+}
+
+/**
+ * Decodes a JSON number in a single pass, independently of the locale
+ *
+ * Integers are accumulated exactly. Doubles whose digits fit in 64 bits
+ * and whose exponent is small are computed with a single multiplication
+ * or division, which is exact in that range; all others are converted
+ * with std::from_chars.
+ *
+ * Numbers too close to zero for a double decode to zero of their sign,
+ * and -0 to the double -0.0. Numbers too large for a double decode to
+ * infinity of their sign, which isOutOfRange() reports.
+ *
+ * @param begin the first character of the number
+ * @param end the end of the input
+ * @param number receives the decoded number
+ * @returns the character after the number, or nullptr if the characters
+ * do not form a valid JSON number
+ */
+const char* Json::Number::parse(const char* begin, const char* end, Number& number) noexcept
+{
+	const char* p = begin;
+	const bool negative = (p != end && *p == '-');
+	if (negative)
+		p++;
+
+	if (p == end || !isDigit(*p))
+		return nullptr;
+
+	std::uint64_t mantissa = 0;
+	int digitCount = 0;
+	int exponent = 0;
+	bool isExact = true;
+	bool isInteger = true;
+
+	if (*p == '0')
+	{
+		p++;
+		if (p != end && isDigit(*p))
+			return nullptr;
+	}
+	else
+	{
+		for (; p != end && isDigit(*p); p++)
+		{
+			if (digitCount < maximumExactDigits)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				digitCount++;
+			}
+			else
+			{
+				isExact = false;
+			}
+		}
+	}
+
+	if (p != end && *p == '.')
+	{
+		isInteger = false;
+		p++;
+		if (p == end || !isDigit(*p))
+			return nullptr;
+
+		for (; p != end && isDigit(*p); p++)
+		{
+			if (digitCount < maximumExactDigits)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				digitCount++;
+				exponent--;
+			}
+			else
+			{
+				isExact = false;
+			}
+		}
+	}
+
+	if (p != end && (*p == 'e' || *p == 'E'))
+	{
+		isInteger = false;
+		p++;
+		const bool negativeExponent = (p != end && *p == '-');
+		if (p != end && (*p == '-' || *p == '+'))
+			p++;
+		if (p == end || !isDigit(*p))
+			return nullptr;
+
+		int explicitExponent = 0;
+		for (; p != end && isDigit(*p); p++)
+		{
+			if (explicitExponent < 100000)
+				explicitExponent = explicitExponent * 10 + (*p - '0');
+		}
+		exponent += negativeExponent ? -explicitExponent : explicitExponent;
+	}
+
+	if (isInteger)
+	{
+		std::uint64_t value = mantissa;
+		bool fits = isExact;
+
+		if (!isExact)
+		{
+			const char* digits = begin + (negative ? 1 : 0);
+			fits = std::from_chars(digits, p, value).ec == std::errc();
+		}
+
+		if (fits && !negative && value <= std::uint64_t(std::numeric_limits<std::int64_t>::max()))
+		{
+			number.type = Type::Integer;
+			number.integer = std::int64_t(value);
+			return p;
+		}
+		if (fits && !negative)
+		{
+			number.type = Type::Unsigned;
+			number.unsignedInteger = value;
+			return p;
+		}
+		if (fits && value != 0 && value <= std::uint64_t(std::numeric_limits<std::int64_t>::max()) + 1)
+		{
+			number.type = Type::Integer;
+			number.integer = std::int64_t(0 - value);
+			return p;
+		}
+	}
+
+	number.type = Type::Double;
+
+	if (isExact && mantissa <= (std::uint64_t(1) << 53) && -22 <= exponent && exponent <= 22)
+	{
+		double value = double(mantissa);
+		value = (exponent < 0) ? value / powersOfTen[-exponent] : value * powersOfTen[exponent];
+		number.floating = negative ? -value : value;
+		return p;
+	}
+
+	const std::from_chars_result result = std::from_chars(begin, p, number.floating);
+	if (result.ec == std::errc::result_out_of_range)
+	{
+		const double magnitude = isTooLarge(begin, p) ? std::numeric_limits<double>::infinity() : 0.0;
+		number.floating = negative ? -magnitude : magnitude;
+	}
+	else if (result.ec != std::errc())
+	{
+		return nullptr;
+	}
+
+	return p;
+}
+
+/**
+ * Checks the grammar of a JSON number without converting it
+ *
+ * @param begin the first character of the number
+ * @param end the end of the input
+ * @returns the character after the number, or nullptr if the characters
+ * do not form a valid JSON number
+ */
+const char* Json::Number::scan(const char* begin, const char* end) noexcept
+{
+	const char* p = begin;
+	if (p != end && *p == '-')
+		p++;
+
+	if (p == end || !isDigit(*p))
+		return nullptr;
+
+	if (*p == '0')
+	{
+		p++;
+		if (p != end && isDigit(*p))
+			return nullptr;
+	}
+	else
+	{
+		while (p != end && isDigit(*p))
+			p++;
+	}
+
+	if (p != end && *p == '.')
+	{
+		p++;
+		if (p == end || !isDigit(*p))
+			return nullptr;
+		while (p != end && isDigit(*p))
+			p++;
+	}
+
+	if (p != end && (*p == 'e' || *p == 'E'))
+	{
+		p++;
+		if (p != end && (*p == '-' || *p == '+'))
+			p++;
+		if (p == end || !isDigit(*p))
+			return nullptr;
+		while (p != end && isDigit(*p))
+			p++;
+	}
+
+	return p;
+}
+
+Json::Number::Type Json::Number::getType() const noexcept
+{
+	return type;
+}
+
+std::int64_t Json::Number::getInteger() const noexcept
+{
+	return integer;
+}
+
+std::uint64_t Json::Number::getUnsigned() const noexcept
+{
+	return unsignedInteger;
+}
+
+double Json::Number::getDouble() const noexcept
+{
+	return floating;
+}
+
+/**
+ * Returns whether the number was too large to be decoded into a double
+ */
+bool Json::Number::isOutOfRange() const noexcept
+{
+	return type == Type::Double && std::isinf(floating);
+}
+
+Json::LazyNumber::LazyNumber(std::string_view text) noexcept : text(text), isConverted(false)
+{
+}
+
+/**
+ * Returns the number exactly as it was written in the input
+ */
+std::string_view Json::LazyNumber::getText() const noexcept
+{
+	return text;
+}
+
+/**
+ * Converts the text on the first call and returns the cached number
+ * afterwards
+ *
+ * @throws an exception if the number is out of the range of double
+ */
+const Json::Number& Json::LazyNumber::getNumber() const
+{
+	if (!isConverted)
+	{
+		const char* end = text.data() + text.size();
+		if (Number::parse(text.data(), end, number) != end)
+		{
+			throw Exception("Could not convert \"" + std::string(text) + "\" to a number");
+		}
+		if (number.isOutOfRange())
+		{
+			throw Exception("Number " + std::string(text) + " is out of the range of double");
+		}
+		isConverted = true;
+	}
+	return number;
+}
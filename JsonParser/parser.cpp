@@ -3,55 +3,216 @@
  * follow the RFC4627 standard
  */
 
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <queue>
 #include "headers/parser.h"
-#include "headers/tokenizer.h"
-#include <cmath>
+#include "headers/tree_builder.h"
+#include "headers/thread_pool.h"
+
+namespace
+{
+	const std::size_t chunkSize = 1 << 20;
+
+	/**
+	 * The documents of a chunk of lines are kept until the chunk is
+	 * delivered, so the chunks are small enough for them to still be in
+	 * the cache when the callback gets them
+	 */
+	const std::size_t lineChunkSize = 1 << 16;
+
+	bool isWhiteSpace(char c) noexcept
+	{
+		return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+	}
+
+	/**
+	 * Finds the commas the elements of a list are split into ranges of
+	 * about chunkSize bytes at, by walking the structural index of the list
+	 * and keeping track of the nesting
+	 *
+	 * @param begin the first character after the opening bracket
+	 * @param end the closing bracket
+	 * @param separators receives the positions of the commas
+	 * @returns false if the quotes or brackets inside the list are not
+	 * balanced
+	 */
+	bool findRangeSeparators(const char* begin, const char* end, std::vector<const char*>& separators)
+	{
+		Json::StructuralIndex::Stream index(begin, end - begin);
+		std::size_t depth = 0;
+		std::size_t rangeBegin = 0;
+		std::size_t position;
+
+		while (index.next(position))
+		{
+			switch (begin[position])
+			{
+				case '[':
+				case '{':
+					depth++;
+					break;
+				case ']':
+				case '}':
+					if (depth == 0)
+						return false;
+					depth--;
+					break;
+				case ',':
+					if (depth == 0 && position - rangeBegin >= chunkSize)
+					{
+						separators.push_back(begin + position);
+						rangeBegin = position + 1;
+					}
+					break;
+				default:
+					break;
+			}
+		}
+
+		return depth == 0;
+	}
+
+	std::string tokenTypeToString(Json::Token::Type type)
+	{
+		switch (type)
+		{
+			case Json::Token::Type::Null:
+				return "null";
+			case Json::Token::Type::Boolean:
+				return "a boolean";
+			case Json::Token::Type::Number:
+				return "a number";
+			case Json::Token::Type::String:
+				return "a string";
+			case Json::Token::Type::ListOpen:
+				return "'['";
+			case Json::Token::Type::ListClose:
+				return "']'";
+			case Json::Token::Type::ObjectOpen:
+				return "'{'";
+			case Json::Token::Type::ObjectClose:
+				return "'}'";
+			case Json::Token::Type::Comma:
+				return "','";
+			case Json::Token::Type::Colon:
+				return "':'";
+			case Json::Token::Type::End:
+			default:
+				return "the end of the input";
+		}
+	}
+
+	bool isBlank(const char* begin, const char* end) noexcept
+	{
+		for (const char* p = begin; p != end; p++)
+		{
+			if (*p != ' ' && *p != '\t' && *p != '\r')
+				return false;
+		}
+		return true;
+	}
+}
 
 Json::Parser::Parser()
 {
 	state = State::Undefined;
-	lastState = State::Undefined;
+	acceptsScalarRoot = false;
 }
 
-bool Json::Parser::checkPreviousState(const std::vector<State>& allowedStates) const noexcept
+/**
+ * Returns the measurements of the last parse, which are only collected
+ * when the library is built with JSON_INSTRUMENTATION defined
+ */
+const Json::ParseStatistics& Json::Parser::getStatistics() const noexcept
 {
-	for (auto state : allowedStates)
-	{
-		if (lastState == state)
-			return true;
-	}
-	return false;
+	return statistics;
 }
 
-void Json::Parser::requirePreviousState(const std::vector<State>& allowedStates) const
+/**
+ * Puts the grammar back to the start of a new input
+ */
+void Json::Parser::reset() noexcept
+{
+	hierarchy.clear();
+	state = State::Start;
+}
+
+/**
+ * Parses a run of elements of a list, without the brackets around them,
+ * as if they followed a comma inside the list
+ *
+ * @param data pointer to the first character of the run
+ * @param size length of the run in bytes
+ * @param offset byte offset of the run in the whole input, for the error
+ * messages
+ * @returns a list node holding the elements
+ */
+std::shared_ptr<Json::Node> Json::Parser::parseListElements(const char* data, std::size_t size, std::size_t offset)
 {
-	if (!checkPreviousState(allowedStates))
+	Tokenizer tokenizer(data, size);
+	tokenizer.setNumberConversion(true);
+
+	TreeBuilder builder;
+	builder.onListOpen();
+	hierarchy.assign(1, Hierarchy::List);
+	state = State::Comma;
+
+	while (true)
 	{
-		throw Exception("Entered an illegal state. Parser's state:\n" + getFullStateAsString());
+		const Token token = tokenizer.getToken();
+		if (token.getType() == Token::Type::End)
+		{
+			if (state == State::Comma)
+				throw Exception("Found an empty list element at byte " + std::to_string(offset + token.getOffset()));
+			if (hierarchy.size() != 1)
+				rejectToken(token, offset + token.getOffset());
+			break;
+		}
+		accept(token, builder, true, offset + token.getOffset());
 	}
+
+	builder.onListClose();
+	return builder.getRoot();
 }
 
-std::string Json::Parser::getFullStateAsString() const noexcept
+/**
+ * Throws the exception explaining why a token cannot follow the previous
+ * ones
+ *
+ * @param token the rejected token
+ * @param offset byte offset of the token in the input
+ */
+void Json::Parser::rejectToken(const Token& token, std::size_t offset) const
 {
-	std::string result = "last: ";
-	result += stateToString(lastState);
-	result += " \tnow: ";
-	result += stateToString(state);
-	result += " \tpar: ";
-	result += getParentNode()->getTypeAsString();
-
-	result += " \ttree: [";
+	const std::string position = " at byte " + std::to_string(offset);
+	const Token::Type type = token.getType();
 
-	for (unsigned int i = 0; i < hierarchy.size(); i++)
+	if (type == Token::Type::ObjectClose || type == Token::Type::ListClose)
 	{
-		result += hierarchy[i]->getTypeAsString();
-		if (i + 1 != hierarchy.size())
-			result += " > ";
+		if (hierarchy.empty())
+			throw Exception("Found closing bracket without an opening one" + position);
+		if (type == Token::Type::ObjectClose && hierarchy.back() == Hierarchy::List)
+			throw Exception("Found wrong closing bracket (object instead of list)" + position);
+		if (type == Token::Type::ListClose && hierarchy.back() == Hierarchy::Object)
+			throw Exception("Found wrong closing bracket (list instead of object)" + position);
 	}
 
-	result += "]";
+	if (type == Token::Type::End && !hierarchy.empty())
+		throw Exception("Reached the end of the input inside an unclosed " + hierarchyToString(hierarchy.back()) + position);
 
-	return result;
+	if (state == State::Start)
+		throw Exception(std::string(acceptsScalarRoot ? "Expected a value" : "Expected an object or a list") + " at the root, found " + tokenTypeToString(type) + position);
+
+	std::string container = "at the root";
+	if (!hierarchy.empty())
+		container = hierarchy.back() == Hierarchy::Object ? "inside an object" : "inside a list";
+
+	throw Exception("Found " + tokenTypeToString(type) + " after " + stateToString(state) + " " + container + position);
 }
 
 std::string Json::Parser::stateToString(State state) const noexcept
@@ -59,217 +220,461 @@ std::string Json::Parser::stateToString(State state) const noexcept
 	switch (state)
 	{
 		case State::Value:
-			return "Value      ";
+			return "a value";
 		case State::Key:
-			return "Key        ";
+			return "a key";
 		case State::ListOpen:
-			return "ListOpen   ";
+			return "'['";
 		case State::ListClose:
-			return "ListClose  ";
+			return "']'";
 		case State::ObjectOpen:
-			return "ObjectOpen ";
+			return "'{'";
 		case State::ObjectClose:
-			return "ObjectClose";
+			return "'}'";
 		case State::Comma:
-			return "Comma      ";
+			return "','";
 		case State::Colon:
-			return "Colon      ";
+			return "':'";
 		case State::End:
-			return "End        ";
+			return "the end of the root";
 		case State::Start:
-			return "Start      ";
+			return "the start of the input";
 		case State::Undefined:
 		default:
-			return "Undefined  ";
+			return "an undefined state";
+	}
+}
+
+std::string Json::Parser::hierarchyToString(Hierarchy hierarchy) const noexcept
+{
+	switch (hierarchy)
+	{
+		case Hierarchy::Object:
+			return "object";
+		case Hierarchy::List:
+		default:
+			return "list";
 	}
 }
 
-std::shared_ptr<Json::Node> Json::Parser::parse(std::string jsonPath)
+std::shared_ptr<Json::Node> Json::Parser::parse(std::string jsonPath, NumberConversion numberConversion)
 {
 	Tokenizer tokenizer = Tokenizer(jsonPath);
-	auto tokens = tokenizer.tokenize();
+	return parse(tokenizer, numberConversion);
+}
 
-	hierarchy = { std::make_shared<Node>() };
-	lastState = State::Undefined;
-	state = State::Start;
-	auto root = std::make_shared<Node>();
+/**
+ * Parses JSON text that is already in memory
+ *
+ * @param data pointer to the first character of the JSON text
+ * @param size length of the JSON text in bytes
+ * @returns the root node of the parsed JSON structure
+ */
+std::shared_ptr<Json::Node> Json::Parser::parse(const char* data, std::size_t size, NumberConversion numberConversion)
+{
+	Tokenizer tokenizer = Tokenizer(data, size);
+	return parse(tokenizer, numberConversion);
+}
+
+std::shared_ptr<Json::Node> Json::Parser::parseString(std::string_view json, NumberConversion numberConversion)
+{
+	return parse(json.data(), json.size(), numberConversion);
+}
+
+/**
+ * Builds the node tree while pulling the tokens from the tokenizer one
+ * by one, so only the current token is held in memory at a time
+ */
+std::shared_ptr<Json::Node> Json::Parser::parse(Tokenizer& tokenizer, NumberConversion numberConversion)
+{
+	tokenizer.setNumberConversion(numberConversion == NumberConversion::Eager);
+
+	TreeBuilder builder;
+	parse(tokenizer, builder);
+	return builder.getRoot();
+}
+
+/**
+ * Parses a JSON file into a node tree whose strings without escape
+ * sequences are views of the input instead of copies
+ *
+ * The file is mapped into memory, and stays mapped as long as the
+ * document or any of its nodes is held. Keys are copied, only the values
+ * are views.
+ *
+ * @param jsonPath path of the JSON file
+ * @returns the document owning the tree and the input
+ */
+Json::ViewDocument Json::Parser::parseView(std::string jsonPath, NumberConversion numberConversion)
+{
+	return parse(ViewDocument(std::make_unique<MappedFile>(jsonPath)), numberConversion);
+}
+
+/**
+ * Parses JSON text owned by the caller into a node tree whose strings
+ * refer to it
+ *
+ * The text is not copied, it has to outlive the document and its nodes.
+ */
+Json::ViewDocument Json::Parser::parseView(const char* data, std::size_t size, NumberConversion numberConversion)
+{
+	return parse(ViewDocument(std::string_view(data, size)), numberConversion);
+}
+
+/**
+ * Parses JSON text into a node tree whose strings refer to it, taking
+ * ownership of the text
+ */
+Json::ViewDocument Json::Parser::parseViewString(std::string json, NumberConversion numberConversion)
+{
+	return parse(ViewDocument(std::move(json)), numberConversion);
+}
+
+Json::ViewDocument Json::Parser::parse(ViewDocument document, NumberConversion numberConversion)
+{
+	const std::string_view input = document.getInput();
+	Tokenizer tokenizer = Tokenizer(input.data(), input.size());
+	tokenizer.setNumberConversion(numberConversion == NumberConversion::Eager);
+
+	TreeBuilder builder(input.data(), input.data() + input.size(), document.storage);
+	parse(tokenizer, builder);
+	document.root = builder.getRoot();
+	return document;
+}
+
+/**
+ * Parses a JSON file into an arena allocated document
+ *
+ * @param jsonPath path of the JSON file
+ * @param objectStorage how the members of the objects are stored
+ * @returns the document owning every value of the file
+ */
+Json::Document Json::Parser::parseDocument(std::string jsonPath, Document::ObjectStorage objectStorage)
+{
+	Tokenizer tokenizer = Tokenizer(jsonPath);
+	Document document(objectStorage);
+	DocumentBuilder builder(document);
+	parse(tokenizer, builder);
+	return document;
+}
+
+Json::Document Json::Parser::parseDocument(const char* data, std::size_t size, Document::ObjectStorage objectStorage)
+{
+	Tokenizer tokenizer = Tokenizer(data, size);
+	Document document(objectStorage);
+	DocumentBuilder builder(document);
+	parse(tokenizer, builder);
+	return document;
+}
+
+/**
+ * Parses a JSON file into a compact, read-only tape
+ *
+ * @param jsonPath path of the JSON file
+ * @returns the tape holding every value of the file
+ */
+Json::Tape Json::Parser::parseTape(std::string jsonPath)
+{
+	Tokenizer tokenizer = Tokenizer(jsonPath);
+	Tape tape;
+	TapeBuilder builder(tape);
+	parse(tokenizer, builder);
+	return tape;
+}
+
+Json::Tape Json::Parser::parseTape(const char* data, std::size_t size)
+{
+	Tokenizer tokenizer = Tokenizer(data, size);
+	Tape tape;
+	TapeBuilder builder(tape);
+	parse(tokenizer, builder);
+	return tape;
+}
+
+/**
+ * Validates and indexes a JSON file, without reading any of its values
+ *
+ * @param jsonPath path of the JSON file
+ * @returns the document that reads its values on demand
+ */
+Json::LazyDocument Json::Parser::parseLazy(std::string jsonPath)
+{
+	return LazyDocument(jsonPath);
+}
+
+Json::LazyDocument Json::Parser::parseLazy(const char* data, std::size_t size)
+{
+	return LazyDocument(data, size);
+}
+
+/**
+ * Parses a JSON file whose root is a list, parsing its elements in
+ * parallel on every core
+ *
+ * @param jsonPath path of the JSON file
+ * @param threadCount number of worker threads, or 0 for one per core
+ * @returns the root node of the parsed JSON structure
+ */
+std::shared_ptr<Json::Node> Json::Parser::parseParallel(std::string jsonPath, unsigned threadCount)
+{
+	MappedFile file(jsonPath);
+	return parseParallel(file.getData(), file.getSize(), threadCount);
+}
+
+/**
+ * Parses JSON text whose root is a list, parsing its elements in parallel
+ *
+ * The structural index of the text is walked to split the elements of
+ * the root list into ranges of about 1 MB. Each range is parsed as one run
+ * of elements on a thread pool, and the parsed elements are put into one
+ * list node. Text whose root is not a list, or that is not larger than a
+ * single range, is parsed on the calling thread.
+ *
+ * @throws an exception with the byte offset of the range that could not
+ * be parsed
+ */
+std::shared_ptr<Json::Node> Json::Parser::parseParallel(const char* data, std::size_t size, unsigned threadCount)
+{
+	const char* begin = data;
+	const char* end = data + size;
+
+	while (begin != end && isWhiteSpace(*begin))
+		begin++;
+	while (end != begin && isWhiteSpace(*(end - 1)))
+		end--;
+
+	if (begin == end || *begin != '[' || std::size_t(end - begin) <= chunkSize)
+	{
+		return parse(data, size);
+	}
+	if (*(end - 1) != ']')
+	{
+		throw Exception("The root list is not closed at the end of the input");
+	}
 
-	for (Token token : tokens)
+	std::vector<const char*> separators;
+	if (!findRangeSeparators(begin + 1, end - 1, separators))
 	{
-		lastState = state;
+		throw Exception("Found unbalanced quotes or brackets inside the root list");
+	}
+	if (separators.empty())
+	{
+		return parse(data, size);
+	}
+
+	struct Range
+	{
+		const char* begin;
+		const char* end;
+		std::shared_ptr<Node> elements;
+		std::exception_ptr error;
+	};
+
+	// The ranges lie between the opening bracket, the separators and the
+	// closing bracket.
+	std::vector<Range> ranges;
+	ranges.reserve(separators.size() + 1);
+	const char* rangeBegin = begin + 1;
+	for (const char* separator : separators)
+	{
+		ranges.push_back({ rangeBegin, separator, nullptr, nullptr });
+		rangeBegin = separator + 1;
+	}
+	ranges.push_back({ rangeBegin, end - 1, nullptr, nullptr });
 
-		switch (token.getType())
+	std::mutex mutex;
+	std::condition_variable finished;
+	std::size_t finishedRanges = 0;
+
+	auto parseRange = [&](Range& range)
+	{
+		try
 		{
-			case Token::Type::ObjectOpen:
-			{
-				state = State::ObjectOpen;
-				requirePreviousState({ State::Start, State::Colon });
+			Parser parser;
+			range.elements = parser.parseListElements(range.begin, range.end - range.begin, range.begin - data);
+		}
+		catch (const std::exception& exception)
+		{
+			range.error = std::make_exception_ptr(Exception("Could not parse the list elements starting at byte " + std::to_string(range.begin - data) + ": " + exception.what()));
+		}
 
-				if (lastState == State::Start)
-				{
-					root = std::make_shared<Node>(Object());
-					hierarchy.push_back(root);
-				}
-				else
-				{
-					auto newNode = std::make_shared<Node>(Object());
-					addChildNode(newNode);
-					hierarchy.push_back(newNode);
-				}
-				break;
-			}
-			case Token::Type::ObjectClose:
-			{
-				state = State::ObjectClose;
-				requirePreviousState({ State::Value, State::ObjectOpen, State::ObjectClose, State::ListClose });
+		std::lock_guard<std::mutex> lock(mutex);
+		finishedRanges++;
+		finished.notify_all();
+	};
 
-				if (currentlyInAList())
-					throw Exception("Found wrong closing bracket (object instead of list)");
-				hierarchy.pop_back();
-				break;
-			}
-			case Token::Type::ListOpen:
-			{
-				state = State::ListOpen;
-				requirePreviousState({ State::Start, State::Colon });
+	{
+		ThreadPool pool(threadCount);
+		for (Range& range : ranges)
+		{
+			pool.submit([&parseRange, &range] { parseRange(range); });
+		}
 
-				if (lastState == State::Start)
-				{
-					root = std::make_shared<Node>(List());
-					hierarchy.push_back(root);
-				}
-				else
-				{
-					auto newNode = std::make_shared<Node>(List());
-					addChildNode(newNode);
-					hierarchy.push_back(newNode);
-				}
-				break;
-			}
-			case Token::Type::ListClose:
-			{
-				state = State::ListClose;
-				requirePreviousState({ State::Value, State::ListOpen, State::ListClose, State::ObjectClose });
+		std::unique_lock<std::mutex> lock(mutex);
+		finished.wait(lock, [&] { return finishedRanges == ranges.size(); });
+	}
 
-				if (currentlyInAnObject())
-					throw Exception("Found wrong closing bracket (list instead of object)");
-				hierarchy.pop_back();
-				break;
-			}
-			case Token::Type::Comma:
+	std::size_t elementCount = 0;
+	for (const Range& range : ranges)
+	{
+		if (range.error)
+			std::rethrow_exception(range.error);
+		elementCount += std::get<List>(range.elements->value).size();
+	}
+
+	List elements;
+	elements.reserve(elementCount);
+	for (Range& range : ranges)
+	{
+		List& rangeElements = std::get<List>(range.elements->value);
+		elements.insert(elements.end(), std::make_move_iterator(rangeElements.begin()), std::make_move_iterator(rangeElements.end()));
+	}
+
+	return std::make_shared<Node>(std::move(elements));
+}
+
+/**
+ * Parses a newline-delimited JSON (JSON Lines) file on every core
+ *
+ * @param jsonPath path of the file, holding one JSON value per line
+ * @param onDocument called with the parsed documents, always on the
+ * calling thread
+ * @param order whether the documents are reported in the order of the
+ * lines, or as soon as they are parsed
+ * @param threadCount number of worker threads, or 0 for one per core
+ */
+void Json::Parser::parseLines(std::string jsonPath, const DocumentCallback& onDocument, LineOrder order, unsigned threadCount)
+{
+	MappedFile file(jsonPath);
+	parseLines(file.getData(), file.getSize(), onDocument, order, threadCount);
+}
+
+/**
+ * Parses newline-delimited JSON that is already in memory
+ *
+ * The input is cut at line boundaries into chunks of about 64 KB, which
+ * are parsed on a thread pool. Only a few chunks per worker are in flight
+ * at a time, so the memory use does not grow with the size of the input.
+ * Blank lines are skipped, and every line may hold any JSON value,
+ * scalars included.
+ *
+ * @throws an exception with the byte offset of the first line that could
+ * not be parsed, after reporting every document before it (in ordered
+ * mode) or every document of the chunks finished before it (in
+ * unordered mode)
+ */
+void Json::Parser::parseLines(const char* data, std::size_t size, const DocumentCallback& onDocument, LineOrder order, unsigned threadCount)
+{
+	struct Chunk
+	{
+		const char* begin;
+		const char* end;
+		std::vector<std::shared_ptr<Node>> documents;
+		std::exception_ptr error;
+		bool isDone;
+	};
+
+	std::vector<Chunk> chunks;
+	for (const char* begin = data, *end = data + size; begin != end;)
+	{
+		const char* chunkEnd = end;
+		if (std::size_t(end - begin) > lineChunkSize)
+		{
+			const void* newline = std::memchr(begin + lineChunkSize, '\n', end - begin - lineChunkSize);
+			chunkEnd = newline ? static_cast<const char*>(newline) + 1 : end;
+		}
+		chunks.push_back({ begin, chunkEnd, {}, nullptr, false });
+		begin = chunkEnd;
+	}
+
+	std::mutex mutex;
+	std::condition_variable finished;
+	std::queue<std::size_t> finishedChunks;
+	std::atomic<bool> isCancelled(false);
+
+	auto parseChunk = [&](std::size_t index)
+	{
+		Chunk& chunk = chunks[index];
+		Parser parser;
+		parser.acceptsScalarRoot = true;
+
+		for (const char* line = chunk.begin; line != chunk.end && !isCancelled;)
+		{
+			const void* newline = std::memchr(line, '\n', chunk.end - line);
+			const char* lineEnd = newline ? static_cast<const char*>(newline) : chunk.end;
+
+			try
 			{
-				state = State::Comma;
-				requirePreviousState({ State::Value, State::ListClose, State::ObjectClose });
-				break;
+				if (!isBlank(line, lineEnd))
+					chunk.documents.push_back(parser.parse(line, lineEnd - line));
 			}
-			case Token::Type::Colon:
+			catch (const std::exception& exception)
 			{
-				state = State::Colon;
-				requirePreviousState({ State::Key });
+				chunk.error = std::make_exception_ptr(Exception("Could not parse the line at byte " + std::to_string(line - data) + ": " + exception.what()));
 				break;
 			}
-			case Token::Type::Boolean:
-			{
-				state = State::Value;
-				requirePreviousState({ State::Colon, State::Comma, State::ListOpen });
 
-				if (token.getValue() == "true")
-				{
-					addChildNode(std::make_shared<Node>(true));
-				}
-				else
-				{
-					addChildNode(std::make_shared<Node>(false));
-				}
-				break;
-			}
-			case Token::Type::Number:
-			{
-				state = State::Value;
-				requirePreviousState({ State::Colon, State::Comma, State::ListOpen });
+			line = (lineEnd == chunk.end) ? chunk.end : lineEnd + 1;
+		}
 
-				double number = std::stod(token.getValue());
-				double intPart;
-				if (std::modf(number, &intPart) == 0.0)
-				{
-					addChildNode(std::make_shared<Node>((int)number));
-				}
-				else
-				{
-					addChildNode(std::make_shared<Node>(number));
-				}
-				break;
+		std::lock_guard<std::mutex> lock(mutex);
+		chunk.isDone = true;
+		if (order == LineOrder::Unordered)
+			finishedChunks.push(index);
+		finished.notify_all();
+	};
+
+	// Declared last, so its destructor waits for the workers before the
+	// state they use is destroyed.
+	ThreadPool pool(threadCount);
+	const std::size_t chunksInFlight = 4 * std::size_t(pool.getThreadCount());
+
+	std::size_t submitted = 0;
+	std::size_t delivered = 0;
+
+	try
+	{
+		while (delivered < chunks.size())
+		{
+			while (submitted < chunks.size() && submitted - delivered < chunksInFlight)
+			{
+				pool.submit([&parseChunk, index = submitted] { parseChunk(index); });
+				submitted++;
 			}
-			case Token::Type::String:
+
+			std::size_t index;
 			{
-				if (checkPreviousState({ State::ObjectOpen, State::Comma }) && currentlyInAnObject())
+				std::unique_lock<std::mutex> lock(mutex);
+				if (order == LineOrder::Ordered)
 				{
-					state = State::Key;
-					lastKey = token.getValue();
-				}
-				else if ((checkPreviousState({ State::ListOpen, State::Comma }) && currentlyInAList()) || (checkPreviousState({ State::Colon }) && currentlyInAnObject()))
-				{
-					state = State::Value;
-					addChildNode(std::make_shared<Node>(token.getValue()));
+					finished.wait(lock, [&] { return chunks[delivered].isDone; });
+					index = delivered;
 				}
 				else
 				{
-					throw Exception("Wrong order of tokens");
+					finished.wait(lock, [&] { return !finishedChunks.empty(); });
+					index = finishedChunks.front();
+					finishedChunks.pop();
 				}
-				requirePreviousState({ State::ObjectOpen, State::ListOpen, State::Colon, State::Comma });
-				break;
 			}
-			case Token::Type::Null:
-			{
-				state = State::Value;
-				requirePreviousState({ State::Colon, State::Comma, State::ListOpen });
 
-				addChildNode(std::make_shared<Node>(nullptr));
-				break;
+			Chunk& chunk = chunks[index];
+			for (std::shared_ptr<Node>& document : chunk.documents)
+			{
+				onDocument(std::move(document));
 			}
-			case Token::Type::End:
+			chunk.documents = std::vector<std::shared_ptr<Node>>();
+			delivered++;
+
+			if (chunk.error)
 			{
-				state = State::End;
-				requirePreviousState({ State::Start, State::ListClose, State::ObjectClose });
-				break;
+				std::rethrow_exception(chunk.error);
 			}
 		}
 	}
-
-	return root;
-}
-
-void Json::Parser::addChildNode(std::shared_ptr<Node> node)
-{
-	if (currentlyInAList())
-	{
-		getParentNode()->addChild(node);
-	}
-	else if (currentlyInAnObject())
+	catch (...)
 	{
-		getParentNode()->addChild({ lastKey, node });
+		isCancelled = true;
+		throw;
 	}
-	else
-		throw Exception("Hierarchy contains illegal node type (" + getParentNode()->getTypeAsString() + ")");
 }
-
-bool Json::Parser::currentlyInAList() const noexcept
-{
-	if (hierarchy.empty())
-		return false;
-	return hierarchy.back()->getType() == Node::Type::List;
-}
-
-bool Json::Parser::currentlyInAnObject() const noexcept
-{
-	if (hierarchy.empty())
-		return false;
-	return hierarchy.back()->getType() == Node::Type::Object;
-}
-
-std::shared_ptr<Json::Node> Json::Parser::getParentNode() const noexcept
-{
-	if (hierarchy.empty())
-		return nullptr;
-	return hierarchy.back();
-}
\ No newline at end of file
@@ -0,0 +1,690 @@
+#include <charconv>
+#include <limits>
+#include "headers/path.h"
+#include "headers/number.h"
+
+namespace
+{
+	const std::size_t invalidPosition = std::string_view::npos;
+
+	Json::Node::Type getType(const Json::Node* node) noexcept
+	{
+		return node->getType();
+	}
+
+	Json::Node::Type getType(Json::Element element) noexcept
+	{
+		return element.getType();
+	}
+
+	double toDouble(const Json::Number& number) noexcept
+	{
+		switch (number.getType())
+		{
+			case Json::Number::Type::Integer:
+				return (double)number.getInteger();
+			case Json::Number::Type::Unsigned:
+				return (double)number.getUnsigned();
+			default:
+				return number.getDouble();
+		}
+	}
+
+	/**
+	 * Returns -1, 0 or 1 as the left number is less than, equal to or
+	 * greater than the right one
+	 *
+	 * Integers are compared exactly, so IDs above 2^53 are not matched by
+	 * their neighbours; numbers are only compared as double if either of
+	 * them is one.
+	 */
+	int compareNumbers(const Json::Number& left, const Json::Number& right) noexcept
+	{
+		using Type = Json::Number::Type;
+
+		if (left.getType() == Type::Double || right.getType() == Type::Double)
+		{
+			const double l = toDouble(left);
+			const double r = toDouble(right);
+			return l < r ? -1 : (r < l ? 1 : 0);
+		}
+		if (left.getType() == Type::Integer && right.getType() == Type::Integer)
+		{
+			return left.getInteger() < right.getInteger() ? -1 : (right.getInteger() < left.getInteger() ? 1 : 0);
+		}
+		if (left.getType() == Type::Integer && left.getInteger() < 0)
+		{
+			return -1;
+		}
+		if (right.getType() == Type::Integer && right.getInteger() < 0)
+		{
+			return 1;
+		}
+
+		const std::uint64_t l = left.getType() == Type::Integer ? std::uint64_t(left.getInteger()) : left.getUnsigned();
+		const std::uint64_t r = right.getType() == Type::Integer ? std::uint64_t(right.getInteger()) : right.getUnsigned();
+		return l < r ? -1 : (r < l ? 1 : 0);
+	}
+
+	bool getBoolean(const Json::Node* node)
+	{
+		return bool(*node);
+	}
+
+	bool getBoolean(Json::Element element)
+	{
+		return bool(element);
+	}
+
+	bool isNameCharacter(char c) noexcept
+	{
+		return c != '.' && c != '[' && c != ']' && c != ' ' && c != ')' && c != '=' && c != '!' && c != '<' && c != '>';
+	}
+
+	/**
+	 * Reads a string in single or double quotes, where a backslash escapes
+	 * the next character
+	 *
+	 * @returns the position after the closing quote, or invalidPosition
+	 * if the string is not closed
+	 */
+	std::size_t readQuoted(std::string_view text, std::size_t position, std::string& result)
+	{
+		const char quote = text[position++];
+		result.clear();
+
+		while (position < text.size() && text[position] != quote)
+		{
+			if (text[position] == '\\')
+				position++;
+			if (position < text.size())
+				result += text[position++];
+		}
+
+		return position < text.size() ? position + 1 : invalidPosition;
+	}
+
+	std::size_t skipWhiteSpace(std::string_view text, std::size_t position) noexcept
+	{
+		while (position < text.size() && text[position] == ' ')
+			position++;
+		return position;
+	}
+
+	/**
+	 * Reads an array index as defined by RFC 6901: 0, or digits not
+	 * starting with 0
+	 *
+	 * @returns false if the text is not an index, or does not fit into
+	 * std::size_t, in which case it is only a member name
+	 */
+	bool readArrayIndex(std::string_view text, std::size_t& index) noexcept
+	{
+		if (text.empty() || (text[0] == '0' && text.size() > 1))
+			return false;
+		for (char c : text)
+		{
+			if (c < '0' || '9' < c)
+				return false;
+		}
+
+		const std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), index);
+		return result.ec == std::errc();
+	}
+}
+
+/**
+ * Compiles a path expression
+ *
+ * @param expression a JSON Pointer (empty, or starting with '/') or a
+ * path starting with '$'
+ * @throws an exception if the expression is malformed
+ */
+Json::Path::Path(std::string_view expression) : expression(expression)
+{
+	if (expression.empty() || expression[0] == '/')
+	{
+		compilePointer(expression);
+	}
+	else if (expression[0] == '$')
+	{
+		compilePath(expression);
+	}
+	else throw Exception("Expression \"" + this->expression + "\" is neither a JSON Pointer nor a path starting with $");
+}
+
+const std::string& Json::Path::getExpression() const noexcept
+{
+	return expression;
+}
+
+/**
+ * Returns the first value selected by the path
+ *
+ * @returns the value, valid as long as the tree is, or nullptr if the
+ * path selects nothing
+ */
+const Json::Node* Json::Path::find(const Node& root) const
+{
+	const Node* result = nullptr;
+	auto onMatch = [&result](const Node* node)
+	{
+		result = node;
+		return false;
+	};
+	visit(&root, 0, onMatch);
+	return result;
+}
+
+/**
+ * Returns every value selected by the path, in document order
+ */
+std::vector<const Json::Node*> Json::Path::findAll(const Node& root) const
+{
+	std::vector<const Node*> result;
+	auto onMatch = [&result](const Node* node)
+	{
+		result.push_back(node);
+		return true;
+	};
+	visit(&root, 0, onMatch);
+	return result;
+}
+
+/**
+ * Returns the first element selected by the path, looking up the members
+ * of hashed objects with the precomputed hashes of the keys
+ */
+std::optional<Json::Element> Json::Path::find(Element root) const
+{
+	std::optional<Element> result;
+	auto onMatch = [&result](Element element)
+	{
+		result = element;
+		return false;
+	};
+	visit(root, 0, onMatch);
+	return result;
+}
+
+std::vector<Json::Element> Json::Path::findAll(Element root) const
+{
+	std::vector<Element> result;
+	auto onMatch = [&result](Element element)
+	{
+		result.push_back(element);
+		return true;
+	};
+	visit(root, 0, onMatch);
+	return result;
+}
+
+/**
+ * Splits a JSON Pointer into its reference tokens, decoding ~1 to / and
+ * ~0 to ~
+ */
+void Json::Path::compilePointer(std::string_view pointer)
+{
+	std::size_t position = 0;
+
+	while (position < pointer.size())
+	{
+		std::size_t end = pointer.find('/', position + 1);
+		if (end == std::string_view::npos)
+			end = pointer.size();
+
+		std::string token;
+		for (std::size_t i = position + 1; i < end; i++)
+		{
+			if (pointer[i] != '~')
+			{
+				token += pointer[i];
+			}
+			else if (i + 1 < end && (pointer[i + 1] == '0' || pointer[i + 1] == '1'))
+			{
+				token += (pointer[++i] == '0') ? '~' : '/';
+			}
+			else throw Exception("Invalid escape sequence in JSON Pointer \"" + expression + "\"");
+		}
+
+		Step step = Step();
+		step.type = Step::Type::Member;
+		step.isIndex = readArrayIndex(token, step.index);
+		step.member = makeName(std::move(token));
+		steps.push_back(std::move(step));
+
+		position = end;
+	}
+}
+
+void Json::Path::compilePath(std::string_view path)
+{
+	std::size_t position = 1;
+
+	while (position < path.size())
+	{
+		Step step = Step();
+
+		if (path[position] == '.')
+		{
+			position++;
+			if (position < path.size() && path[position] == '*')
+			{
+				step.type = Step::Type::Wildcard;
+				position++;
+			}
+			else
+			{
+				const std::size_t begin = position;
+				while (position < path.size() && isNameCharacter(path[position]))
+					position++;
+				if (position == begin)
+					throw Exception("Expected a member name at position " + std::to_string(begin) + " of \"" + expression + "\"");
+
+				step.type = Step::Type::Member;
+				step.member = makeName(std::string(path.substr(begin, position - begin)));
+			}
+		}
+		else if (path[position] == '[')
+		{
+			position++;
+			if (position >= path.size())
+				throw Exception("Unclosed bracket in \"" + expression + "\"");
+
+			const char c = path[position];
+			if (c == '*')
+			{
+				step.type = Step::Type::Wildcard;
+				position++;
+			}
+			else if (c == '\'' || c == '"')
+			{
+				std::string name;
+				position = readQuoted(path, position, name);
+				if (position == invalidPosition)
+					throw Exception("Unclosed quote in \"" + expression + "\"");
+
+				step.type = Step::Type::Member;
+				step.member = makeName(std::move(name));
+			}
+			else if ('0' <= c && c <= '9')
+			{
+				const std::size_t begin = position;
+				while (position < path.size() && '0' <= path[position] && path[position] <= '9')
+					position++;
+
+				// An index too large for std::size_t cannot be in range of
+				// any list, so it is kept as one that matches nothing.
+				step.type = Step::Type::Index;
+				if (std::from_chars(path.data() + begin, path.data() + position, step.index).ec != std::errc())
+					step.index = std::numeric_limits<std::size_t>::max();
+			}
+			else if (c == '?')
+			{
+				step.type = Step::Type::Filter;
+				position = compileFilter(path, position, step);
+			}
+			else throw Exception("Unexpected character '" + std::string(1, c) + "' at position " + std::to_string(position) + " of \"" + expression + "\"");
+
+			if (position >= path.size() || path[position] != ']')
+				throw Exception("Expected ']' at position " + std::to_string(position) + " of \"" + expression + "\"");
+			position++;
+		}
+		else throw Exception("Unexpected character '" + std::string(1, path[position]) + "' at position " + std::to_string(position) + " of \"" + expression + "\"");
+
+		steps.push_back(std::move(step));
+	}
+}
+
+/**
+ * Compiles a filter of the form ?(@.field <op> literal) or ?(@.field)
+ *
+ * @param position the position of the question mark
+ * @returns the position after the closing parenthesis
+ */
+std::size_t Json::Path::compileFilter(std::string_view path, std::size_t position, Step& step)
+{
+	if (path.substr(position, 2) != "?(")
+		throw Exception("Expected '?(' at position " + std::to_string(position) + " of \"" + expression + "\"");
+
+	position = skipWhiteSpace(path, position + 2);
+	if (position >= path.size() || path[position] != '@')
+		throw Exception("Filters have to start with '@' in \"" + expression + "\"");
+	position++;
+
+	while (position < path.size() && (path[position] == '.' || path[position] == '['))
+	{
+		if (path[position] == '.')
+		{
+			const std::size_t begin = ++position;
+			while (position < path.size() && isNameCharacter(path[position]))
+				position++;
+			if (position == begin)
+				throw Exception("Expected a member name at position " + std::to_string(begin) + " of \"" + expression + "\"");
+			step.field.push_back(makeName(std::string(path.substr(begin, position - begin))));
+		}
+		else
+		{
+			std::string name;
+			position++;
+			if (position < path.size() && (path[position] == '\'' || path[position] == '"'))
+				position = readQuoted(path, position, name);
+			if (position == invalidPosition || position >= path.size() || path[position] != ']')
+				throw Exception("Expected a quoted member name in the filter of \"" + expression + "\"");
+			position++;
+			step.field.push_back(makeName(std::move(name)));
+		}
+	}
+
+	position = skipWhiteSpace(path, position);
+
+	const std::string_view rest = path.substr(position);
+	if (rest.substr(0, 2) == "==")
+		step.comparison = Comparison::Equal;
+	else if (rest.substr(0, 2) == "!=")
+		step.comparison = Comparison::NotEqual;
+	else if (rest.substr(0, 2) == "<=")
+		step.comparison = Comparison::LessOrEqual;
+	else if (rest.substr(0, 2) == ">=")
+		step.comparison = Comparison::GreaterOrEqual;
+	else if (rest.substr(0, 1) == "<")
+		step.comparison = Comparison::Less;
+	else if (rest.substr(0, 1) == ">")
+		step.comparison = Comparison::Greater;
+	else
+		step.comparison = Comparison::Exists;
+
+	if (step.comparison != Comparison::Exists)
+	{
+		const bool isTwoCharacters = (step.comparison != Comparison::Less && step.comparison != Comparison::Greater);
+		position = skipWhiteSpace(path, position + (isTwoCharacters ? 2 : 1));
+		position = compileLiteral(path, position, step);
+		position = skipWhiteSpace(path, position);
+	}
+
+	if (position >= path.size() || path[position] != ')')
+		throw Exception("Expected ')' at position " + std::to_string(position) + " of \"" + expression + "\"");
+
+	return position + 1;
+}
+
+/**
+ * Compiles the literal a filter compares to
+ *
+ * @returns the position after the literal
+ */
+std::size_t Json::Path::compileLiteral(std::string_view path, std::size_t position, Step& step)
+{
+	const std::string_view rest = path.substr(position);
+
+	if (!rest.empty() && (rest[0] == '\'' || rest[0] == '"'))
+	{
+		step.literalType = Node::Type::String;
+		position = readQuoted(path, position, step.string);
+		if (position == invalidPosition)
+			throw Exception("Unclosed quote in \"" + expression + "\"");
+		return position;
+	}
+	if (rest.substr(0, 4) == "true" || rest.substr(0, 5) == "false")
+	{
+		step.literalType = Node::Type::Boolean;
+		step.boolean = (rest[0] == 't');
+		return position + (step.boolean ? 4 : 5);
+	}
+	if (rest.substr(0, 4) == "null")
+	{
+		step.literalType = Node::Type::Null;
+		return position + 4;
+	}
+
+	Number number;
+	const char* end = Number::parse(rest.data(), rest.data() + rest.size(), number);
+	if (end == nullptr)
+		throw Exception("Expected a literal at position " + std::to_string(position) + " of \"" + expression + "\"");
+	if (number.isOutOfRange())
+		throw Exception("Number at position " + std::to_string(position) + " of \"" + expression + "\" is out of the range of double");
+
+	step.literalType = Node::Type::Number;
+	step.number = number;
+	return position + (end - rest.data());
+}
+
+Json::Path::Name Json::Path::makeName(std::string name)
+{
+	const std::uint32_t hash = Key::hash(name);
+	return Name{ std::move(name), hash };
+}
+
+/**
+ * Applies the steps from the given one onwards to a value, reporting the
+ * selected values to the callback
+ *
+ * @param onMatch receives the selected values, and returns false to stop
+ * the search
+ * @returns false if the search was stopped
+ */
+template <typename Handle, typename Callback>
+bool Json::Path::visit(Handle value, std::size_t step, Callback& onMatch) const
+{
+	if (step == steps.size())
+	{
+		return onMatch(value);
+	}
+
+	const Step& current = steps[step];
+	Handle child = value;
+
+	switch (current.type)
+	{
+		case Step::Type::Member:
+			if (getType(value) == Node::Type::Object)
+			{
+				if (getMember(value, current.member, child))
+					return visit(child, step + 1, onMatch);
+			}
+			else if (current.isIndex && getElement(value, current.index, child))
+			{
+				return visit(child, step + 1, onMatch);
+			}
+			return true;
+		case Step::Type::Index:
+			if (getElement(value, current.index, child))
+				return visit(child, step + 1, onMatch);
+			return true;
+		case Step::Type::Wildcard:
+			return forEachChild(value, [&](Handle child)
+			{
+				return visit(child, step + 1, onMatch);
+			});
+		case Step::Type::Filter:
+			return forEachChild(value, [&](Handle child)
+			{
+				return !matches(child, current) || visit(child, step + 1, onMatch);
+			});
+		default:
+			return true;
+	}
+}
+
+/**
+ * Evaluates the condition of a filter step on a value
+ */
+template <typename Handle>
+bool Json::Path::matches(Handle value, const Step& step) const
+{
+	for (const Name& name : step.field)
+	{
+		if (getType(value) != Node::Type::Object || !getMember(value, name, value))
+			return false;
+	}
+
+	if (step.comparison == Comparison::Exists)
+		return true;
+
+	const Node::Type type = getType(value);
+	if (type != step.literalType)
+		return step.comparison == Comparison::NotEqual;
+
+	switch (type)
+	{
+		case Node::Type::Number:
+			return compare(compareNumbers(getNumber(value), step.number), step.comparison, 0);
+		case Node::Type::String:
+			return compare(getString(value), step.comparison, std::string_view(step.string));
+		case Node::Type::Boolean:
+			return compare(getBoolean(value), step.comparison, step.boolean);
+		case Node::Type::Null:
+			return compare(0, step.comparison, 0);
+		default:
+			return false;
+	}
+}
+
+template <typename T>
+bool Json::Path::compare(T left, Comparison comparison, T right) noexcept
+{
+	switch (comparison)
+	{
+		case Comparison::Equal:
+			return left == right;
+		case Comparison::NotEqual:
+			return left != right;
+		case Comparison::Less:
+			return left < right;
+		case Comparison::LessOrEqual:
+			return left <= right;
+		case Comparison::Greater:
+			return left > right;
+		case Comparison::GreaterOrEqual:
+			return left >= right;
+		case Comparison::Exists:
+			break;
+	}
+	return true;
+}
+
+/**
+ * Calls the callback with every element of a list, or every member value
+ * of an object, until it returns false
+ *
+ * @returns false if the callback stopped the iteration
+ */
+template <typename Handle, typename Callback>
+bool Json::Path::forEachChild(Handle value, Callback callback)
+{
+	if constexpr (std::is_same_v<Handle, const Node*>)
+	{
+		if (value->getType() == Node::Type::List)
+		{
+			for (const std::shared_ptr<Node>& element : std::get<List>(value->value))
+			{
+				if (!callback(element.get()))
+					return false;
+			}
+		}
+		else if (value->getType() == Node::Type::Object)
+		{
+			for (const auto& member : std::get<Object>(value->value))
+			{
+				if (!callback(member.second.get()))
+					return false;
+			}
+		}
+	}
+	else
+	{
+		if (value.entry->type == Node::Type::List)
+		{
+			for (std::size_t i = 0; i < value.entry->size; i++)
+			{
+				if (!callback(Element(&value.entry->elements[i])))
+					return false;
+			}
+		}
+		else if (value.entry->type == Node::Type::Object)
+		{
+			for (std::size_t i = 0; i < value.entry->size; i++)
+			{
+				if (!callback(Element(&value.entry->members[i].value)))
+					return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool Json::Path::getMember(const Node* node, const Name& name, const Node*& member)
+{
+	const Object& object = std::get<Object>(node->value);
+	auto position = object.find(std::string_view(name.name));
+	if (position == object.end())
+		return false;
+
+	member = position->second.get();
+	return true;
+}
+
+bool Json::Path::getMember(Element element, const Name& name, Element& member)
+{
+	const auto* found = element.findMember(name.name, element.entry->isHashed ? name.hash : 0, false);
+	if (found == nullptr)
+		return false;
+
+	member = Element(&found->value);
+	return true;
+}
+
+bool Json::Path::getElement(const Node* node, std::size_t index, const Node*& element)
+{
+	if (node->getType() != Node::Type::List)
+		return false;
+
+	const List& list = std::get<List>(node->value);
+	if (index >= list.size())
+		return false;
+
+	element = list[index].get();
+	return true;
+}
+
+bool Json::Path::getElement(Element list, std::size_t index, Element& element)
+{
+	if (list.entry->type != Node::Type::List || index >= list.entry->size)
+		return false;
+
+	element = Element(&list.entry->elements[index]);
+	return true;
+}
+
+std::string_view Json::Path::getString(const Node* node) noexcept
+{
+	return std::string_view(*node);
+}
+
+std::string_view Json::Path::getString(Element element) noexcept
+{
+	return std::string_view(element.entry->string, element.entry->size);
+}
+
+Json::Number Json::Path::getNumber(const Node* node)
+{
+	const Value& value = node->value;
+	if (std::holds_alternative<int>(value))
+		return Number(std::int64_t(std::get<int>(value)));
+	if (std::holds_alternative<std::int64_t>(value))
+		return Number(std::get<std::int64_t>(value));
+	if (std::holds_alternative<std::uint64_t>(value))
+		return Number(std::get<std::uint64_t>(value));
+	if (std::holds_alternative<LazyNumber>(value))
+		return std::get<LazyNumber>(value).getNumber();
+	return Number(std::get<double>(value));
+}
+
+Json::Number Json::Path::getNumber(Element element) noexcept
+{
+	if (!element.entry->isInteger)
+		return Number(element.entry->number);
+	if (element.entry->isUnsigned)
+		return Number(element.entry->unsignedInteger);
+	return Number(element.entry->integer);
+}
@@ -0,0 +1,225 @@
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "headers/snapshot.h"
+
+namespace
+{
+	const char snapshotMagic[8] = { 'J', 'S', 'O', 'N', 'S', 'N', 'A', 'P' };
+	const std::uint64_t payloadMask = (std::uint64_t(1) << 56) - 1;
+
+	/**
+	 * Checks in one pass that the words form a single value whose links and
+	 * offsets all stay inside the tape, so the accessors of TapeElement can
+	 * follow them without bounds checks
+	 *
+	 * Containers have to be closed by the matching tag, with the open and
+	 * close words pointing at each other, objects have to alternate string
+	 * keys and values, number tags have to be followed by their word, and
+	 * strings have to lie inside the string buffer.
+	 */
+	bool isValidTape(const std::uint64_t* words, std::size_t wordCount, const char* strings, std::size_t stringSize)
+	{
+		struct Container
+		{
+			std::size_t open;
+			bool isObject;
+			bool expectsKey;
+		};
+
+		std::vector<Container> containers;
+		std::size_t i = 0;
+
+		while (i < wordCount)
+		{
+			const char tag = char(words[i] >> 56);
+			const std::uint64_t payload = words[i] & payloadMask;
+
+			if (tag == '}' || tag == ']')
+			{
+				if (containers.empty())
+					return false;
+
+				const Container container = containers.back();
+				if (container.isObject != (tag == '}') || (container.isObject && !container.expectsKey))
+					return false;
+				if (payload != container.open || (words[container.open] & payloadMask) != i + 1)
+					return false;
+
+				containers.pop_back();
+				i++;
+			}
+			else
+			{
+				if (i != 0 && containers.empty())
+					return false;
+
+				const bool isKey = !containers.empty() && containers.back().isObject && containers.back().expectsKey;
+				if (isKey && tag != '"')
+					return false;
+
+				switch (tag)
+				{
+					case 't':
+					case 'f':
+					case 'n':
+						i++;
+						break;
+					case 'l':
+					case 'u':
+					case 'd':
+						if (wordCount - i < 2)
+							return false;
+						i += 2;
+						break;
+					case '"':
+					{
+						std::uint32_t length;
+						if (payload > stringSize || stringSize - payload < sizeof(length))
+							return false;
+						std::memcpy(&length, strings + payload, sizeof(length));
+						if (stringSize - payload - sizeof(length) < length)
+							return false;
+						i++;
+						break;
+					}
+					case '[':
+					case '{':
+						containers.push_back({ i, tag == '{', true });
+						i++;
+						continue;
+					default:
+						return false;
+				}
+
+				if (isKey)
+				{
+					containers.back().expectsKey = false;
+					continue;
+				}
+			}
+
+			if (!containers.empty() && containers.back().isObject)
+				containers.back().expectsKey = true;
+		}
+
+		return containers.empty();
+	}
+}
+
+/**
+ * Maps a snapshot file into memory
+ *
+ * The words and strings are used in place, after checking once that
+ * every link and offset of the tape stays inside the file, so a corrupted
+ * snapshot is rejected instead of being read out of bounds.
+ *
+ * @param fileName path of the snapshot file
+ * @throws an exception if the file is not a snapshot of this version and
+ * byte order, or if its tape is corrupted
+ */
+Json::Snapshot::Snapshot(std::string fileName) : file(fileName)
+{
+	Header header;
+	if (file.getSize() < sizeof(header))
+	{
+		throw Exception("File \"" + fileName + "\" is too small to be a snapshot");
+	}
+
+	std::memcpy(&header, file.getData(), sizeof(header));
+
+	if (std::memcmp(header.magic, snapshotMagic, sizeof(snapshotMagic)) != 0)
+	{
+		throw Exception("File \"" + fileName + "\" is not a snapshot");
+	}
+	if (header.byteOrder != byteOrderMark)
+	{
+		throw Exception("Snapshot \"" + fileName + "\" was written on a machine with a different byte order");
+	}
+	if (header.version != currentVersion)
+	{
+		throw Exception("Snapshot \"" + fileName + "\" has version " + std::to_string(header.version) + ", expected " + std::to_string(currentVersion));
+	}
+
+	const std::size_t available = file.getSize() - sizeof(header);
+	if (header.wordCount == 0 || header.wordCount > available / sizeof(std::uint64_t) || header.stringSize != available - header.wordCount * sizeof(std::uint64_t))
+	{
+		throw Exception("Snapshot \"" + fileName + "\" is truncated or corrupted");
+	}
+
+	wordCount = (std::size_t)header.wordCount;
+	words = reinterpret_cast<const std::uint64_t*>(file.getData() + sizeof(header));
+	strings = file.getData() + sizeof(header) + wordCount * sizeof(std::uint64_t);
+
+	if (!isValidTape(words, wordCount, strings, (std::size_t)header.stringSize))
+	{
+		throw Exception("Snapshot \"" + fileName + "\" is corrupted");
+	}
+}
+
+Json::TapeElement Json::Snapshot::getRoot() const noexcept
+{
+	return TapeElement(words, wordCount, strings, 0);
+}
+
+/**
+ * Returns the size of the mapped file
+ */
+std::size_t Json::Snapshot::getSizeInBytes() const noexcept
+{
+	return file.getSize();
+}
+
+/**
+ * Writes a tape into a snapshot file
+ *
+ * @param tape a tape returned by Parser::parseTape()
+ * @param fileName path of the file to create or overwrite
+ * @throws an exception if the tape is empty or the file cannot be written
+ */
+void Json::Snapshot::save(const Tape& tape, std::string fileName)
+{
+	const std::vector<std::uint64_t>& tapeWords = tape.getWords();
+	const std::vector<char>& tapeStrings = tape.getStrings();
+
+	if (tapeWords.empty())
+	{
+		throw Exception("Cannot save an empty tape");
+	}
+
+	Header header = Header();
+	std::memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+	header.version = currentVersion;
+	header.byteOrder = byteOrderMark;
+	header.wordCount = tapeWords.size();
+	header.stringSize = tapeStrings.size();
+
+	std::ofstream output(fileName, std::ios::binary | std::ios::trunc);
+	if (!output)
+	{
+		throw Exception("Failed to create snapshot file: \"" + fileName + "\"");
+	}
+
+	output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	output.write(reinterpret_cast<const char*>(tapeWords.data()), tapeWords.size() * sizeof(std::uint64_t));
+	output.write(tapeStrings.data(), tapeStrings.size());
+
+	if (!output.flush())
+	{
+		throw Exception("Failed to write snapshot file: \"" + fileName + "\"");
+	}
+}
+
+/**
+ * Writes a tree of nodes into a snapshot file
+ *
+ * @param root the root node returned by the parser
+ * @param fileName path of the file to create or overwrite
+ */
+void Json::Snapshot::save(const Node& root, std::string fileName)
+{
+	Tape tape;
+	TapeBuilder builder(tape);
+	builder.write(root);
+	save(tape, fileName);
+}
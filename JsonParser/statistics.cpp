@@ -0,0 +1,133 @@
+#include <atomic>
+#include "headers/statistics.h"
+#include "headers/writer.h"
+
+namespace
+{
+	std::atomic<Json::ParseStatistics::AllocationCounter> allocationCounter{ nullptr };
+}
+
+std::uint64_t Json::ParseStatistics::getNodeCount(Node::Type type) const noexcept
+{
+	return nodeCounts[std::size_t(type)];
+}
+
+/**
+ * Returns the total time of the measured stages
+ */
+double Json::ParseStatistics::getSeconds() const noexcept
+{
+	double seconds = 0;
+	for (const Stage& stage : stages)
+	{
+		seconds += stage.seconds;
+	}
+	return seconds;
+}
+
+/**
+ * Writes the stages in the Chrome trace event format, which can be
+ * opened in chrome://tracing or Perfetto
+ *
+ * The whole parse is one event with the counters as its arguments, and
+ * the stages are nested events inside it.
+ */
+void Json::ParseStatistics::writeChromeTrace(std::ostream& stream) const
+{
+	static const char* const typeNames[] = { "null", "boolean", "number", "string", "list", "object", "root" };
+
+	Writer writer(stream, Writer::Style::Pretty);
+
+	auto writeEvent = [&writer](std::string_view name, double start, double seconds)
+	{
+		writer.onKey("name");
+		writer.onValue(name);
+		writer.onKey("ph");
+		writer.onValue(std::string_view("X"));
+		writer.onKey("ts");
+		writer.onValue(start * 1e6);
+		writer.onKey("dur");
+		writer.onValue(seconds * 1e6);
+		writer.onKey("pid");
+		writer.onValue(std::int64_t(1));
+		writer.onKey("tid");
+		writer.onValue(std::int64_t(1));
+	};
+
+	writer.onObjectOpen();
+	writer.onKey("traceEvents");
+	writer.onListOpen();
+
+	writer.onObjectOpen();
+	writeEvent("parse", 0, getSeconds());
+	writer.onKey("args");
+	writer.onObjectOpen();
+	writer.onKey("bytes");
+	writer.onValue(bytes);
+	writer.onKey("tokens");
+	writer.onValue(tokens);
+	writer.onKey("allocations");
+	writer.onValue(allocations);
+	writer.onKey("allocatedBytes");
+	writer.onValue(allocatedBytes);
+	writer.onKey("maxDepth");
+	writer.onValue(std::uint64_t(maxDepth));
+	for (std::size_t i = 0; i < nodeCounts.size(); i++)
+	{
+		if (nodeCounts[i] == 0)
+			continue;
+		writer.onKey(std::string(typeNames[i]) + "Nodes");
+		writer.onValue(nodeCounts[i]);
+	}
+	writer.onObjectClose();
+	writer.onObjectClose();
+
+	for (const Stage& stage : stages)
+	{
+		writer.onObjectOpen();
+		writeEvent(stage.name, stage.start, stage.seconds);
+		writer.onObjectClose();
+	}
+
+	writer.onListClose();
+	writer.onKey("displayTimeUnit");
+	writer.onValue(std::string_view("ms"));
+	writer.onObjectClose();
+	writer.flush();
+}
+
+/**
+ * Sets the function the parser asks for the allocations made so far, or
+ * nullptr to stop counting them
+ *
+ * The library does not replace the global operator new itself. A program
+ * that counts its allocations, for example with its own operator new, can
+ * hand its counters to the parser here, and the statistics of instrumented
+ * builds then report the allocations made during each parse.
+ */
+void Json::ParseStatistics::setAllocationCounter(AllocationCounter counter) noexcept
+{
+	allocationCounter = counter;
+}
+
+/**
+ * Returns the number of allocations reported by the allocation counter,
+ * or 0 if none is set
+ */
+std::uint64_t Json::ParseStatistics::getAllocationCount() noexcept
+{
+	std::uint64_t count = 0;
+	std::uint64_t bytes = 0;
+	if (const AllocationCounter counter = allocationCounter.load())
+		counter(count, bytes);
+	return count;
+}
+
+std::uint64_t Json::ParseStatistics::getAllocatedBytes() noexcept
+{
+	std::uint64_t count = 0;
+	std::uint64_t bytes = 0;
+	if (const AllocationCounter counter = allocationCounter.load())
+		counter(count, bytes);
+	return bytes;
+}
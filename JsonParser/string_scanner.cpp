@@ -0,0 +1,589 @@
+#include <cstring>
+#include "headers/string_scanner.h"
+#include "headers/character_class.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define JSON_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define JSON_TARGET_SSE2
+#define JSON_TARGET_AVX2
+#else
+#define JSON_TARGET_SSE2 __attribute__((target("sse2")))
+#define JSON_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace
+{
+	using Implementation = Json::StringScanner::Implementation;
+
+	/**
+	 * The first quote, backslash or control character of a string, and
+	 * whether a non-ASCII character was passed on the way to it
+	 */
+	struct Special
+	{
+		const char* position;
+		bool hasNonAscii;
+	};
+
+	unsigned trailingZeros(std::uint32_t mask) noexcept
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return index;
+#else
+		return __builtin_ctz(mask);
+#endif
+	}
+
+	bool hasNonAsciiScalar(const char* p, const char* end) noexcept
+	{
+		std::uint64_t seen = 0;
+		for (; end - p >= 8; p += 8)
+		{
+			std::uint64_t word;
+			std::memcpy(&word, p, 8);
+			seen |= word;
+		}
+		for (; p != end; p++)
+		{
+			seen |= static_cast<unsigned char>(*p);
+		}
+		return (seen & 0x8080808080808080) != 0;
+	}
+
+	Special findSpecialScalar(const char* p, const char* end) noexcept
+	{
+		const char* position = Json::CharacterClass::findStringSpecial(p, end);
+		return { position, hasNonAsciiScalar(p, position) };
+	}
+
+	/**
+	 * Validates UTF-8 one character at a time, following the table of
+	 * well-formed byte sequences of the Unicode standard
+	 */
+	bool isValidUtf8Scalar(const char* begin, const char* end) noexcept
+	{
+		const unsigned char* p = reinterpret_cast<const unsigned char*>(begin);
+		const unsigned char* last = reinterpret_cast<const unsigned char*>(end);
+
+		while (p != last)
+		{
+			if (*p < 0x80)
+			{
+				p++;
+				continue;
+			}
+
+			std::size_t length;
+			unsigned char secondMinimum = 0x80;
+			unsigned char secondMaximum = 0xBF;
+
+			if (*p >= 0xC2 && *p <= 0xDF)
+			{
+				length = 2;
+			}
+			else if (*p >= 0xE0 && *p <= 0xEF)
+			{
+				length = 3;
+				if (*p == 0xE0)
+					secondMinimum = 0xA0;
+				else if (*p == 0xED)
+					secondMaximum = 0x9F;
+			}
+			else if (*p >= 0xF0 && *p <= 0xF4)
+			{
+				length = 4;
+				if (*p == 0xF0)
+					secondMinimum = 0x90;
+				else if (*p == 0xF4)
+					secondMaximum = 0x8F;
+			}
+			else
+			{
+				return false;
+			}
+
+			if (std::size_t(last - p) < length || p[1] < secondMinimum || p[1] > secondMaximum)
+				return false;
+			for (std::size_t i = 2; i < length; i++)
+			{
+				if ((p[i] & 0xC0) != 0x80)
+					return false;
+			}
+			p += length;
+		}
+
+		return true;
+	}
+
+#ifdef JSON_X86
+	JSON_TARGET_SSE2 Special findSpecialSse2(const char* p, const char* end) noexcept
+	{
+		const __m128i quote = _mm_set1_epi8('"');
+		const __m128i backslash = _mm_set1_epi8('\\');
+		const __m128i lastControl = _mm_set1_epi8(0x1F);
+		__m128i seen = _mm_setzero_si128();
+
+		for (; end - p >= 16; p += 16)
+		{
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			const __m128i special = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+				_mm_cmpeq_epi8(_mm_max_epu8(chunk, lastControl), lastControl));
+
+			const std::uint32_t mask = std::uint32_t(_mm_movemask_epi8(special));
+			if (mask != 0)
+			{
+				const unsigned position = trailingZeros(mask);
+				const std::uint32_t nonAscii = std::uint32_t(_mm_movemask_epi8(chunk)) & ((std::uint32_t(1) << position) - 1);
+				return { p + position, nonAscii != 0 || _mm_movemask_epi8(seen) != 0 };
+			}
+			seen = _mm_or_si128(seen, chunk);
+		}
+
+		Special special = findSpecialScalar(p, end);
+		special.hasNonAscii |= _mm_movemask_epi8(seen) != 0;
+		return special;
+	}
+
+	JSON_TARGET_AVX2 Special findSpecialAvx2(const char* p, const char* end) noexcept
+	{
+		const __m256i quote = _mm256_set1_epi8('"');
+		const __m256i backslash = _mm256_set1_epi8('\\');
+		const __m256i lastControl = _mm256_set1_epi8(0x1F);
+		__m256i seen = _mm256_setzero_si256();
+
+		for (; end - p >= 32; p += 32)
+		{
+			const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			const __m256i special = _mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+				_mm256_cmpeq_epi8(_mm256_max_epu8(chunk, lastControl), lastControl));
+
+			const std::uint32_t mask = std::uint32_t(_mm256_movemask_epi8(special));
+			if (mask != 0)
+			{
+				const unsigned position = trailingZeros(mask);
+				const std::uint32_t nonAscii = std::uint32_t(_mm256_movemask_epi8(chunk)) & ((std::uint32_t(1) << position) - 1);
+				return { p + position, nonAscii != 0 || _mm256_movemask_epi8(seen) != 0 };
+			}
+			seen = _mm256_or_si256(seen, chunk);
+		}
+
+		Special special = findSpecialSse2(p, end);
+		special.hasNonAscii |= _mm256_movemask_epi8(seen) != 0;
+		return special;
+	}
+
+	JSON_TARGET_SSE2 bool isValidUtf8Sse2(const char* begin, const char* end) noexcept
+	{
+		const char* p = begin;
+		while (end - p >= 16)
+		{
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			if (_mm_movemask_epi8(chunk) != 0)
+				break;
+			p += 16;
+		}
+		return isValidUtf8Scalar(p, end);
+	}
+
+	/**
+	 * The error classes of the lookup tables below, after "Validating
+	 * UTF-8 In Less Than One Instruction Per Byte" by Keiser and Lemire
+	 *
+	 * Every pair of consecutive bytes is classified by the high nibble of
+	 * the first byte, its low nibble and the high nibble of the second one.
+	 * The three lookups are combined with AND, so a bit remains set only if
+	 * all three nibbles allow the error.
+	 */
+	namespace Utf8Error
+	{
+		constexpr std::uint8_t TooShort = 1 << 0;     // 11______ 0_______ or 11______ 11______
+		constexpr std::uint8_t TooLong = 1 << 1;      // 0_______ 10______
+		constexpr std::uint8_t Overlong3 = 1 << 2;    // 11100000 100_____
+		constexpr std::uint8_t TooLarge = 1 << 3;     // 11110100 1001____ and above
+		constexpr std::uint8_t Surrogate = 1 << 4;    // 11101101 101_____
+		constexpr std::uint8_t Overlong2 = 1 << 5;    // 1100000_ 10______
+		constexpr std::uint8_t TooLarge1000 = 1 << 6; // 11110101 1000____ and above
+		constexpr std::uint8_t Overlong4 = 1 << 6;    // 11110000 1000____
+		constexpr std::uint8_t TwoContinuations = 1 << 7; // 10______ 10______
+		constexpr std::uint8_t Carry = TooShort | TooLong | TwoContinuations;
+
+		alignas(16) constexpr std::uint8_t firstHigh[16] = {
+			TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+			TwoContinuations, TwoContinuations, TwoContinuations, TwoContinuations,
+			TooShort | Overlong2,
+			TooShort,
+			TooShort | Overlong3 | Surrogate,
+			TooShort | TooLarge | TooLarge1000 | Overlong4
+		};
+
+		alignas(16) constexpr std::uint8_t firstLow[16] = {
+			Carry | Overlong3 | Overlong2 | Overlong4,
+			Carry | Overlong2,
+			Carry,
+			Carry,
+			Carry | TooLarge,
+			Carry | TooLarge | TooLarge1000,
+			Carry | TooLarge | TooLarge1000,
+			Carry | TooLarge | TooLarge1000,
+			Carry | TooLarge | TooLarge1000,
+			Carry | TooLarge | TooLarge1000,
+			Carry | TooLarge | TooLarge1000,
+			Carry | TooLarge | TooLarge1000,
+			Carry | TooLarge | TooLarge1000,
+			Carry | TooLarge | TooLarge1000 | Surrogate,
+			Carry | TooLarge | TooLarge1000,
+			Carry | TooLarge | TooLarge1000
+		};
+
+		alignas(16) constexpr std::uint8_t secondHigh[16] = {
+			TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+			TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge1000 | Overlong4,
+			TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge,
+			TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+			TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+			TooShort, TooShort, TooShort, TooShort
+		};
+
+		/**
+		 * Subtracted from the last three bytes of the input, what remains
+		 * is a lead byte whose continuation bytes are missing
+		 */
+		alignas(32) constexpr std::uint8_t incompleteLimits[32] = {
+			255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+			255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+			0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+		};
+	}
+
+	JSON_TARGET_AVX2 __m256i loadTable(const std::uint8_t* table) noexcept
+	{
+		return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+	}
+
+	/**
+	 * Returns the bytes of the previous block followed by the first 32 - n
+	 * bytes of this one
+	 */
+	template <int n>
+	JSON_TARGET_AVX2 __m256i shiftInPrevious(__m256i input, __m256i previousInput) noexcept
+	{
+		return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previousInput, input, 0x21), 16 - n);
+	}
+
+	JSON_TARGET_AVX2 __m256i checkUtf8Block(__m256i input, __m256i previousInput) noexcept
+	{
+		const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+		const __m256i previous1 = shiftInPrevious<1>(input, previousInput);
+
+		const __m256i firstHigh = _mm256_shuffle_epi8(loadTable(Utf8Error::firstHigh), _mm256_and_si256(_mm256_srli_epi16(previous1, 4), lowNibble));
+		const __m256i firstLow = _mm256_shuffle_epi8(loadTable(Utf8Error::firstLow), _mm256_and_si256(previous1, lowNibble));
+		const __m256i secondHigh = _mm256_shuffle_epi8(loadTable(Utf8Error::secondHigh), _mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibble));
+		const __m256i specialCases = _mm256_and_si256(_mm256_and_si256(firstHigh, firstLow), secondHigh);
+
+		// The third and fourth bytes of three and four byte characters have
+		// to be continuations, which the pairs above report as two
+		// continuations in a row.
+		const __m256i isThird = _mm256_subs_epu8(shiftInPrevious<2>(input, previousInput), _mm256_set1_epi8(char(0xE0 - 0x80)));
+		const __m256i isFourth = _mm256_subs_epu8(shiftInPrevious<3>(input, previousInput), _mm256_set1_epi8(char(0xF0 - 0x80)));
+		const __m256i mustBeContinuation = _mm256_and_si256(_mm256_or_si256(isThird, isFourth), _mm256_set1_epi8(char(0x80)));
+
+		return _mm256_xor_si256(mustBeContinuation, specialCases);
+	}
+
+	JSON_TARGET_AVX2 bool isValidUtf8Avx2(const char* begin, const char* end) noexcept
+	{
+		const char* p = begin;
+		__m256i error = _mm256_setzero_si256();
+		__m256i previousInput = _mm256_setzero_si256();
+
+		for (; end - p >= 32; p += 32)
+		{
+			const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			if (_mm256_movemask_epi8(input) == 0)
+			{
+				// An ASCII block only has to find the characters of the
+				// previous block complete.
+				error = _mm256_or_si256(error, _mm256_subs_epu8(previousInput, _mm256_load_si256(reinterpret_cast<const __m256i*>(Utf8Error::incompleteLimits))));
+				previousInput = _mm256_setzero_si256();
+				continue;
+			}
+
+			error = _mm256_or_si256(error, checkUtf8Block(input, previousInput));
+			previousInput = input;
+		}
+
+		if (p != end)
+		{
+			alignas(32) char padded[32] = {};
+			std::memcpy(padded, p, end - p);
+			const __m256i input = _mm256_load_si256(reinterpret_cast<const __m256i*>(padded));
+			error = _mm256_or_si256(error, checkUtf8Block(input, previousInput));
+			previousInput = input;
+		}
+
+		error = _mm256_or_si256(error, _mm256_subs_epu8(previousInput, _mm256_load_si256(reinterpret_cast<const __m256i*>(Utf8Error::incompleteLimits))));
+		return _mm256_testz_si256(error, error) != 0;
+	}
+#endif
+
+	Special findSpecial(const char* p, const char* end, Implementation implementation) noexcept
+	{
+#ifdef JSON_X86
+		if (implementation == Implementation::Avx2)
+			return findSpecialAvx2(p, end);
+		if (implementation == Implementation::Sse2)
+			return findSpecialSse2(p, end);
+#endif
+		return findSpecialScalar(p, end);
+	}
+
+	int readHexDigit(char c) noexcept
+	{
+		if (c >= '0' && c <= '9')
+			return c - '0';
+		if (c >= 'a' && c <= 'f')
+			return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F')
+			return c - 'A' + 10;
+		return -1;
+	}
+
+	/**
+	 * Reads the four hexadecimal digits of a \u escape sequence
+	 *
+	 * @returns the code unit, or -1 if the digits are missing or invalid
+	 */
+	long readCodeUnit(const char* digits, const char* end) noexcept
+	{
+		if (end - digits < 4)
+			return -1;
+
+		long codeUnit = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			const int digit = readHexDigit(digits[i]);
+			if (digit < 0)
+				return -1;
+			codeUnit = codeUnit * 16 + digit;
+		}
+		return codeUnit;
+	}
+
+	Implementation getBestImplementation() noexcept
+	{
+		static const Implementation implementation = Json::StructuralIndex::getBestImplementation();
+		return implementation;
+	}
+}
+
+/**
+ * Reads a string with the best implementation the processor supports
+ *
+ * @param begin the first character after the opening quote
+ * @param end the end of the input
+ * @param output receives the decoded string, replacing its contents
+ * @param origin the start of the input, the byte offsets of the error
+ * messages are counted from it
+ * @returns the character after the closing quote
+ * @throws an exception if the string is not closed, holds a control
+ * character, an invalid escape sequence or invalid UTF-8
+ */
+const char* Json::StringScanner::read(const char* begin, const char* end, std::string& output, const char* origin)
+{
+	return read(begin, end, output, origin, getBestImplementation());
+}
+
+const char* Json::StringScanner::read(const char* begin, const char* end, std::string& output, const char* origin, Implementation implementation)
+{
+	std::string_view text;
+	const char* next = read(begin, end, output, text, origin, implementation);
+	if (text.data() == begin)
+	{
+		output.assign(text);
+	}
+	return next;
+}
+
+/**
+ * Reads a string without copying it if it has no escape sequences
+ *
+ * @param output receives the decoded string if it has escape sequences
+ * @param text set to the characters of the string in the input, or to
+ * the output if they had to be decoded
+ * @returns the character after the closing quote
+ */
+const char* Json::StringScanner::read(const char* begin, const char* end, std::string& output, std::string_view& text, const char* origin)
+{
+	return read(begin, end, output, text, origin, getBestImplementation());
+}
+
+const char* Json::StringScanner::read(const char* begin, const char* end, std::string& output, std::string_view& text, const char* origin, Implementation implementation)
+{
+	output.clear();
+	bool hasNonAscii = false;
+	bool isDecoded = false;
+
+	for (const char* p = begin;;)
+	{
+		const Special special = findSpecial(p, end, implementation);
+		hasNonAscii |= special.hasNonAscii;
+
+		if (special.position == end)
+		{
+			throw Exception("Reached the end of the input inside the string starting at byte " + std::to_string(begin - 1 - origin));
+		}
+
+		const char c = *special.position;
+		if (c == '"')
+		{
+			// Escape sequences are ASCII, so the raw text is valid UTF-8
+			// exactly if the decoded one is.
+			if (hasNonAscii && !isValidUtf8(begin, special.position, implementation))
+			{
+				throw Exception("Found invalid UTF-8 in the string starting at byte " + std::to_string(begin - 1 - origin));
+			}
+
+			if (isDecoded)
+			{
+				output.append(p, special.position);
+				text = output;
+			}
+			else
+			{
+				text = std::string_view(begin, special.position - begin);
+			}
+			return special.position + 1;
+		}
+		if (c != '\\')
+		{
+			throw Exception("Found an unescaped control character at byte " + std::to_string(special.position - origin));
+		}
+
+		output.append(p, special.position);
+		isDecoded = true;
+		p = readEscape(special.position, end, output, origin);
+	}
+}
+
+/**
+ * Decodes an escape sequence, including both halves of a surrogate pair
+ *
+ * @param escape the backslash that starts the sequence
+ * @returns the character after the sequence
+ */
+const char* Json::StringScanner::readEscape(const char* escape, const char* end, std::string& output, const char* origin)
+{
+	auto position = [escape, origin] { return " at byte " + std::to_string(escape - origin); };
+
+	if (end - escape < 2)
+	{
+		throw Exception("Found an unfinished escape sequence" + position());
+	}
+
+	switch (escape[1])
+	{
+		case '"':
+		case '\\':
+		case '/':
+			output += escape[1];
+			return escape + 2;
+		case 'b':
+			output += '\b';
+			return escape + 2;
+		case 'f':
+			output += '\f';
+			return escape + 2;
+		case 'n':
+			output += '\n';
+			return escape + 2;
+		case 'r':
+			output += '\r';
+			return escape + 2;
+		case 't':
+			output += '\t';
+			return escape + 2;
+		case 'u':
+			break;
+		default:
+			throw Exception("Found an invalid escape sequence \"\\" + std::string(1, escape[1]) + "\"" + position());
+	}
+
+	const long codeUnit = readCodeUnit(escape + 2, end);
+	if (codeUnit < 0)
+	{
+		throw Exception("Found a \\u escape sequence without four hexadecimal digits" + position());
+	}
+
+	if (codeUnit >= 0xDC00 && codeUnit <= 0xDFFF)
+	{
+		throw Exception("Found a low surrogate without a high one before it" + position());
+	}
+	if (codeUnit < 0xD800 || codeUnit > 0xDBFF)
+	{
+		appendCodePoint(std::uint32_t(codeUnit), output);
+		return escape + 6;
+	}
+
+	const char* low = escape + 6;
+	const long lowCodeUnit = (end - low >= 2 && low[0] == '\\' && low[1] == 'u') ? readCodeUnit(low + 2, end) : -1;
+	if (lowCodeUnit < 0xDC00 || lowCodeUnit > 0xDFFF)
+	{
+		throw Exception("Found a high surrogate without a low one after it" + position());
+	}
+
+	appendCodePoint(0x10000 + ((std::uint32_t(codeUnit) - 0xD800) << 10) + (std::uint32_t(lowCodeUnit) - 0xDC00), output);
+	return low + 6;
+}
+
+void Json::StringScanner::appendCodePoint(std::uint32_t codePoint, std::string& output)
+{
+	if (codePoint < 0x80)
+	{
+		output += char(codePoint);
+	}
+	else if (codePoint < 0x800)
+	{
+		output += char(0xC0 | (codePoint >> 6));
+		output += char(0x80 | (codePoint & 0x3F));
+	}
+	else if (codePoint < 0x10000)
+	{
+		output += char(0xE0 | (codePoint >> 12));
+		output += char(0x80 | ((codePoint >> 6) & 0x3F));
+		output += char(0x80 | (codePoint & 0x3F));
+	}
+	else
+	{
+		output += char(0xF0 | (codePoint >> 18));
+		output += char(0x80 | ((codePoint >> 12) & 0x3F));
+		output += char(0x80 | ((codePoint >> 6) & 0x3F));
+		output += char(0x80 | (codePoint & 0x3F));
+	}
+}
+
+/**
+ * Returns whether the text is well-formed UTF-8
+ */
+bool Json::StringScanner::isValidUtf8(const char* begin, const char* end) noexcept
+{
+	return isValidUtf8(begin, end, getBestImplementation());
+}
+
+bool Json::StringScanner::isValidUtf8(const char* begin, const char* end, Implementation implementation) noexcept
+{
+#ifdef JSON_X86
+	if (implementation == Implementation::Avx2)
+		return isValidUtf8Avx2(begin, end);
+	if (implementation == Implementation::Sse2)
+		return isValidUtf8Sse2(begin, end);
+#endif
+	return isValidUtf8Scalar(begin, end);
+}
@@ -0,0 +1,337 @@
+#include <cstring>
+#include "headers/structural_index.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define JSON_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define JSON_TARGET_SSE2
+#define JSON_TARGET_AVX2
+#else
+#define JSON_TARGET_SSE2 __attribute__((target("sse2")))
+#define JSON_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace
+{
+	struct Block
+	{
+		std::uint64_t whiteSpace;
+		std::uint64_t operators;
+		std::uint64_t quotes;
+		std::uint64_t backslashes;
+	};
+
+	Block classifyScalar(const char* input) noexcept
+	{
+		Block block = {};
+		for (unsigned i = 0; i < 64; i++)
+		{
+			const std::uint64_t bit = std::uint64_t(1) << i;
+			switch (input[i])
+			{
+				case ' ': case '\t': case '\n': case '\r':
+					block.whiteSpace |= bit;
+					break;
+				case '{': case '}': case '[': case ']': case ':': case ',':
+					block.operators |= bit;
+					break;
+				case '"':
+					block.quotes |= bit;
+					break;
+				case '\\':
+					block.backslashes |= bit;
+					break;
+			}
+		}
+		return block;
+	}
+
+#ifdef JSON_X86
+	/**
+	 * '[' and ']' differ from '{' and '}' only in the 0x20 bit, so both
+	 * bracket kinds are matched with two comparisons
+	 */
+	JSON_TARGET_SSE2 Block classifySse2(const char* input) noexcept
+	{
+		Block block = {};
+		for (unsigned i = 0; i < 4; i++)
+		{
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 16 * i));
+			const __m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+
+			const __m128i whiteSpace = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))));
+			const __m128i operators = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'))),
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(','))));
+
+			const unsigned shift = 16 * i;
+			block.whiteSpace |= std::uint64_t(std::uint16_t(_mm_movemask_epi8(whiteSpace))) << shift;
+			block.operators |= std::uint64_t(std::uint16_t(_mm_movemask_epi8(operators))) << shift;
+			block.quotes |= std::uint64_t(std::uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'))))) << shift;
+			block.backslashes |= std::uint64_t(std::uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))))) << shift;
+		}
+		return block;
+	}
+
+	JSON_TARGET_AVX2 Block classifyAvx2(const char* input) noexcept
+	{
+		Block block = {};
+		for (unsigned i = 0; i < 2; i++)
+		{
+			const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + 32 * i));
+			const __m256i folded = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+
+			const __m256i whiteSpace = _mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))),
+				_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'))));
+			const __m256i operators = _mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}'))),
+				_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(','))));
+
+			const unsigned shift = 32 * i;
+			block.whiteSpace |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(whiteSpace))) << shift;
+			block.operators |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(operators))) << shift;
+			block.quotes |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'))))) << shift;
+			block.backslashes |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'))))) << shift;
+		}
+		return block;
+	}
+#endif
+
+	unsigned trailingZeros(std::uint64_t mask) noexcept
+	{
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+		unsigned long index;
+		_BitScanForward64(&index, mask);
+		return index;
+#elif defined(_MSC_VER) && !defined(__clang__)
+		unsigned long index;
+		if (_BitScanForward(&index, std::uint32_t(mask)))
+			return index;
+		_BitScanForward(&index, std::uint32_t(mask >> 32));
+		return index + 32;
+#else
+		return __builtin_ctzll(mask);
+#endif
+	}
+
+	/**
+	 * Marks every bit from an opening quote up to (excluding) the closing one
+	 */
+	std::uint64_t prefixXor(std::uint64_t mask) noexcept
+	{
+		mask ^= mask << 1;
+		mask ^= mask << 2;
+		mask ^= mask << 4;
+		mask ^= mask << 8;
+		mask ^= mask << 16;
+		mask ^= mask << 32;
+		return mask;
+	}
+
+	/**
+	 * Appends the token starts of one 64 byte block to the positions, the
+	 * state of the scan is carried over to the next block
+	 */
+	template<typename Position>
+	class Scanner
+	{
+	public:
+		Scanner(Json::StructuralIndex::Carry& carry, std::vector<Position>& positions) : carry(carry), positions(positions)
+		{
+		}
+
+		void scan(const Block& block, Position offset)
+		{
+			const std::uint64_t escaped = findEscaped(block.backslashes);
+			const std::uint64_t quotes = block.quotes & ~escaped;
+
+			const std::uint64_t inString = prefixXor(quotes) ^ carry.inString;
+			carry.inString = std::uint64_t(std::int64_t(inString) >> 63);
+
+			const std::uint64_t operators = block.operators & ~inString;
+			const std::uint64_t boundaries = operators | (block.whiteSpace & ~inString) | quotes;
+			const std::uint64_t scalars = ~(boundaries | inString);
+			const std::uint64_t scalarStarts = scalars & ((boundaries << 1) | carry.boundary);
+			carry.boundary = boundaries >> 63;
+
+			std::uint64_t structurals = operators | (quotes & inString) | scalarStarts;
+			while (structurals != 0)
+			{
+				positions.push_back(offset + Position(trailingZeros(structurals)));
+				structurals &= structurals - 1;
+			}
+		}
+
+	private:
+		Json::StructuralIndex::Carry& carry;
+		std::vector<Position>& positions;
+
+		/**
+		 * Returns the characters that follow an odd-length run of backslashes
+		 */
+		std::uint64_t findEscaped(std::uint64_t backslashes) noexcept
+		{
+			if (backslashes == 0)
+			{
+				const std::uint64_t escaped = carry.escaped;
+				carry.escaped = 0;
+				return escaped;
+			}
+
+			const std::uint64_t evenBits = 0x5555555555555555ULL;
+
+			backslashes &= ~carry.escaped;
+			const std::uint64_t followsEscape = (backslashes << 1) | carry.escaped;
+			const std::uint64_t oddSequenceStarts = backslashes & ~evenBits & ~followsEscape;
+
+			const std::uint64_t sequencesStartingOnEvenBits = oddSequenceStarts + backslashes;
+			carry.escaped = sequencesStartingOnEvenBits < oddSequenceStarts ? 1 : 0;
+
+			const std::uint64_t invertMask = sequencesStartingOnEvenBits << 1;
+			return (evenBits ^ invertMask) & followsEscape;
+		}
+	};
+
+	/**
+	 * Scans the bytes [from, to) of the input, to has to be a multiple of
+	 * 64 bytes or the end of the input, whose last block is padded with
+	 * spaces. The positions are stored relative to base.
+	 */
+	template<typename Position>
+	void scanRange(const char* data, std::size_t size, std::size_t from, std::size_t to, std::size_t base,
+		Json::StructuralIndex::Implementation implementation, Json::StructuralIndex::Carry& carry, std::vector<Position>& positions)
+	{
+		Block (*classify)(const char*) noexcept = classifyScalar;
+#ifdef JSON_X86
+		if (implementation == Json::StructuralIndex::Implementation::Sse2)
+			classify = classifySse2;
+		if (implementation == Json::StructuralIndex::Implementation::Avx2)
+			classify = classifyAvx2;
+#endif
+
+		Scanner<Position> scanner(carry, positions);
+
+		std::size_t offset = from;
+		for (; offset + 64 <= to; offset += 64)
+		{
+			scanner.scan(classify(data + offset), Position(offset - base));
+		}
+
+		if (offset < to && to == size)
+		{
+			char padded[64];
+			std::memset(padded, ' ', sizeof(padded));
+			std::memcpy(padded, data + offset, size - offset);
+			scanner.scan(classify(padded), Position(offset - base));
+		}
+	}
+}
+
+Json::StructuralIndex::StructuralIndex(const char* data, std::size_t size)
+	: StructuralIndex(data, size, getBestImplementation())
+{
+}
+
+/**
+ * Builds the index of the given JSON text with a specific implementation
+ *
+ * @param data pointer to the first character of the JSON text
+ * @param size length of the JSON text in bytes
+ * @param implementation the instruction set used to classify the bytes,
+ * it has to be supported by the processor
+ */
+Json::StructuralIndex::StructuralIndex(const char* data, std::size_t size, Implementation implementation)
+{
+	Carry carry;
+	positions.reserve(size / 8);
+	scanRange(data, size, 0, size, 0, implementation, carry, positions);
+}
+
+Json::StructuralIndex::Implementation Json::StructuralIndex::getBestImplementation() noexcept
+{
+#if defined(JSON_X86) && defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid(info, 0);
+	const int highestLeaf = info[0];
+
+	__cpuid(info, 1);
+	const bool hasSse2 = (info[3] & (1 << 26)) != 0;
+	const bool hasOsAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+
+	if (hasOsAvx && highestLeaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		if ((info[1] & (1 << 5)) != 0)
+			return Implementation::Avx2;
+	}
+	if (hasSse2)
+		return Implementation::Sse2;
+#elif defined(JSON_X86)
+	if (__builtin_cpu_supports("avx2"))
+		return Implementation::Avx2;
+	if (__builtin_cpu_supports("sse2"))
+		return Implementation::Sse2;
+#endif
+	return Implementation::Scalar;
+}
+
+bool Json::StructuralIndex::isAccelerated() noexcept
+{
+	return getBestImplementation() != Implementation::Scalar;
+}
+
+std::size_t Json::StructuralIndex::getSize() const noexcept
+{
+	return positions.size();
+}
+
+std::size_t Json::StructuralIndex::operator[](std::size_t index) const noexcept
+{
+	return positions[index];
+}
+
+Json::StructuralIndex::Stream::Stream(const char* data, std::size_t size)
+	: Stream(data, size, getBestImplementation())
+{
+}
+
+/**
+ * Prepares to index the given JSON text, nothing is scanned until the
+ * first position is requested
+ *
+ * @param data pointer to the first character of the JSON text
+ * @param size length of the JSON text in bytes
+ * @param implementation the instruction set used to classify the bytes,
+ * it has to be supported by the processor
+ */
+Json::StructuralIndex::Stream::Stream(const char* data, std::size_t size, Implementation implementation)
+	: data(data), size(size), implementation(implementation), scanned(0), base(0), cursor(0)
+{
+}
+
+/**
+ * Scans windows until one of them has a position in it
+ *
+ * @returns false if the input ended without one
+ */
+bool Json::StructuralIndex::Stream::refill()
+{
+	cursor = 0;
+	offsets.clear();
+
+	while (offsets.empty() && scanned < size)
+	{
+		const std::size_t to = (size - scanned > windowSize) ? scanned + windowSize : size;
+		base = scanned;
+		scanRange(data, size, scanned, to, base, implementation, carry, offsets);
+		scanned = to;
+	}
+
+	return !offsets.empty();
+}
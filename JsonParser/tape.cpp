@@ -0,0 +1,511 @@
+#include <cstring>
+#include <limits>
+#include "headers/tape.h"
+#include "headers/writer.h"
+
+namespace
+{
+	const std::uint64_t payloadMask = (std::uint64_t(1) << 56) - 1;
+
+	std::uint64_t makeWord(char tag, std::uint64_t payload) noexcept
+	{
+		return (std::uint64_t(std::uint8_t(tag)) << 56) | (payload & payloadMask);
+	}
+}
+
+Json::TapeElement Json::Tape::getRoot() const noexcept
+{
+	return TapeElement(words.data(), words.size(), strings.data(), 0);
+}
+
+/**
+ * Returns the memory held by the tape and its string buffer
+ */
+std::size_t Json::Tape::getSizeInBytes() const noexcept
+{
+	return words.capacity() * sizeof(std::uint64_t) + strings.capacity();
+}
+
+const std::vector<std::uint64_t>& Json::Tape::getWords() const noexcept
+{
+	return words;
+}
+
+const std::vector<char>& Json::Tape::getStrings() const noexcept
+{
+	return strings;
+}
+
+/**
+ * Creates a handle to the value starting at the given word of a tape
+ *
+ * @param words the words of the tape
+ * @param wordCount the number of words on the tape
+ * @param strings the string buffer the string words point into
+ * @param index the index of the first word of the value
+ */
+Json::TapeElement::TapeElement(const std::uint64_t* words, std::size_t wordCount, const char* strings, std::size_t index) noexcept
+	: words(words), wordCount(wordCount), strings(strings), index(index)
+{
+}
+
+Json::TapeElement Json::TapeElement::at(unsigned index) const
+{
+	return (*this)[index];
+}
+
+Json::TapeElement Json::TapeElement::at(std::string_view key) const
+{
+	if (getTag() == '{')
+	{
+		const std::size_t end = getPayload() - 1;
+		for (std::size_t i = index + 1; i < end; i = withIndex(i + 1).getNextIndex())
+		{
+			if (withIndex(i).getString() == key)
+			{
+				return withIndex(i + 1);
+			}
+		}
+		throw Exception("Key \"" + std::string(key) + "\" does not exists in indexed JSON object");
+	}
+	else throw Exception("Requested map-like indexing on " + getTypeAsString() + " type JSON element");
+}
+
+Json::TapeElement Json::TapeElement::operator[](const unsigned int index) const
+{
+	if (getTag() == '[')
+	{
+		const std::size_t end = getPayload() - 1;
+		std::size_t i = this->index + 1;
+		unsigned position = 0;
+
+		for (; i < end && position < index; position++)
+		{
+			i = withIndex(i).getNextIndex();
+		}
+
+		if (i < end)
+		{
+			return withIndex(i);
+		}
+		else
+		{
+			throw Exception("List type JSON element indexed out of range (index: " + std::to_string(index) + ", size: " + std::to_string(position) + ")");
+		}
+	}
+	else throw Exception("Requested vector-like indexing on " + getTypeAsString() + " type JSON element");
+}
+
+Json::TapeElement Json::TapeElement::operator[](const char* key) const
+{
+	return at(std::string_view(key));
+}
+
+Json::TapeElement::operator bool() const
+{
+	if (getTag() == 't' || getTag() == 'f')
+	{
+		return getTag() == 't';
+	}
+	else throw Exception("Cannot convert " + getTypeAsString() + " element to bool");
+}
+
+/**
+ * Converts a number element to int
+ *
+ * @throws an exception if the element is not a number, or if its value
+ * does not fit into an int
+ */
+Json::TapeElement::operator int() const
+{
+	if (getTag() == 'd')
+	{
+		int result;
+		if (!Number::truncate(double(*this), result))
+			throw Exception("Number " + toString() + " does not fit into an int");
+		return result;
+	}
+	else if (getTag() == 'l' || getTag() == 'u')
+	{
+		std::int64_t value = std::int64_t(words[index + 1]);
+		if (getTag() == 'u' || value < std::numeric_limits<int>::min() || std::numeric_limits<int>::max() < value)
+		{
+			throw Exception("Integer " + toString() + " does not fit into an int");
+		}
+		return (int)value;
+	}
+	else throw Exception("Cannot convert " + getTypeAsString() + " element to int");
+}
+
+/**
+ * Converts a number element to a 64-bit signed integer, the fraction of
+ * a double is truncated
+ *
+ * @throws an exception if the element is not a number, or if its value
+ * does not fit into an std::int64_t
+ */
+Json::TapeElement::operator std::int64_t() const
+{
+	if (getTag() == 'l')
+	{
+		return std::int64_t(words[index + 1]);
+	}
+	else if (getTag() == 'd')
+	{
+		std::int64_t result;
+		if (!Number::truncate(double(*this), result))
+			throw Exception("Number " + toString() + " does not fit into an std::int64_t");
+		return result;
+	}
+	else if (getTag() == 'u')
+	{
+		throw Exception("Integer " + toString() + " does not fit into an std::int64_t");
+	}
+	else throw Exception("Cannot convert " + getTypeAsString() + " element to std::int64_t");
+}
+
+/**
+ * Converts a number element to a 64-bit unsigned integer, the fraction
+ * of a double is truncated
+ *
+ * @throws an exception if the element is not a number, or if its value
+ * is negative or does not fit into an std::uint64_t
+ */
+Json::TapeElement::operator std::uint64_t() const
+{
+	if (getTag() == 'u' || (getTag() == 'l' && std::int64_t(words[index + 1]) >= 0))
+	{
+		return words[index + 1];
+	}
+	else if (getTag() == 'd')
+	{
+		std::uint64_t result;
+		if (!Number::truncate(double(*this), result))
+			throw Exception("Number " + toString() + " does not fit into an std::uint64_t");
+		return result;
+	}
+	else if (getTag() == 'l')
+	{
+		throw Exception("Integer " + toString() + " does not fit into an std::uint64_t");
+	}
+	else throw Exception("Cannot convert " + getTypeAsString() + " element to std::uint64_t");
+}
+
+Json::TapeElement::operator double() const
+{
+	if (getTag() == 'd')
+	{
+		double number;
+		std::memcpy(&number, &words[index + 1], sizeof(number));
+		return number;
+	}
+	else if (getTag() == 'l')
+	{
+		return (double)std::int64_t(words[index + 1]);
+	}
+	else if (getTag() == 'u')
+	{
+		return (double)words[index + 1];
+	}
+	else throw Exception("Cannot convert " + getTypeAsString() + " element to double");
+}
+
+Json::TapeElement::operator std::string() const
+{
+	return std::string(std::string_view(*this));
+}
+
+Json::TapeElement::operator std::string_view() const
+{
+	if (getTag() == '"')
+	{
+		return getString();
+	}
+	else throw Exception("Cannot convert " + getTypeAsString() + " element to std::string");
+}
+
+Json::Node::Type Json::TapeElement::getType() const noexcept
+{
+	switch (getTag())
+	{
+		case 't':
+		case 'f':
+			return Node::Type::Boolean;
+		case 'l':
+		case 'u':
+		case 'd':
+			return Node::Type::Number;
+		case 'n':
+			return Node::Type::Null;
+		case '"':
+			return Node::Type::String;
+		case '[':
+			return Node::Type::List;
+		case '{':
+			return Node::Type::Object;
+		default:
+			return Node::Type::Root;
+	}
+}
+
+std::string Json::TapeElement::getTypeAsString() const noexcept
+{
+	switch (getTag())
+	{
+		case 't':
+		case 'f':
+			return "Boolean";
+		case 'l':
+			return "Number (int64)";
+		case 'u':
+			return "Number (uint64)";
+		case 'd':
+			return "Number (double)";
+		case 'n':
+			return "Null";
+		case '"':
+			return "String";
+		case '[':
+			return "List";
+		case '{':
+			return "Object";
+		default:
+			return "Root";
+	}
+}
+
+/**
+ * Returns the value as indented JSON text
+ *
+ * @param indentation the nesting level the text is indented from
+ */
+std::string Json::TapeElement::toString(unsigned indentation) const
+{
+	std::string output;
+	Writer writer(output, Writer::Style::Pretty);
+	writer.setIndentation(indentation);
+	writer.write(*this);
+	writer.flush();
+	return output;
+}
+
+char Json::TapeElement::getTag() const noexcept
+{
+	if (index >= wordCount)
+		return 'r';
+	return char(words[index] >> 56);
+}
+
+std::uint64_t Json::TapeElement::getPayload() const noexcept
+{
+	return words[index] & payloadMask;
+}
+
+/**
+ * Returns the index of the word after this value, skipping whole
+ * containers in one step
+ */
+std::size_t Json::TapeElement::getNextIndex() const noexcept
+{
+	switch (getTag())
+	{
+		case '{':
+		case '[':
+			return getPayload();
+		case 'l':
+		case 'u':
+		case 'd':
+			return index + 2;
+		default:
+			return index + 1;
+	}
+}
+
+std::string_view Json::TapeElement::getString() const noexcept
+{
+	const char* string = strings + getPayload();
+	std::uint32_t length;
+	std::memcpy(&length, string, sizeof(length));
+	return std::string_view(string + sizeof(length), length);
+}
+
+Json::TapeElement Json::TapeElement::withIndex(std::size_t index) const noexcept
+{
+	return TapeElement(words, wordCount, strings, index);
+}
+
+Json::TapeBuilder::TapeBuilder(Tape& tape) : tape(tape)
+{
+}
+
+void Json::TapeBuilder::onObjectOpen()
+{
+	openContainer('{');
+}
+
+void Json::TapeBuilder::onObjectClose()
+{
+	closeContainer('}');
+}
+
+void Json::TapeBuilder::onListOpen()
+{
+	openContainer('[');
+}
+
+void Json::TapeBuilder::onListClose()
+{
+	closeContainer(']');
+}
+
+void Json::TapeBuilder::onKey(std::string_view key)
+{
+	addString(key);
+}
+
+void Json::TapeBuilder::onValue(bool value)
+{
+	addWord(value ? 't' : 'f', 0);
+}
+
+void Json::TapeBuilder::onValue(std::int64_t value)
+{
+	addWord('l', 0);
+	tape.words.push_back(std::uint64_t(value));
+}
+
+void Json::TapeBuilder::onValue(std::uint64_t value)
+{
+	addWord('u', 0);
+	tape.words.push_back(value);
+}
+
+void Json::TapeBuilder::onValue(double value)
+{
+	std::uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	addWord('d', 0);
+	tape.words.push_back(bits);
+}
+
+void Json::TapeBuilder::onValue(std::string_view value)
+{
+	addString(value);
+}
+
+void Json::TapeBuilder::onValue(std::nullptr_t)
+{
+	addWord('n', 0);
+}
+
+/**
+ * Writes a tree of nodes onto the tape, the same way as if it was parsed
+ */
+void Json::TapeBuilder::write(const Node& node)
+{
+	switch (node.type)
+	{
+		case Node::Type::Boolean:
+			onValue(std::get<bool>(node.value));
+			break;
+		case Node::Type::Number:
+			if (std::holds_alternative<int>(node.value))
+			{
+				onValue(std::int64_t(std::get<int>(node.value)));
+			}
+			else if (std::holds_alternative<std::int64_t>(node.value))
+			{
+				onValue(std::get<std::int64_t>(node.value));
+			}
+			else if (std::holds_alternative<std::uint64_t>(node.value))
+			{
+				onValue(std::get<std::uint64_t>(node.value));
+			}
+			else if (std::holds_alternative<LazyNumber>(node.value))
+			{
+				const Number& number = std::get<LazyNumber>(node.value).getNumber();
+				if (number.getType() == Number::Type::Integer)
+					onValue(number.getInteger());
+				else if (number.getType() == Number::Type::Unsigned)
+					onValue(number.getUnsigned());
+				else
+					onValue(number.getDouble());
+			}
+			else
+			{
+				onValue(std::get<double>(node.value));
+			}
+			break;
+		case Node::Type::String:
+			onValue(std::string_view(node));
+			break;
+		case Node::Type::Null:
+			onValue(nullptr);
+			break;
+		case Node::Type::List:
+			onListOpen();
+			for (const auto& element : std::get<List>(node.value))
+			{
+				write(*element);
+			}
+			onListClose();
+			break;
+		case Node::Type::Object:
+			onObjectOpen();
+			for (const auto& [key, member] : std::get<Object>(node.value))
+			{
+				onKey(key);
+				write(*member);
+			}
+			onObjectClose();
+			break;
+		default:
+			break;
+	}
+}
+
+void Json::TapeBuilder::addWord(char tag, std::uint64_t payload)
+{
+	tape.words.push_back(makeWord(tag, payload));
+}
+
+/**
+ * Appends a string to the string buffer, prefixed by its 32-bit length
+ *
+ * @throws an exception if the string is too long for its length prefix
+ */
+void Json::TapeBuilder::addString(std::string_view string)
+{
+	if (string.size() > std::numeric_limits<std::uint32_t>::max())
+	{
+		throw Exception("String of " + std::to_string(string.size()) + " bytes is too long for a tape");
+	}
+
+	const std::uint32_t length = std::uint32_t(string.size());
+	const std::size_t offset = tape.strings.size();
+
+	tape.strings.resize(offset + sizeof(length) + string.size());
+	std::memcpy(&tape.strings[offset], &length, sizeof(length));
+	std::memcpy(&tape.strings[offset + sizeof(length)], string.data(), string.size());
+
+	addWord('"', offset);
+}
+
+void Json::TapeBuilder::openContainer(char tag)
+{
+	openings.push_back(tape.words.size());
+	addWord(tag, 0);
+}
+
+/**
+ * Links the matching open and close words of a container to each other
+ */
+void Json::TapeBuilder::closeContainer(char tag)
+{
+	const std::size_t opening = openings.back();
+	openings.pop_back();
+
+	addWord(tag, opening);
+	tape.words[opening] = makeWord(char(tape.words[opening] >> 56), tape.words.size());
+}
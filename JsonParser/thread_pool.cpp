@@ -0,0 +1,76 @@
+#include <utility>
+#include "headers/thread_pool.h"
+
+/**
+ * Starts the worker threads
+ *
+ * @param threadCount number of workers, or 0 to start one for every
+ * hardware thread
+ */
+Json::ThreadPool::ThreadPool(unsigned threadCount)
+{
+	stopping = false;
+
+	if (threadCount == 0)
+		threadCount = std::thread::hardware_concurrency();
+	if (threadCount == 0)
+		threadCount = 1;
+
+	for (unsigned i = 0; i < threadCount; i++)
+	{
+		threads.emplace_back(&ThreadPool::work, this);
+	}
+}
+
+Json::ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	available.notify_all();
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+/**
+ * Queues a task to be run by the first idle worker
+ *
+ * The task must not throw, exceptions have to be passed back to the
+ * submitting thread by the task itself.
+ */
+void Json::ThreadPool::submit(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push(std::move(task));
+	}
+	available.notify_one();
+}
+
+unsigned Json::ThreadPool::getThreadCount() const noexcept
+{
+	return (unsigned)threads.size();
+}
+
+void Json::ThreadPool::work()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			available.wait(lock, [this] { return stopping || !tasks.empty(); });
+
+			if (tasks.empty())
+				return;
+
+			task = std::move(tasks.front());
+			tasks.pop();
+		}
+		task();
+	}
+}
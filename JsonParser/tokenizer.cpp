@@ -1,32 +1,70 @@
+#include <array>
+#include <cstring>
 #include "headers/tokenizer.h"
+#include "headers/character_class.h"
+#include "headers/string_scanner.h"
+#include "headers/writer.h"
 
+/**
+ * Creates a tokenizer over a memory mapped JSON file
+ *
+ * The characters are scanned directly in the mapping, the file is
+ * neither read through a stream nor copied into a buffer.
+ *
+ * @param fileName path of the JSON file
+ */
 Json::Tokenizer::Tokenizer(std::string fileName)
 {
 	previousReaderPosition = 0;
+	reachedEnd = false;
+	convertsNumbers = true;
+	openSeconds = 0;
 
-	if (file.is_open())
-	{
-		file.close();
-	}
+#ifdef JSON_INSTRUMENTATION
+	openStart = std::chrono::steady_clock::now();
+#endif
 
-	file.open(fileName);
+	file = std::make_unique<MappedFile>(fileName);
 
-	if (!file.good())
-	{
-		throw std::logic_error("[JSON Tokenizer Error] Failed to open JSON file: \"" + fileName + "\"");
-	}
+#ifdef JSON_INSTRUMENTATION
+	openSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - openStart).count();
+#endif
+
+	begin = file->getData();
+	end = begin + file->getSize();
+	reader = begin;
 }
 
-Json::Tokenizer::~Tokenizer()
+/**
+ * Creates a tokenizer over a contiguous in-memory buffer
+ *
+ * The buffer is not copied, so it has to outlive the tokenizer.
+ *
+ * @param data pointer to the first character of the JSON text
+ * @param size length of the JSON text in bytes
+ */
+Json::Tokenizer::Tokenizer(const char* data, std::size_t size)
 {
-	file.close();
+	previousReaderPosition = 0;
+	reachedEnd = false;
+	convertsNumbers = true;
+	openSeconds = 0;
+
+#ifdef JSON_INSTRUMENTATION
+	openStart = std::chrono::steady_clock::now();
+#endif
+
+	begin = data;
+	end = data + size;
+	reader = begin;
 }
 
 std::vector<Json::Token> Json::Tokenizer::tokenize()
 {
 	std::vector<Json::Token> tokens;
 
-	file.seekg(0);
+	reader = begin;
+	reachedEnd = false;
 
 	while (hasMoreTokens())
 	{
@@ -38,104 +76,172 @@ std::vector<Json::Token> Json::Tokenizer::tokenize()
 }
 
 /**
- * Reads from Tokenizer::file until a character inside characters is read
+ * Reads the next character of the input, or returns -1 (and marks the
+ * end of the input as reached) if there are no more characters left
+ */
+char Json::Tokenizer::readCharacter() noexcept
+{
+	if (reader == end)
+	{
+		reachedEnd = true;
+		return -1;
+	}
+	return *reader++;
+}
+
+/**
+ * Reads from the input until a character inside characters is read
  *
  * This function expects that the input pointer is set to be directly
  * in front of the string value, after the starting double quote.
  *
  * @param characters a string containing characters that when read
- * stop the reading of the file (i.e. '"' for json strings).
+ * stop the reading of the input (i.e. '"' for json strings).
  * @param inclusive whether the input pointer should stop before
  * (exclusive) or after (inclusive) the closing character
  * @returns the string value as an std::string
- * @throws a logic error if the file cannot be read
+ * @throws a logic error if the input ends before a closing character
  */
 std::string Json::Tokenizer::readUntil(std::string characters, bool inclusive)
 {
-	std::string result = "";
-	char c = file.get();
-
-	while (characters.find(c) == std::string::npos)
+	std::array<bool, 256> stops = {};
+	for (char c : characters)
 	{
-		result += c;
-
-		if (!file.good())
-		{
-			throw Exception("Function readUntil() could not find closing character(s) while reading the json file");
-		}
+		stops[static_cast<unsigned char>(c)] = true;
+	}
+	return readSpan(stops, inclusive);
+}
 
-		c = file.get();
+std::string Json::Tokenizer::readWhile(std::string characters, bool inclusive)
+{
+	std::array<bool, 256> stops;
+	stops.fill(true);
+	for (char c : characters)
+	{
+		stops[static_cast<unsigned char>(c)] = false;
 	}
+	return readSpan(stops, !inclusive);
+}
+
+/**
+ * Reads the characters up to the first one marked in the table, and
+ * copies them into the result at once
+ */
+std::string Json::Tokenizer::readSpan(const std::array<bool, 256>& stops, bool inclusive)
+{
+	const char* spanEnd = reader;
+	while (spanEnd != end && !stops[static_cast<unsigned char>(*spanEnd)])
+		spanEnd++;
 
-	if (!inclusive)
+	if (spanEnd == end)
 	{
-		rollBackCharacter();
+		reader = end;
+		reachedEnd = true;
+		throw Exception("Function readUntil() could not find closing character(s) while reading the json file");
 	}
 
+	std::string result(reader, spanEnd);
+	reader = inclusive ? spanEnd + 1 : spanEnd;
 	return result;
 }
 
-std::string Json::Tokenizer::readWhile(std::string characters, bool inclusive)
+/**
+ * Reads a string token, whose opening quote has already been read, and
+ * decodes its escape sequences
+ */
+void Json::Tokenizer::readString(Token& token)
 {
-	std::string negatedCharacters = "";
-	for (unsigned int i = 0; i <= 255; i++)
+	std::string_view text;
+	reader = StringScanner::read(reader, end, token.value, text, begin);
+	if (text.data() != token.value.data())
 	{
-		char c = i;
-		if (characters.find(c) == std::string::npos)
-		{
-			negatedCharacters += c;
-		}
+		token.source = text;
 	}
-	return readUntil(negatedCharacters, !inclusive);
 }
 
-char Json::Tokenizer::getNextNonWhiteSpaceCharacter()
+/**
+ * Reads a true, false or null token, which has to be followed by a
+ * delimiter or the end of the input
+ *
+ * @param literal the expected text of the token
+ * @param description the name of the token type in the error message
+ */
+void Json::Tokenizer::readLiteral(Token& token, std::string_view literal, const char* description)
 {
-	char c = ' ';
+	const std::size_t length = literal.size();
 
-	while (c == ' ' || c == '\n' || c == '\t')
+	if (std::size_t(end - reader) >= length && std::memcmp(reader, literal.data(), length) == 0 && (reader + length == end || isDelimiter(reader[length])))
 	{
-		c = file.get();
-
-		if (file.eof())
-		{
-			return -1;
-		}
-		if (!file.good())
-		{
-			throw Exception("Can't read more characters from file!");
-		}
+		token.value.assign(literal.data(), length);
+		reader += length;
+		return;
 	}
 
-	return c;
+	const char* textEnd = reader;
+	while (textEnd != end && !isDelimiter(*textEnd))
+		textEnd++;
+
+	throw Exception(std::string("Misspelled ") + description + " Token value: found \"" + std::string(reader, textEnd) + "\" instead of \"" + std::string(literal) + "\"");
+}
+
+char Json::Tokenizer::getNextNonWhiteSpaceCharacter()
+{
+	reader = CharacterClass::skipWhiteSpace(reader, end);
+	return readCharacter();
+}
+
+/**
+ * Sets whether number tokens are converted while they are read
+ *
+ * When disabled, only the grammar of the numbers is checked, and their
+ * value has to be converted from the token's text later on.
+ */
+void Json::Tokenizer::setNumberConversion(bool enabled) noexcept
+{
+	convertsNumbers = enabled;
+}
+
+bool Json::Tokenizer::isConvertingNumbers() const noexcept
+{
+	return convertsNumbers;
+}
+
+std::size_t Json::Tokenizer::getInputSize() const noexcept
+{
+	return end - begin;
 }
 
 bool Json::Tokenizer::hasMoreTokens() noexcept
 {
-	return !file.eof() && !file.fail();
+	return !reachedEnd;
 }
 
 void Json::Tokenizer::rollBackToken()
 {
-	if (file.eof())
-	{
-		file.clear();
-	}
-	file.seekg(previousReaderPosition);
+	reachedEnd = false;
+	reader = begin + previousReaderPosition;
 }
 
 void Json::Tokenizer::rollBackCharacter()
 {
-	if (file.eof())
+	reachedEnd = false;
+	if (reader != begin)
 	{
-		file.clear();
+		reader--;
 	}
-	file.unget();
 }
 
 void Json::Tokenizer::moveReader(int distance)
 {
-	file.seekg(distance, file.cur);
+	reader += distance;
+}
+
+/**
+ * Returns whether the character can end a scalar token
+ */
+bool Json::Tokenizer::isDelimiter(char c) noexcept
+{
+	return CharacterClass::is(c, CharacterClass::Delimiter);
 }
 
 bool Json::Tokenizer::checkNextNCharacters(unsigned int n, std::string expected)
@@ -145,7 +251,7 @@ bool Json::Tokenizer::checkNextNCharacters(unsigned int n, std::string expected)
 
 	for (unsigned int i = 0; i < n; i++)
 	{
-		if (file.get() != expected[i])
+		if (readCharacter() != expected[i])
 			return false;
 	}
 
@@ -153,73 +259,67 @@ bool Json::Tokenizer::checkNextNCharacters(unsigned int n, std::string expected)
 }
 
 /**
- * Returns the next token in the given json file
+ * Returns the next token in the given json input
  *
  * @returns the next token as a Token
- * @throws a logic error if the file cannot be read
+ * @throws a logic error if the input cannot be read
  */
 Json::Token Json::Tokenizer::getToken()
 {
-	if (file.eof())
+	if (reachedEnd)
 	{
 		throw Exception("Ran out of tokens!");
 	}
 
-	previousReaderPosition = file.tellg();
+	previousReaderPosition = reader - begin;
 	char c = getNextNonWhiteSpaceCharacter();
 	Token token;
+	token.offset = reachedEnd ? end - begin : reader - begin - 1;
 
-	if (('0' <= c && c <= '9') || c == '-' || c == '.')
+	if (CharacterClass::is(c, CharacterClass::NumberStart))
 	{
 		moveReader(-1);
 		token.type = Token::Type::Number;
-		token.value = readUntil(",]}", false); // readWhile("0123456789.-eE", false);
 
-		double number;
+		const char* numberEnd = convertsNumbers ? Number::parse(reader, end, token.number) : Number::scan(reader, end);
 
-		try
+		if (numberEnd == nullptr || (numberEnd != end && !isDelimiter(*numberEnd)))
 		{
-			number = std::stod(token.value);
+			const char* textEnd = reader;
+			while (textEnd != end && !isDelimiter(*textEnd))
+				textEnd++;
+			throw Exception("Could not convert \"" + std::string(reader, textEnd) + "\" to a number");
 		}
-		catch (...)
+		if (convertsNumbers && token.number.isOutOfRange())
 		{
-			throw Exception("Could not convert \"" + token.value + "\" to a number");
+			throw Exception("Number " + std::string(reader, numberEnd) + " is out of the range of double");
 		}
+
+		token.source = std::string_view(reader, numberEnd - reader);
+		reader = numberEnd;
 	}
 	else if (c == '"')
 	{
 		token.type = Token::Type::String;
-		token.value = readUntil("\"", true);
+		readString(token);
 	}
 	else if (c == 't')
 	{
 		moveReader(-1);
 		token.type = Token::Type::Boolean;
-		token.value = readUntil(",]}", false);
-		if (token.value != "true")
-		{
-			throw Exception("Misspelled Boolean Token value: found \"" + token.value + "\" instead of \"true\"");
-		}
+		readLiteral(token, "true", "Boolean");
 	}
 	else if (c == 'f')
 	{
 		moveReader(-1);
 		token.type = Token::Type::Boolean;
-		token.value = readUntil(",]}", false);
-		if (token.value != "false")
-		{
-			throw Exception("Misspelled Boolean Token value: found \"" + token.value + "\" instead of \"false\"");
-		}
+		readLiteral(token, "false", "Boolean");
 	}
 	else if (c == 'n')
 	{
 		moveReader(-1);
 		token.type = Token::Type::Null;
-		token.value = readUntil(",]}", false);
-		if (token.value != "null")
-		{
-			throw Exception("Misspelled Null Token value: found \"" + token.value + "\" instead of \"null\"");
-		}
+		readLiteral(token, "null", "Null");
 	}
 	else if (c == '{')
 	{
@@ -262,9 +362,31 @@ Json::Token::Type Json::Token::getType() const noexcept
 	return type;
 }
 
-std::string Json::Token::getValue() const noexcept
+/**
+ * Returns the decoded value of a number token
+ */
+const Json::Number& Json::Token::getNumber() const noexcept
+{
+	return number;
+}
+
+/**
+ * Returns the position of the first character of the token in the input
+ */
+std::size_t Json::Token::getOffset() const noexcept
+{
+	return offset;
+}
+
+/**
+ * Returns the text of the token, or the decoded characters of a string
+ *
+ * Numbers and strings without escape sequences refer to the input
+ * instead of a copy, so the text is only valid as long as the input is.
+ */
+std::string_view Json::Token::getValue() const noexcept
 {
-	return value;
+	return source.data() != nullptr ? source : std::string_view(value);
 }
 
 std::string Json::Token::toString() const noexcept
@@ -276,9 +398,9 @@ std::string Json::Token::toString() const noexcept
 		case Token::Type::Boolean:
 			return "Boolean: " + value;
 		case Token::Type::Number:
-			return "Number: " + value;
+			return "Number: " + std::string(getValue());
 		case Token::Type::String:
-			return "String: \"" + value + "\"";
+			return "String: \"" + Writer::escape(getValue()) + "\"";
 		case Token::Type::ListOpen:
 			return "ListOpen";
 		case Token::Type::ListClose:
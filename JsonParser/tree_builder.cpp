@@ -0,0 +1,220 @@
+#include <limits>
+#include <utility>
+#include "headers/tree_builder.h"
+
+namespace
+{
+	/**
+	 * Allocates a node together with a reference to the memory its value
+	 * refers to, so the memory stays alive as long as the node is shared
+	 */
+	template <typename T>
+	struct OwningAllocator
+	{
+		using value_type = T;
+
+		std::shared_ptr<const void> owner;
+
+		OwningAllocator(std::shared_ptr<const void> owner) noexcept : owner(std::move(owner))
+		{
+		}
+
+		template <typename U>
+		OwningAllocator(const OwningAllocator<U>& other) noexcept : owner(other.owner)
+		{
+		}
+
+		T* allocate(std::size_t count)
+		{
+			return std::allocator<T>().allocate(count);
+		}
+
+		void deallocate(T* pointer, std::size_t count) noexcept
+		{
+			std::allocator<T>().deallocate(pointer, count);
+		}
+
+		template <typename U>
+		bool operator==(const OwningAllocator<U>& other) const noexcept
+		{
+			return owner == other.owner;
+		}
+
+		template <typename U>
+		bool operator!=(const OwningAllocator<U>& other) const noexcept
+		{
+			return owner != other.owner;
+		}
+	};
+
+	std::shared_ptr<Json::Node> makeOwningNode(Json::Value value, std::shared_ptr<const void> owner)
+	{
+		return std::allocate_shared<Json::Node>(OwningAllocator<Json::Node>(std::move(owner)), std::move(value));
+	}
+}
+
+Json::TreeBuilder::TreeBuilder() : TreeBuilder(nullptr, nullptr, nullptr)
+{
+}
+
+/**
+ * @param sourceBegin the first character of the input of the parser
+ * @param sourceEnd the end of the input
+ * @param sourceOwner keeps the input alive, every node shares it so any
+ * node of the tree can be held on its own
+ */
+Json::TreeBuilder::TreeBuilder(const char* sourceBegin, const char* sourceEnd, std::shared_ptr<const void> sourceOwner)
+	: sourceBegin(sourceBegin), sourceEnd(sourceEnd), sourceOwner(std::move(sourceOwner))
+{
+	root = std::make_shared<Node>();
+}
+
+void Json::TreeBuilder::onObjectOpen()
+{
+	openNode(makeNode(Object()));
+}
+
+void Json::TreeBuilder::onObjectClose()
+{
+	hierarchy.pop_back();
+}
+
+void Json::TreeBuilder::onListOpen()
+{
+	openNode(makeNode(List()));
+}
+
+void Json::TreeBuilder::onListClose()
+{
+	hierarchy.pop_back();
+}
+
+void Json::TreeBuilder::onKey(std::string_view key)
+{
+	lastKey = key;
+}
+
+void Json::TreeBuilder::onValue(bool value)
+{
+	addChildNode(makeNode(value));
+}
+
+/**
+ * Stores integers that fit into an int as int, so the tree keeps the
+ * types it has always had for them
+ */
+void Json::TreeBuilder::onValue(std::int64_t value)
+{
+	if (std::numeric_limits<int>::min() <= value && value <= std::numeric_limits<int>::max())
+	{
+		addChildNode(makeNode((int)value));
+	}
+	else
+	{
+		addChildNode(makeNode(value));
+	}
+}
+
+void Json::TreeBuilder::onValue(std::uint64_t value)
+{
+	addChildNode(makeNode(value));
+}
+
+void Json::TreeBuilder::onValue(double value)
+{
+	addChildNode(makeNode(value));
+}
+
+/**
+ * Keeps the text of lazy numbers as views: numbers in the input of a view
+ * tree refer to the input, the others are copied into an arena shared by
+ * the nodes that refer to it
+ */
+void Json::TreeBuilder::onValue(LazyNumber value)
+{
+	if (isInSource(value.getText()))
+	{
+		addChildNode(makeNode(value));
+		return;
+	}
+
+	if (!numberTexts)
+	{
+		numberTexts = std::make_shared<Arena>();
+	}
+	addChildNode(makeOwningNode(LazyNumber(numberTexts->copyString(value.getText())), numberTexts));
+}
+
+/**
+ * Stores strings without escape sequences as views of the input, if the
+ * builder was given the input, and copies the decoded ones
+ */
+void Json::TreeBuilder::onValue(std::string_view value)
+{
+	if (isInSource(value))
+	{
+		addChildNode(makeNode(value));
+	}
+	else
+	{
+		addChildNode(makeNode(std::string(value)));
+	}
+}
+
+void Json::TreeBuilder::onValue(std::nullptr_t value)
+{
+	addChildNode(makeNode(value));
+}
+
+bool Json::TreeBuilder::isInSource(std::string_view value) const noexcept
+{
+	const std::less<const char*> less;
+	return sourceBegin != nullptr && !less(value.data(), sourceBegin) && !less(sourceEnd, value.data() + value.size());
+}
+
+std::shared_ptr<Json::Node> Json::TreeBuilder::getRoot() const noexcept
+{
+	return root;
+}
+
+/**
+ * Allocates a node, which shares the ownership of the input if the
+ * builder was given its owner
+ */
+std::shared_ptr<Json::Node> Json::TreeBuilder::makeNode(Value value) const
+{
+	if (sourceOwner)
+	{
+		return makeOwningNode(std::move(value), sourceOwner);
+	}
+	return std::make_shared<Node>(std::move(value));
+}
+
+/**
+ * Adds a container node to its parent (or makes it the root), and
+ * makes it the parent of the following nodes
+ */
+void Json::TreeBuilder::openNode(std::shared_ptr<Node> node)
+{
+	addChildNode(node);
+	hierarchy.push_back(node);
+}
+
+void Json::TreeBuilder::addChildNode(std::shared_ptr<Node> node)
+{
+	if (hierarchy.empty())
+	{
+		root = node;
+		return;
+	}
+
+	const auto& parent = hierarchy.back();
+	if (parent->getType() == Node::Type::List)
+	{
+		parent->addChild(node);
+	}
+	else
+	{
+		parent->addChild({ lastKey, node });
+	}
+}
@@ -0,0 +1,40 @@
+#include <utility>
+#include "headers/view_document.h"
+
+Json::ViewDocument::ViewDocument(std::unique_ptr<MappedFile> file) : storage(std::make_shared<Storage>())
+{
+	storage->input = std::string_view(file->getData(), file->getSize());
+	storage->file = std::move(file);
+}
+
+/**
+ * Takes ownership of the text, it is moved into the document before it
+ * is parsed so the views point to its final place
+ */
+Json::ViewDocument::ViewDocument(std::string text) : storage(std::make_shared<Storage>())
+{
+	storage->text = std::move(text);
+	storage->input = storage->text;
+}
+
+Json::ViewDocument::ViewDocument(std::string_view input) : storage(std::make_shared<Storage>())
+{
+	storage->input = input;
+}
+
+/**
+ * Returns the root node, which, like every node of the tree, keeps the
+ * input of the document alive as long as it is held
+ */
+std::shared_ptr<Json::Node> Json::ViewDocument::getRoot() const noexcept
+{
+	return root;
+}
+
+/**
+ * Returns the JSON text the strings of the document refer to
+ */
+std::string_view Json::ViewDocument::getInput() const noexcept
+{
+	return storage->input;
+}
@@ -0,0 +1,523 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include "headers/writer.h"
+#include "headers/document.h"
+#include "headers/tape.h"
+
+namespace
+{
+	const char hexDigits[] = "0123456789abcdef";
+
+	bool needsEscaping(char c) noexcept
+	{
+		return c == '"' || c == '\\' || (unsigned char)c < 0x20;
+	}
+
+	/**
+	 * Hands the string to put with quotes, backslashes and control
+	 * characters escaped; runs of characters that need no escaping are
+	 * passed on at once
+	 */
+	template <typename Put>
+	void putEscaped(std::string_view value, Put&& put)
+	{
+		const char* run = value.data();
+		const char* end = value.data() + value.size();
+
+		for (const char* p = run; p != end; p++)
+		{
+			if (!needsEscaping(*p))
+				continue;
+
+			put(run, p - run);
+			run = p + 1;
+
+			switch (*p)
+			{
+				case '"':
+					put("\\\"", 2);
+					break;
+				case '\\':
+					put("\\\\", 2);
+					break;
+				case '\b':
+					put("\\b", 2);
+					break;
+				case '\f':
+					put("\\f", 2);
+					break;
+				case '\n':
+					put("\\n", 2);
+					break;
+				case '\r':
+					put("\\r", 2);
+					break;
+				case '\t':
+					put("\\t", 2);
+					break;
+				default:
+				{
+					const char escape[] = { '\\', 'u', '0', '0', hexDigits[(*p >> 4) & 0xF], hexDigits[*p & 0xF] };
+					put(escape, sizeof(escape));
+					break;
+				}
+			}
+		}
+
+		put(run, end - run);
+	}
+}
+
+/**
+ * Creates a writer that writes into an output stream
+ *
+ * @param stream receives the text every time the internal buffer fills
+ * up, and when the writer is flushed or destroyed
+ * @param style whether to write the text compact or indented
+ */
+Json::Writer::Writer(std::ostream& stream, Style style)
+	: Writer(Sink([&stream](const char* data, std::size_t size) { stream.write(data, size); }), style)
+{
+}
+
+/**
+ * Creates a writer that appends to a string
+ */
+Json::Writer::Writer(std::string& output, Style style)
+	: Writer(Sink([&output](const char* data, std::size_t size) { output.append(data, size); }), style)
+{
+}
+
+/**
+ * Creates a writer that hands its output to a function in chunks
+ *
+ * @param sink called with consecutive pieces of the text
+ * @param style whether to write the text compact or indented
+ */
+Json::Writer::Writer(Sink sink, Style style) : sink(std::move(sink)), style(style)
+{
+	used = 0;
+	indentation = 0;
+	afterKey = false;
+}
+
+Json::Writer::~Writer()
+{
+	try
+	{
+		flush();
+	}
+	catch (...)
+	{
+	}
+}
+
+/**
+ * Hands the buffered text to the destination
+ */
+void Json::Writer::flush()
+{
+	if (used != 0)
+	{
+		sink(buffer.data(), used);
+		used = 0;
+	}
+}
+
+/**
+ * Returns the string with quotes, backslashes and control characters
+ * escaped, as it appears between the quotes of a JSON string
+ */
+std::string Json::Writer::escape(std::string_view value)
+{
+	std::string result;
+	result.reserve(value.size());
+	putEscaped(value, [&result](const char* data, std::size_t size) { result.append(data, size); });
+	return result;
+}
+
+/**
+ * Sets the nesting level that pretty output is indented from
+ */
+void Json::Writer::setIndentation(unsigned level) noexcept
+{
+	indentation = level;
+}
+
+/**
+ * Writes a whole node tree
+ *
+ * Numbers that were parsed lazily are written with their original text.
+ */
+void Json::Writer::write(const Node& node)
+{
+	switch (node.type)
+	{
+		case Node::Type::Boolean:
+			onValue(std::get<bool>(node.value));
+			break;
+		case Node::Type::Number:
+			if (std::holds_alternative<int>(node.value))
+				onValue(std::int64_t(std::get<int>(node.value)));
+			else if (std::holds_alternative<std::int64_t>(node.value))
+				onValue(std::get<std::int64_t>(node.value));
+			else if (std::holds_alternative<std::uint64_t>(node.value))
+				onValue(std::get<std::uint64_t>(node.value));
+			else if (std::holds_alternative<LazyNumber>(node.value))
+				onValue(std::get<LazyNumber>(node.value));
+			else
+				onValue(std::get<double>(node.value));
+			break;
+		case Node::Type::String:
+			onValue(std::string_view(node));
+			break;
+		case Node::Type::Null:
+			onValue(nullptr);
+			break;
+		case Node::Type::List:
+			onListOpen();
+			for (const auto& element : std::get<List>(node.value))
+			{
+				write(*element);
+			}
+			onListClose();
+			break;
+		case Node::Type::Object:
+			onObjectOpen();
+			for (const auto& [key, member] : std::get<Object>(node.value))
+			{
+				onKey(key);
+				write(*member);
+			}
+			onObjectClose();
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * Writes a value of an arena allocated document, with its members in the
+ * order they were parsed
+ */
+void Json::Writer::write(const Element& element)
+{
+	const auto* entry = element.entry;
+
+	switch (entry->type)
+	{
+		case Node::Type::Boolean:
+			onValue(entry->boolean);
+			break;
+		case Node::Type::Number:
+			if (!entry->isInteger)
+				onValue(entry->number);
+			else if (entry->isUnsigned)
+				onValue(entry->unsignedInteger);
+			else
+				onValue(entry->integer);
+			break;
+		case Node::Type::String:
+			onValue(std::string_view(entry->string, entry->size));
+			break;
+		case Node::Type::Null:
+			onValue(nullptr);
+			break;
+		case Node::Type::List:
+			onListOpen();
+			for (std::size_t i = 0; i < entry->size; i++)
+			{
+				write(Element(&entry->elements[i]));
+			}
+			onListClose();
+			break;
+		case Node::Type::Object:
+			onObjectOpen();
+			for (std::size_t i = 0; i < entry->size; i++)
+			{
+				onKey(entry->members[i].key);
+				write(Element(&entry->members[i].value));
+			}
+			onObjectClose();
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * Writes a value of a tape, walking its containers word by word
+ */
+void Json::Writer::write(const TapeElement& element)
+{
+	switch (element.getTag())
+	{
+		case 't':
+		case 'f':
+			onValue(element.getTag() == 't');
+			break;
+		case 'l':
+			onValue(std::int64_t(element));
+			break;
+		case 'u':
+			onValue(std::uint64_t(element));
+			break;
+		case 'd':
+			onValue(double(element));
+			break;
+		case '"':
+			onValue(element.getString());
+			break;
+		case 'n':
+			onValue(nullptr);
+			break;
+		case '[':
+		{
+			onListOpen();
+			const std::size_t end = element.getPayload() - 1;
+			for (std::size_t i = element.index + 1; i < end; i = element.withIndex(i).getNextIndex())
+			{
+				write(element.withIndex(i));
+			}
+			onListClose();
+			break;
+		}
+		case '{':
+		{
+			onObjectOpen();
+			const std::size_t end = element.getPayload() - 1;
+			for (std::size_t i = element.index + 1; i < end; i = element.withIndex(i + 1).getNextIndex())
+			{
+				onKey(element.withIndex(i).getString());
+				write(element.withIndex(i + 1));
+			}
+			onObjectClose();
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+void Json::Writer::onObjectOpen()
+{
+	openContainer('}');
+}
+
+void Json::Writer::onObjectClose()
+{
+	closeContainer('}');
+}
+
+void Json::Writer::onListOpen()
+{
+	openContainer(']');
+}
+
+void Json::Writer::onListClose()
+{
+	closeContainer(']');
+}
+
+void Json::Writer::onKey(std::string_view key)
+{
+	if (containers.empty() || containers.back().closingBracket != '}' || afterKey)
+	{
+		throw Exception("Wrote a key outside of an object");
+	}
+
+	putSeparator();
+	putString(key);
+	put(':');
+	if (style == Style::Pretty)
+		put(' ');
+	afterKey = true;
+}
+
+void Json::Writer::onValue(bool value)
+{
+	beginValue();
+	if (value)
+		put("true", 4);
+	else
+		put("false", 5);
+}
+
+void Json::Writer::onValue(std::int64_t value)
+{
+	beginValue();
+	char digits[24];
+	const char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+	put(digits, end - digits);
+}
+
+void Json::Writer::onValue(std::uint64_t value)
+{
+	beginValue();
+	char digits[24];
+	const char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+	put(digits, end - digits);
+}
+
+/**
+ * Writes the shortest text that reads back as the same double
+ *
+ * Integral values get a ".0" suffix so they are read back as doubles, and
+ * infinities and NaN, which JSON cannot represent, are written as null.
+ */
+void Json::Writer::onValue(double value)
+{
+	if (!std::isfinite(value))
+	{
+		onValue(nullptr);
+		return;
+	}
+
+	beginValue();
+	char digits[32];
+	const char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+	put(digits, end - digits);
+
+	if (std::string_view(digits, end - digits).find_first_of(".e") == std::string_view::npos)
+		put(".0", 2);
+}
+
+void Json::Writer::onValue(const LazyNumber& value)
+{
+	beginValue();
+	put(value.getText().data(), value.getText().size());
+}
+
+void Json::Writer::onValue(std::string_view value)
+{
+	beginValue();
+	putString(value);
+}
+
+void Json::Writer::onValue(std::nullptr_t)
+{
+	beginValue();
+	put("null", 4);
+}
+
+/**
+ * Makes room for size more characters, growing the buffer while it is
+ * smaller than bufferSize and flushing it once it has reached that size
+ */
+void Json::Writer::reserve(std::size_t size)
+{
+	if (used + size > bufferSize)
+	{
+		flush();
+	}
+	if (used + size > buffer.size())
+	{
+		std::size_t newSize = std::max(buffer.size() * 2, initialBufferSize);
+		while (newSize < used + size)
+			newSize *= 2;
+		buffer.resize(std::min(newSize, bufferSize));
+	}
+}
+
+void Json::Writer::put(char c)
+{
+	if (used == buffer.size())
+		reserve(1);
+	buffer[used++] = c;
+}
+
+void Json::Writer::put(const char* data, std::size_t size)
+{
+	if (size > buffer.size() - used)
+	{
+		if (size > bufferSize)
+		{
+			flush();
+			sink(data, size);
+			return;
+		}
+		reserve(size);
+	}
+	std::memcpy(buffer.data() + used, data, size);
+	used += size;
+}
+
+void Json::Writer::putIndentation()
+{
+	put('\n');
+	for (std::size_t i = 0; i < indentation + containers.size(); i++)
+		put("  ", 2);
+}
+
+/**
+ * Writes a quoted string, escaping quotes, backslashes and control
+ * characters
+ */
+void Json::Writer::putString(std::string_view value)
+{
+	put('"');
+	putEscaped(value, [this](const char* data, std::size_t size) { put(data, size); });
+	put('"');
+}
+
+/**
+ * Writes the separator and the indentation that go before an element of
+ * the current container
+ */
+void Json::Writer::putSeparator()
+{
+	if (containers.empty())
+		return;
+
+	if (!containers.back().isEmpty)
+		put(',');
+	containers.back().isEmpty = false;
+
+	if (style == Style::Pretty)
+		putIndentation();
+}
+
+/**
+ * Prepares a value: after a key it follows the key directly, inside a
+ * list it is separated from the previous element
+ */
+void Json::Writer::beginValue()
+{
+	if (afterKey)
+	{
+		afterKey = false;
+		return;
+	}
+
+	if (!containers.empty() && containers.back().closingBracket == '}')
+	{
+		throw Exception("Wrote a value without a key inside an object");
+	}
+
+	putSeparator();
+}
+
+void Json::Writer::openContainer(char closingBracket)
+{
+	beginValue();
+	put(closingBracket == '}' ? '{' : '[');
+	containers.push_back({ closingBracket, true });
+}
+
+void Json::Writer::closeContainer(char closingBracket)
+{
+	if (containers.empty() || containers.back().closingBracket != closingBracket || afterKey)
+	{
+		throw Exception(std::string("Found unexpected closing bracket ") + closingBracket);
+	}
+
+	const bool isEmpty = containers.back().isEmpty;
+	containers.pop_back();
+
+	if (style == Style::Pretty && !isEmpty)
+		putIndentation();
+	put(closingBracket);
+}
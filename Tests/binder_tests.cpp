@@ -0,0 +1,309 @@
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "headers/tests.h"
+#include "../JsonParser/headers/parser.h"
+
+namespace
+{
+	struct Item
+	{
+		int id = 0;
+		std::string name;
+	};
+
+	struct Optionals
+	{
+		std::optional<int> number = 3;
+		std::optional<std::string> text = std::string("kept");
+		std::optional<int> missing = 7;
+		std::vector<std::optional<int>> list;
+	};
+
+	struct Integers
+	{
+		std::uint8_t small = 0;
+		unsigned unsignedValue = 0;
+		std::int8_t signedSmall = 0;
+		std::int64_t large = 0;
+		std::uint64_t largeUnsigned = 0;
+	};
+
+	struct Scalars
+	{
+		bool flag = false;
+		int integer = 0;
+		std::int64_t large = 0;
+		std::uint64_t largeUnsigned = 0;
+		double real = 0;
+		std::string text;
+	};
+
+	struct Containers
+	{
+		std::vector<Item> items;
+		std::map<std::string, int> counts;
+		std::map<std::string, Item> byName;
+		std::vector<std::vector<int>> grid;
+	};
+
+	template <typename T>
+	T parseAs(const std::string& input)
+	{
+		Json::Parser parser;
+		return parser.parseAs<T>(input.data(), input.size());
+	}
+
+	/**
+	 * Returns true if binding the input to the type throws
+	 */
+	template <typename T>
+	bool isRejected(const std::string& input)
+	{
+		try
+		{
+			(void)parseAs<T>(input);
+		}
+		catch (const Tests::Failure&)
+		{
+			throw;
+		}
+		catch (const std::exception&)
+		{
+			return true;
+		}
+		return false;
+	}
+}
+
+template <>
+struct Json::Binding<Item>
+{
+	static constexpr auto fields = std::make_tuple(
+		Json::field("id", &Item::id),
+		Json::field("name", &Item::name));
+};
+
+template <>
+struct Json::Binding<Optionals>
+{
+	static constexpr auto fields = std::make_tuple(
+		Json::field("number", &Optionals::number),
+		Json::field("text", &Optionals::text),
+		Json::field("missing", &Optionals::missing),
+		Json::field("list", &Optionals::list));
+};
+
+template <>
+struct Json::Binding<Integers>
+{
+	static constexpr auto fields = std::make_tuple(
+		Json::field("small", &Integers::small),
+		Json::field("unsigned", &Integers::unsignedValue),
+		Json::field("signedSmall", &Integers::signedSmall),
+		Json::field("large", &Integers::large),
+		Json::field("largeUnsigned", &Integers::largeUnsigned));
+};
+
+template <>
+struct Json::Binding<Scalars>
+{
+	static constexpr auto fields = std::make_tuple(
+		Json::field("flag", &Scalars::flag),
+		Json::field("integer", &Scalars::integer),
+		Json::field("large", &Scalars::large),
+		Json::field("largeUnsigned", &Scalars::largeUnsigned),
+		Json::field("real", &Scalars::real),
+		Json::field("text", &Scalars::text));
+};
+
+template <>
+struct Json::Binding<Containers>
+{
+	static constexpr auto fields = std::make_tuple(
+		Json::field("items", &Containers::items),
+		Json::field("counts", &Containers::counts),
+		Json::field("byName", &Containers::byName),
+		Json::field("grid", &Containers::grid));
+};
+
+std::vector<Tests::Test> Tests::getBinderTests()
+{
+	std::vector<Test> tests;
+
+	// The values of unknown keys are skipped by depth, so nested containers
+	// under them must not close the containers of the bound type.
+	tests.push_back(Test{ "unknown-keys-with-nested-values", []
+	{
+		const Item item = parseAs<Item>(R"({
+			"before": {"id": 1, "name": "inner", "deeper": {"list": [1, {"id": 2}]}},
+			"id": 5,
+			"list": [[1, [2]], {"id": 3}, [], {}],
+			"name": "outer",
+			"after": [{"name": "x"}]
+		})");
+		TEST_CHECK(item.id == 5);
+		TEST_CHECK(item.name == "outer");
+
+		const Item last = parseAs<Item>(R"({"id": 6, "name": "n", "tail": {"a": [[{}]]}})");
+		TEST_CHECK(last.id == 6);
+		TEST_CHECK(last.name == "n");
+	} });
+
+	tests.push_back(Test{ "unknown-keys-in-elements", []
+	{
+		const std::vector<Item> items = parseAs<std::vector<Item>>(R"([{"x": {"id": 9}, "id": 1}, {"id": 2, "y": [{"id": 9}]}])");
+		TEST_CHECK(items.size() == 2);
+		TEST_CHECK(items[0].id == 1);
+		TEST_CHECK(items[1].id == 2);
+	} });
+
+	tests.push_back(Test{ "optional-null", []
+	{
+		const Optionals value = parseAs<Optionals>(R"({"number": null, "text": "set", "list": [1, null, 2]})");
+		TEST_CHECK(!value.number.has_value());
+		TEST_CHECK(value.text == std::string("set"));
+		TEST_CHECK(value.missing == 7);
+		TEST_CHECK(value.list.size() == 3);
+		TEST_CHECK(value.list[0] == 1);
+		TEST_CHECK(!value.list[1].has_value());
+		TEST_CHECK(value.list[2] == 2);
+
+		const Optionals filled = parseAs<Optionals>(R"({"number": 4, "text": null})");
+		TEST_CHECK(filled.number == 4);
+		TEST_CHECK(!filled.text.has_value());
+	} });
+
+	tests.push_back(Test{ "null-needs-optional", []
+	{
+		TEST_CHECK(isRejected<Item>(R"({"id": null})"));
+		TEST_CHECK(isRejected<Item>(R"({"name": null})"));
+		TEST_CHECK(isRejected<std::vector<int>>("[1, null]"));
+		TEST_CHECK(isRejected<std::vector<Item>>("[null]"));
+	} });
+
+	tests.push_back(Test{ "integer-ranges", []
+	{
+		TEST_CHECK(isRejected<Integers>(R"({"small": 300})"));
+		TEST_CHECK(isRejected<Integers>(R"({"small": 256})"));
+		TEST_CHECK(isRejected<Integers>(R"({"small": -1})"));
+		TEST_CHECK(isRejected<Integers>(R"({"unsigned": -1})"));
+		TEST_CHECK(isRejected<Integers>(R"({"unsigned": 4294967296})"));
+		TEST_CHECK(isRejected<Integers>(R"({"signedSmall": 128})"));
+		TEST_CHECK(isRejected<Integers>(R"({"signedSmall": -129})"));
+		TEST_CHECK(isRejected<Integers>(R"({"large": 9223372036854775808})"));
+		TEST_CHECK(isRejected<Integers>(R"({"largeUnsigned": -1})"));
+
+		const Integers limits = parseAs<Integers>(R"({
+			"small": 255, "unsigned": 4294967295, "signedSmall": -128,
+			"large": -9223372036854775808, "largeUnsigned": 18446744073709551615
+		})");
+		TEST_CHECK(limits.small == 255);
+		TEST_CHECK(limits.unsignedValue == 4294967295u);
+		TEST_CHECK(limits.signedSmall == -128);
+		TEST_CHECK(limits.large == INT64_MIN);
+		TEST_CHECK(limits.largeUnsigned == UINT64_MAX);
+	} });
+
+	tests.push_back(Test{ "type-mismatches", []
+	{
+		TEST_CHECK(isRejected<Item>(R"({"id": "5"})"));
+		TEST_CHECK(isRejected<Item>(R"({"id": 1.5})"));
+		TEST_CHECK(isRejected<Item>(R"({"id": true})"));
+		TEST_CHECK(isRejected<Item>(R"({"id": [5]})"));
+		TEST_CHECK(isRejected<Item>(R"({"id": {"value": 5}})"));
+		TEST_CHECK(isRejected<Item>(R"({"name": 5})"));
+		TEST_CHECK(isRejected<Item>(R"({"name": ["a"]})"));
+		TEST_CHECK(isRejected<Scalars>(R"({"flag": 1})"));
+		TEST_CHECK(isRejected<Scalars>(R"({"real": "1.5"})"));
+		TEST_CHECK(isRejected<Item>("[1, 2]"));
+		TEST_CHECK(isRejected<std::vector<int>>(R"({"a": 1})"));
+		TEST_CHECK(isRejected<Containers>(R"({"counts": [1]})"));
+		TEST_CHECK(isRejected<Containers>(R"({"items": {"id": 1}})"));
+		TEST_CHECK(isRejected<Containers>(R"({"grid": [1]})"));
+	} });
+
+	tests.push_back(Test{ "string-map", []
+	{
+		const Containers value = parseAs<Containers>(R"({
+			"counts": {"b": 2, "a": 1, "": 0},
+			"byName": {"ada": {"id": 1, "name": "Ada"}, "bob": {"id": 2, "other": [1]}}
+		})");
+		TEST_CHECK(value.counts.size() == 3);
+		TEST_CHECK(value.counts.at("a") == 1);
+		TEST_CHECK(value.counts.at("b") == 2);
+		TEST_CHECK(value.counts.at("") == 0);
+		TEST_CHECK(value.byName.size() == 2);
+		TEST_CHECK(value.byName.at("ada").id == 1);
+		TEST_CHECK(value.byName.at("ada").name == "Ada");
+		TEST_CHECK(value.byName.at("bob").id == 2);
+		TEST_CHECK(value.byName.at("bob").name.empty());
+
+		const std::map<std::string, std::vector<int>> root = parseAs<std::map<std::string, std::vector<int>>>(R"({"x": [1, 2], "y": []})");
+		TEST_CHECK(root.size() == 2);
+		TEST_CHECK(root.at("x") == std::vector<int>({ 1, 2 }));
+		TEST_CHECK(root.at("y").empty());
+	} });
+
+	tests.push_back(Test{ "vector-of-structs", []
+	{
+		const Containers value = parseAs<Containers>(R"({
+			"items": [{"id": 1, "name": "a"}, {"name": "b"}, {}],
+			"grid": [[1, 2], [], [3]]
+		})");
+		TEST_CHECK(value.items.size() == 3);
+		TEST_CHECK(value.items[0].id == 1);
+		TEST_CHECK(value.items[0].name == "a");
+		TEST_CHECK(value.items[1].id == 0);
+		TEST_CHECK(value.items[1].name == "b");
+		TEST_CHECK(value.items[2].name.empty());
+		TEST_CHECK(value.grid == std::vector<std::vector<int>>({ { 1, 2 }, {}, { 3 } }));
+
+		const std::vector<Item> root = parseAs<std::vector<Item>>(R"([{"id": 1}, {"id": 2}])");
+		TEST_CHECK(root.size() == 2);
+		TEST_CHECK(root[1].id == 2);
+	} });
+
+	// The binder reads the tokens of the same grammar as the tree, so every
+	// bound member has to equal the conversion of the node it came from.
+	tests.push_back(Test{ "parity-with-get-as", []
+	{
+		const std::string input = R"({
+			"flag": true, "integer": -42, "large": 9007199254740993,
+			"largeUnsigned": 18446744073709551615, "real": 0.1,
+			"text": "caf\u00e9 \"quoted\""
+		})";
+		const Scalars bound = parseAs<Scalars>(input);
+
+		Json::Parser parser;
+		const std::shared_ptr<Json::Node> root = parser.parseString(input);
+		TEST_CHECK(bound.flag == root->at("flag")->getAs<bool>());
+		TEST_CHECK(bound.integer == root->at("integer")->getAs<int>());
+		TEST_CHECK(bound.large == root->at("large")->getAs<std::int64_t>());
+		TEST_CHECK(bound.largeUnsigned == root->at("largeUnsigned")->getAs<std::uint64_t>());
+		TEST_CHECK(bound.real == root->at("real")->getAs<double>());
+		TEST_CHECK(bound.text == root->at("text")->getAs<std::string>());
+
+		const Json::Document document = parser.parseDocument(input.data(), input.size());
+		const Json::Element element = document.getRoot();
+		TEST_CHECK(bound.flag == element.at("flag").getAs<bool>());
+		TEST_CHECK(bound.integer == element.at("integer").getAs<int>());
+		TEST_CHECK(bound.large == element.at("large").getAs<std::int64_t>());
+		TEST_CHECK(bound.largeUnsigned == element.at("largeUnsigned").getAs<std::uint64_t>());
+		TEST_CHECK(bound.real == element.at("real").getAs<double>());
+		TEST_CHECK(bound.text == element.at("text").getAs<std::string>());
+	} });
+
+	tests.push_back(Test{ "invalid-json-is-rejected", []
+	{
+		TEST_CHECK(isRejected<Item>(R"({"id": 1,})"));
+		TEST_CHECK(isRejected<Item>(R"({"id": 1)"));
+		TEST_CHECK(isRejected<std::vector<int>>("[1 2]"));
+	} });
+
+	return tests;
+}
@@ -0,0 +1,181 @@
+#include <exception>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "headers/tests.h"
+#include "../JsonParser/headers/parser.h"
+
+namespace
+{
+	using ObjectStorage = Json::Document::ObjectStorage;
+
+	const ObjectStorage storages[] = { ObjectStorage::Flat, ObjectStorage::Hashed };
+
+	/**
+	 * Member counts around the size above which hashed objects get an
+	 * index
+	 */
+	const std::size_t memberCounts[] = { 0, 1, 7, 8, 9, 16, 17, 1000 };
+
+	std::string makeObject(std::size_t memberCount)
+	{
+		std::string object = "{";
+		for (std::size_t i = 0; i < memberCount; i++)
+		{
+			object += (i == 0 ? "\"key" : ", \"key") + std::to_string(i) + "\": " + std::to_string(i);
+		}
+		return object + "}";
+	}
+
+	Json::Document parse(const std::string& input, ObjectStorage storage)
+	{
+		Json::Parser parser;
+		return parser.parseDocument(input.data(), input.size(), storage);
+	}
+
+	template <typename Function>
+	bool throws(Function function)
+	{
+		try
+		{
+			function();
+		}
+		catch (const Tests::Failure&)
+		{
+			throw;
+		}
+		catch (const std::exception&)
+		{
+			return true;
+		}
+		return false;
+	}
+}
+
+std::vector<Tests::Test> Tests::getDocumentTests()
+{
+	std::vector<Test> tests;
+
+	tests.push_back(Test{ "lookups-by-name", []
+	{
+		for (ObjectStorage storage : storages)
+		{
+			for (std::size_t memberCount : memberCounts)
+			{
+				const Json::Document document = parse(makeObject(memberCount), storage);
+				const Json::Element root = document.getRoot();
+
+				for (std::size_t i = 0; i < memberCount; i++)
+				{
+					const std::string key = "key" + std::to_string(i);
+					TEST_CHECK(root.at(key).getAs<int>() == int(i));
+					TEST_CHECK(root[key.c_str()].getAs<int>() == int(i));
+				}
+
+				TEST_CHECK(throws([&] { root.at("missing"); }));
+				TEST_CHECK(throws([&] { root.at("key"); }));
+				TEST_CHECK(throws([&] { root.at(""); }));
+				TEST_CHECK(throws([&] { root.at("key" + std::to_string(memberCount)); }));
+			}
+		}
+	} });
+
+	tests.push_back(Test{ "lookups-by-interned-key", []
+	{
+		for (ObjectStorage storage : storages)
+		{
+			for (std::size_t memberCount : memberCounts)
+			{
+				const Json::Document document = parse(makeObject(memberCount), storage);
+				const Json::Element root = document.getRoot();
+
+				for (std::size_t i = 0; i < memberCount; i++)
+				{
+					const Json::Key key = document.intern("key" + std::to_string(i));
+					TEST_CHECK(key.isValid());
+					TEST_CHECK(key.getName() == "key" + std::to_string(i));
+					TEST_CHECK(key.getHash() == Json::Key::hash(key.getName()));
+					TEST_CHECK(root.at(key).getAs<int>() == int(i));
+				}
+
+				const Json::Key missing = document.intern("missing");
+				TEST_CHECK(!missing.isValid());
+				TEST_CHECK(throws([&] { root.at(missing); }));
+				TEST_CHECK(throws([&] { root.at(Json::Key()); }));
+			}
+		}
+	} });
+
+	// Every occurrence of a key shares one copy, so an interned key finds
+	// the member in every object of the document by its address alone.
+	tests.push_back(Test{ "keys-are-shared", []
+	{
+		std::string input = "[";
+		for (std::size_t i = 0; i < 20; i++)
+		{
+			input += (i == 0 ? "" : ", ") + makeObject(i % 2 == 0 ? 3 : 12);
+		}
+		input += "]";
+
+		for (ObjectStorage storage : storages)
+		{
+			const Json::Document document = parse(input, storage);
+			const Json::Key key = document.intern("key2");
+			TEST_CHECK(key.isValid());
+
+			for (unsigned i = 0; i < 20; i++)
+			{
+				TEST_CHECK(document.getRoot().at(i).at(key).getAs<int>() == 2);
+			}
+
+			TEST_CHECK(document.intern("key2").getName().data() == key.getName().data());
+			TEST_CHECK(document.intern("key11").isValid());
+			TEST_CHECK(!document.intern("key12").isValid());
+		}
+	} });
+
+	tests.push_back(Test{ "key-of-other-document", []
+	{
+		for (ObjectStorage storage : storages)
+		{
+			const Json::Document first = parse(makeObject(12), storage);
+			const Json::Document second = parse(makeObject(12), storage);
+			const Json::Key key = first.intern("key5");
+
+			TEST_CHECK(first.getRoot().at(key).getAs<int>() == 5);
+			TEST_CHECK(throws([&] { second.getRoot().at(key); }));
+			TEST_CHECK(second.getRoot().at(key.getName()).getAs<int>() == 5);
+		}
+	} });
+
+	tests.push_back(Test{ "empty-strings-and-keys", []
+	{
+		for (ObjectStorage storage : storages)
+		{
+			const Json::Document document = parse(R"({"": "", "a": ["", "b", ""], "c": {"": 1}})", storage);
+			const Json::Element root = document.getRoot();
+
+			TEST_CHECK(root.at("").getAs<std::string_view>().empty());
+			TEST_CHECK(root.at("a").at(0).getAs<std::string>().empty());
+			TEST_CHECK(root.at("a").at(1).getAs<std::string>() == "b");
+			TEST_CHECK(root.at("c").at("").getAs<int>() == 1);
+			TEST_CHECK(document.intern("").isValid());
+			TEST_CHECK(root.at(document.intern("")).getType() == Json::Node::Type::String);
+		}
+	} });
+
+	tests.push_back(Test{ "storages-agree", []
+	{
+		const std::string input = R"({"users": [)" + makeObject(30) + ", " + makeObject(2) + R"(], "title": "storage", "nested": {"a": {"b": [1, 2.5, true, null]}}})";
+		const Json::Document flat = parse(input, ObjectStorage::Flat);
+		const Json::Document hashed = parse(input, ObjectStorage::Hashed);
+
+		TEST_CHECK(flat.getRoot().toString() == hashed.getRoot().toString());
+		TEST_CHECK(flat.getRoot().at("users").at(0).at("key29").getAs<int>() == 29);
+		TEST_CHECK(hashed.getRoot().at("users").at(0).at("key29").getAs<int>() == 29);
+		TEST_CHECK(hashed.getRoot().at("nested").at("a").at("b").at(1).getAs<double>() == 2.5);
+		TEST_CHECK(hashed.getAllocatedBytes() >= flat.getAllocatedBytes());
+	} });
+
+	return tests;
+}
@@ -0,0 +1,54 @@
+#ifndef TESTS_TESTS_H
+#define TESTS_TESTS_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <exception>
+
+namespace Tests
+{
+	/**
+	 * One named check of the library, it fails by throwing
+	 */
+	struct Test
+	{
+		std::string name;
+		std::function<void()> run;
+	};
+
+	class Failure : public std::exception
+	{
+	private:
+		std::string whatBuffer;
+
+	public:
+		Failure(std::string description) : whatBuffer(std::move(description))
+		{
+		}
+		const char* what() const noexcept override
+		{
+			return whatBuffer.c_str();
+		}
+	};
+
+	void check(bool condition, const char* expression, const char* file, int line);
+
+	std::vector<Test> getBinderTests();
+	std::vector<Test> getDocumentTests();
+	std::vector<Test> getLazyDocumentTests();
+	std::vector<Test> getNumberConversionTests();
+	std::vector<Test> getParseLinesTests();
+	std::vector<Test> getParseParallelTests();
+	std::vector<Test> getPathTests();
+	std::vector<Test> getPushParserTests();
+	std::vector<Test> getSnapshotTests();
+	std::vector<Test> getStringScannerTests();
+	std::vector<Test> getTapeTests();
+	std::vector<Test> getViewDocumentTests();
+	std::vector<Test> getWriterTests();
+}
+
+#define TEST_CHECK(condition) Tests::check((condition), #condition, __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,122 @@
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+#include "headers/tests.h"
+#include "../JsonParser/headers/parser.h"
+
+namespace
+{
+	Json::LazyDocument parseLazy(const std::string& text)
+	{
+		Json::Parser parser;
+		return parser.parseLazy(text.data(), text.size());
+	}
+
+	/**
+	 * Returns the message of the exception the function throws, or an empty
+	 * string if it throws none
+	 */
+	template <typename Function>
+	std::string getError(Function function)
+	{
+		try
+		{
+			function();
+		}
+		catch (const Tests::Failure&)
+		{
+			throw;
+		}
+		catch (const std::exception& exception)
+		{
+			return exception.what();
+		}
+		return "";
+	}
+
+	bool isRootError(const std::string& error)
+	{
+		return error.find("Expected an object or a list at the root") != std::string::npos;
+	}
+
+	/**
+	 * Checks that the lazy document reads the same value as the parser
+	 */
+	void checkSameAsParser(const std::string& text)
+	{
+		Json::Parser parser;
+		TEST_CHECK(parseLazy(text).getRoot().materialize()->toString() == parser.parseString(text)->toString());
+	}
+}
+
+std::vector<Tests::Test> Tests::getLazyDocumentTests()
+{
+	std::vector<Test> tests;
+
+	// Like the parser, the document only accepts an object or a list at the
+	// root, or no value at all.
+	tests.push_back(Test{ "rejects-scalar-root", []
+	{
+		const std::string inputs[] = { "1", "-2.5", "\"text\"", "true", "false", "null", " 7 " };
+		for (const std::string& input : inputs)
+		{
+			Json::Parser parser;
+			TEST_CHECK(isRootError(getError([&] { parseLazy(input); })));
+			TEST_CHECK(isRootError(getError([&] { parser.parseString(input); })));
+		}
+
+		TEST_CHECK(getError([] { parseLazy(""); }).empty());
+		TEST_CHECK(getError([] { parseLazy("{}"); }).empty());
+		TEST_CHECK(getError([] { parseLazy(" [] "); }).empty());
+		TEST_CHECK(!getError([] { parseLazy("[] 1"); }).empty());
+		TEST_CHECK(!getError([] { parseLazy("{} {}"); }).empty());
+	} });
+
+	// Everything an access passes over is skipped by its matched brackets,
+	// so the siblings after nested containers are found at the right
+	// entries.
+	tests.push_back(Test{ "skips-nested-siblings", []
+	{
+		const std::string text = R"({"a": [[1, [2]], {"b": {"c": [3]}}, []], "d": {"e": [], "f": {}}, "g": 4})";
+		const Json::LazyDocument document = parseLazy(text);
+		const Json::LazyElement root = document.getRoot();
+
+		TEST_CHECK(root.at("g").getAs<int>() == 4);
+		TEST_CHECK(root.at("d").at("f").getType() == Json::Node::Type::Object);
+		TEST_CHECK(root.at("a").at(0).at(1).at(0).getAs<int>() == 2);
+		TEST_CHECK(root.at("a").at(1).at("b").at("c").at(0).getAs<int>() == 3);
+		TEST_CHECK(root.at("a").at(2).getType() == Json::Node::Type::List);
+		TEST_CHECK(!getError([&] { root.at("a").at(3); }).empty());
+		TEST_CHECK(!getError([&] { root.at("b"); }).empty());
+
+		const std::string list = "[[[]], {\"x\": [1, 2]}, [3, [4]], 5]";
+		const Json::LazyDocument listDocument = parseLazy(list);
+		TEST_CHECK(listDocument.getRoot().at(3).getAs<int>() == 5);
+		TEST_CHECK(listDocument.getRoot().at(2).at(1).at(0).getAs<int>() == 4);
+
+		checkSameAsParser(text);
+		checkSameAsParser(list);
+	} });
+
+	// Brackets and quotes inside strings are not structural, so they are
+	// neither matched nor skipped over.
+	tests.push_back(Test{ "skips-brackets-in-strings", []
+	{
+		const std::string text = R"({"a": "x\"]}", "b": [[1], {"c": "]"}], "d": 2, "e\"}": "[{", "f": ["\\", "[\"", 3]})";
+		const Json::LazyDocument document = parseLazy(text);
+		const Json::LazyElement root = document.getRoot();
+
+		TEST_CHECK(root.at("a").getAs<std::string>() == "x\"]}");
+		TEST_CHECK(root.at("b").at(1).at("c").getAs<std::string>() == "]");
+		TEST_CHECK(root.at("d").getAs<int>() == 2);
+		TEST_CHECK(root.at("e\"}").getAs<std::string>() == "[{");
+		TEST_CHECK(root.at("f").at(0).getAs<std::string>() == "\\");
+		TEST_CHECK(root.at("f").at(1).getAs<std::string>() == "[\"");
+		TEST_CHECK(root.at("f").at(2).getAs<int>() == 3);
+
+		checkSameAsParser(text);
+	} });
+
+	return tests;
+}
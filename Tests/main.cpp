@@ -0,0 +1,92 @@
+/**
+ * Runs the tests of the library
+ *
+ * Usage: Tests [--filter=<text>]
+ *
+ * Every test whose "group/test" name contains the filter text is run, and
+ * the failures are printed to the standard error. The exit code is 1 if
+ * any of them failed.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "headers/tests.h"
+
+void Tests::check(bool condition, const char* expression, const char* file, int line)
+{
+	if (!condition)
+	{
+		throw Failure(std::string(file) + ":" + std::to_string(line) + ": " + expression);
+	}
+}
+
+namespace
+{
+	struct Group
+	{
+		std::string name;
+		std::vector<Tests::Test> tests;
+	};
+}
+
+int main(int argc, char* argv[])
+{
+	std::string filter;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+		if (argument.compare(0, 9, "--filter=") == 0)
+		{
+			filter = argument.substr(9);
+		}
+		else
+		{
+			std::cerr << "Unknown argument: " << argument << std::endl;
+			return 1;
+		}
+	}
+
+	const std::vector<Group> groups = {
+		{ "binder", Tests::getBinderTests() },
+		{ "document", Tests::getDocumentTests() },
+		{ "lazy-document", Tests::getLazyDocumentTests() },
+		{ "number-conversion", Tests::getNumberConversionTests() },
+		{ "parse-lines", Tests::getParseLinesTests() },
+		{ "parse-parallel", Tests::getParseParallelTests() },
+		{ "path", Tests::getPathTests() },
+		{ "push-parser", Tests::getPushParserTests() },
+		{ "snapshot", Tests::getSnapshotTests() },
+		{ "string-scanner", Tests::getStringScannerTests() },
+		{ "tape", Tests::getTapeTests() },
+		{ "view-document", Tests::getViewDocumentTests() },
+		{ "writer", Tests::getWriterTests() }
+	};
+
+	unsigned passed = 0;
+	unsigned failed = 0;
+
+	for (const Group& group : groups)
+	{
+		for (const Tests::Test& test : group.tests)
+		{
+			const std::string name = group.name + "/" + test.name;
+			if (name.find(filter) == std::string::npos)
+				continue;
+
+			try
+			{
+				test.run();
+				passed++;
+			}
+			catch (const std::exception& exception)
+			{
+				std::cerr << "FAILED " << name << ": " << exception.what() << std::endl;
+				failed++;
+			}
+		}
+	}
+
+	std::cerr << passed << " passed, " << failed << " failed" << std::endl;
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+#include "headers/tests.h"
+#include "../JsonParser/headers/parser.h"
+#include "../JsonParser/headers/path.h"
+#include "../JsonParser/headers/writer.h"
+
+namespace
+{
+	const std::string input = "[1e300, -1e300, -5.5, 2.9]";
+
+	const Json::Node& element(const std::shared_ptr<Json::Node>& node)
+	{
+		return *node;
+	}
+
+	template <typename Element>
+	const Element& element(const Element& value)
+	{
+		return value;
+	}
+
+	template <typename Target, typename Element>
+	bool throwsConverting(const Element& value)
+	{
+		try
+		{
+			(void)Target(value);
+		}
+		catch (const Tests::Failure&)
+		{
+			throw;
+		}
+		catch (const std::exception&)
+		{
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Returns the message of the exception the function throws, or an
+	 * empty string if it does not throw
+	 */
+	template <typename Function>
+	std::string getError(Function function)
+	{
+		try
+		{
+			function();
+		}
+		catch (const Tests::Failure&)
+		{
+			throw;
+		}
+		catch (const std::exception& exception)
+		{
+			return exception.what();
+		}
+		return "";
+	}
+
+	bool isOutOfRangeError(const std::string& error)
+	{
+		return error.find("out of the range of double") != std::string::npos;
+	}
+
+	/**
+	 * Checks the integer conversions of the doubles of the input, which
+	 * every representation has to truncate or reject the same way
+	 */
+	template <typename Root>
+	void checkDoubles(const Root& root)
+	{
+		for (unsigned i = 0; i < 2; i++)
+		{
+			TEST_CHECK(throwsConverting<int>(element(root.at(i))));
+			TEST_CHECK(throwsConverting<std::int64_t>(element(root.at(i))));
+			TEST_CHECK(throwsConverting<std::uint64_t>(element(root.at(i))));
+		}
+
+		TEST_CHECK(int(element(root.at(2))) == -5);
+		TEST_CHECK(std::int64_t(element(root.at(2))) == -5);
+		TEST_CHECK(throwsConverting<std::uint64_t>(element(root.at(2))));
+
+		TEST_CHECK(int(element(root.at(3))) == 2);
+		TEST_CHECK(std::int64_t(element(root.at(3))) == 2);
+		TEST_CHECK(std::uint64_t(element(root.at(3))) == 2);
+	}
+}
+
+std::vector<Tests::Test> Tests::getNumberConversionTests()
+{
+	std::vector<Test> tests;
+
+	tests.push_back(Test{ "node", []
+	{
+		Json::Parser parser;
+		checkDoubles(*parser.parseString(input));
+	} });
+
+	tests.push_back(Test{ "lazy-node", []
+	{
+		Json::Parser parser;
+		checkDoubles(*parser.parseString(input, Json::Parser::NumberConversion::Lazy));
+	} });
+
+	tests.push_back(Test{ "document", []
+	{
+		Json::Parser parser;
+		const Json::Document document = parser.parseDocument(input.data(), input.size());
+		checkDoubles(document.getRoot());
+	} });
+
+	tests.push_back(Test{ "tape", []
+	{
+		Json::Parser parser;
+		const Json::Tape tape = parser.parseTape(input.data(), input.size());
+		checkDoubles(tape.getRoot());
+	} });
+
+	tests.push_back(Test{ "lazy-document", []
+	{
+		Json::Parser parser;
+		const Json::LazyDocument document = parser.parseLazy(input.data(), input.size());
+		checkDoubles(document.getRoot());
+	} });
+
+	tests.push_back(Test{ "underflow-decodes-to-zero", []
+	{
+		Json::Parser parser;
+		const std::shared_ptr<Json::Node> root = parser.parseString("[1e-400, -1e-400, 0.0000001e-330, 1e-310]");
+		const double positive = *root->at(0);
+		const double negative = *root->at(1);
+		TEST_CHECK(positive == 0 && !std::signbit(positive));
+		TEST_CHECK(negative == 0 && std::signbit(negative));
+		TEST_CHECK(double(*root->at(2)) == 0);
+		TEST_CHECK(double(*root->at(3)) == 1e-310);
+
+		const std::shared_ptr<Json::Node> lazy = parser.parseString("[1e-400]", Json::Parser::NumberConversion::Lazy);
+		TEST_CHECK(double(*lazy->at(0)) == 0);
+	} });
+
+	tests.push_back(Test{ "overflow-is-out-of-range", []
+	{
+		Json::Parser parser;
+		TEST_CHECK(isOutOfRangeError(getError([&] { parser.parseString("[1e400]"); })));
+		TEST_CHECK(isOutOfRangeError(getError([&] { parser.parseString("[-1e400]"); })));
+		TEST_CHECK(isOutOfRangeError(getError([&] { parser.parseString("[1000000000000000000000e-5, 100000000000000000000000000000000000000000000e300]"); })));
+
+		const std::shared_ptr<Json::Node> lazy = parser.parseString("[1e400]", Json::Parser::NumberConversion::Lazy);
+		TEST_CHECK(lazy->at(0)->toString() == "1e400");
+		TEST_CHECK(isOutOfRangeError(getError([&] { (void)double(*lazy->at(0)); })));
+
+		const std::string text = "[1e400]";
+		const Json::LazyDocument document = parser.parseLazy(text.data(), text.size());
+		TEST_CHECK(isOutOfRangeError(getError([&] { (void)double(document.getRoot().at(0)); })));
+
+		TEST_CHECK(isOutOfRangeError(getError([] { Json::Path path("$[?(@.id == 1e400)]"); })));
+	} });
+
+	tests.push_back(Test{ "negative-zero", []
+	{
+		Json::Parser parser;
+		const std::shared_ptr<Json::Node> root = parser.parseString("[-0, 0, -0.0]");
+		TEST_CHECK(std::holds_alternative<double>(root->at(0)->getRawValue()));
+		TEST_CHECK(std::signbit(double(*root->at(0))));
+		TEST_CHECK(std::holds_alternative<int>(root->at(1)->getRawValue()));
+		TEST_CHECK(std::signbit(double(*root->at(2))));
+
+		std::string output;
+		{
+			Json::Writer writer(output);
+			writer.write(*root);
+		}
+		TEST_CHECK(output == "[-0.0,0,-0.0]");
+	} });
+
+	return tests;
+}
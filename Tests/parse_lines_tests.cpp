@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "headers/tests.h"
+#include "../JsonParser/headers/parser.h"
+
+namespace
+{
+	using LineOrder = Json::Parser::LineOrder;
+
+	/**
+	 * Enough lines for several of the 1 MB chunks the input is cut into
+	 */
+	const int lineCount = 50000;
+
+	const unsigned threadCounts[] = { 1, 2, 4 };
+
+	std::string makeLine(int number)
+	{
+		return R"({"line": )" + std::to_string(number) + R"(, "text": "[{,\"]}"})" + std::string(number % 40, ' ') + "\n";
+	}
+
+	std::string makeInput()
+	{
+		std::string input;
+		for (int i = 0; i < lineCount; i++)
+		{
+			input += makeLine(i);
+		}
+		return input;
+	}
+
+	/**
+	 * Parses the input and returns the "line" member of every document, in
+	 * the order they were reported
+	 *
+	 * @param error receives the message of the exception, if one is thrown
+	 */
+	std::vector<int> parseLines(const std::string& input, LineOrder order, unsigned threadCount, std::string* error = nullptr)
+	{
+		std::vector<int> lines;
+		Json::Parser parser;
+
+		try
+		{
+			parser.parseLines(input.data(), input.size(), [&lines](std::shared_ptr<Json::Node> document)
+			{
+				lines.push_back(int(*document->at("line")));
+			}, order, threadCount);
+		}
+		catch (const Tests::Failure&)
+		{
+			throw;
+		}
+		catch (const std::exception& exception)
+		{
+			if (error == nullptr)
+				throw;
+			*error = exception.what();
+		}
+
+		return lines;
+	}
+
+	std::vector<int> getRange(int begin, int end)
+	{
+		std::vector<int> range;
+		for (int i = begin; i < end; i++)
+		{
+			range.push_back(i);
+		}
+		return range;
+	}
+}
+
+std::vector<Tests::Test> Tests::getParseLinesTests()
+{
+	std::vector<Test> tests;
+
+	tests.push_back(Test{ "ordered-delivery", []
+	{
+		const std::string input = makeInput();
+		TEST_CHECK(input.size() > 2 * (1 << 20));
+
+		for (unsigned threadCount : threadCounts)
+		{
+			TEST_CHECK(parseLines(input, LineOrder::Ordered, threadCount) == getRange(0, lineCount));
+		}
+	} });
+
+	tests.push_back(Test{ "unordered-completeness", []
+	{
+		const std::string input = makeInput();
+
+		for (unsigned threadCount : threadCounts)
+		{
+			std::vector<int> lines = parseLines(input, LineOrder::Unordered, threadCount);
+			std::sort(lines.begin(), lines.end());
+			TEST_CHECK(lines == getRange(0, lineCount));
+		}
+	} });
+
+	tests.push_back(Test{ "input-without-final-newline", []
+	{
+		std::string input = makeInput();
+		input.pop_back();
+
+		TEST_CHECK(parseLines(input, LineOrder::Ordered, 2) == getRange(0, lineCount));
+	} });
+
+	// The error is reported with the byte offset of its line in the whole
+	// input, after every document of the lines before it in ordered mode.
+	tests.push_back(Test{ "error-has-byte-offset", []
+	{
+		const int badLines[] = { 0, 17, lineCount - 100 };
+
+		for (int badLine : badLines)
+		{
+			std::string input;
+			std::size_t offset = 0;
+			for (int i = 0; i < lineCount; i++)
+			{
+				if (i == badLine)
+				{
+					offset = input.size();
+					input += "{\"line\": " + std::to_string(i) + ", }\n";
+				}
+				else
+				{
+					input += makeLine(i);
+				}
+			}
+
+			for (unsigned threadCount : threadCounts)
+			{
+				std::string error;
+				TEST_CHECK(parseLines(input, LineOrder::Ordered, threadCount, &error) == getRange(0, badLine));
+				TEST_CHECK(error.find("at byte " + std::to_string(offset) + ":") != std::string::npos);
+
+				error.clear();
+				const std::vector<int> lines = parseLines(input, LineOrder::Unordered, threadCount, &error);
+				TEST_CHECK(error.find("at byte " + std::to_string(offset) + ":") != std::string::npos);
+				TEST_CHECK(std::find(lines.begin(), lines.end(), badLine) == lines.end());
+			}
+		}
+	} });
+
+	tests.push_back(Test{ "blank-and-scalar-lines", []
+	{
+		const std::string input = "1\n\n   \n\t\r\n\"text\"\r\ntrue\nnull\n-2.5\n[1, [2]]\n{}\n\n";
+		std::vector<std::shared_ptr<Json::Node>> documents;
+
+		Json::Parser parser;
+		parser.parseLines(input.data(), input.size(), [&documents](std::shared_ptr<Json::Node> document)
+		{
+			documents.push_back(document);
+		});
+
+		TEST_CHECK(documents.size() == 7);
+		TEST_CHECK(int(*documents[0]) == 1);
+		TEST_CHECK(std::string_view(*documents[1]) == "text");
+		TEST_CHECK(bool(*documents[2]));
+		TEST_CHECK(documents[3]->getType() == Json::Node::Type::Null);
+		TEST_CHECK(double(*documents[4]) == -2.5);
+		TEST_CHECK(documents[5]->size() == 2);
+		TEST_CHECK(documents[6]->getType() == Json::Node::Type::Object);
+	} });
+
+	tests.push_back(Test{ "empty-input", []
+	{
+		std::size_t count = 0;
+		Json::Parser parser;
+		parser.parseLines("", 0, [&count](std::shared_ptr<Json::Node>) { count++; });
+		parser.parseLines("\n\n \n", 4, [&count](std::shared_ptr<Json::Node>) { count++; }, LineOrder::Unordered);
+		TEST_CHECK(count == 0);
+	} });
+
+	return tests;
+}
@@ -0,0 +1,209 @@
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+#include "headers/tests.h"
+#include "../JsonParser/headers/parser.h"
+#include "../JsonParser/headers/writer.h"
+
+namespace
+{
+	/**
+	 * The size of the ranges the root list is split into
+	 */
+	const std::size_t rangeSize = 1 << 20;
+
+	const unsigned threadCounts[] = { 1, 2, 4 };
+
+	/**
+	 * Returns an element whose strings hold the characters the splitter
+	 * must not cut at, with escaped quotes and backslashes in front of them
+	 */
+	std::string makeElement(std::size_t number)
+	{
+		switch (number % 6)
+		{
+			case 0:
+				return R"("a,]{\"b\",}[ \\\",")";
+			case 1:
+				return "[" + std::to_string(number) + R"(, [",", "]"], {"k": "{,"}])";
+			case 2:
+				return R"({"id": )" + std::to_string(number) + R"(, "text": "\\\"],{"})";
+			case 3:
+				return std::to_string(number) + ".5";
+			case 4:
+				return R"([[[]], [{}], "\\", [[",]"]]])";
+			default:
+				return R"("], \" , ] } { [ \\")";
+		}
+	}
+
+	/**
+	 * Builds a root list of at least the given size, with a string of the
+	 * given length first, so the range boundaries fall into other parts of
+	 * the elements
+	 */
+	std::string makeList(std::size_t size, std::size_t shift)
+	{
+		std::string list = "[\"" + std::string(shift, 'x') + "\"";
+		for (std::size_t i = 0; list.size() < size; i++)
+		{
+			list += i % 3 == 0 ? ",\n  " : ", ";
+			list += makeElement(i);
+		}
+		return list + "]";
+	}
+
+	std::string write(const Json::Node& node)
+	{
+		std::string output;
+		Json::Writer writer(output);
+		writer.write(node);
+		writer.flush();
+		return output;
+	}
+
+	void checkSameAsParse(const std::string& input, unsigned threadCount)
+	{
+		Json::Parser parser;
+		const std::string expected = write(*parser.parse(input.data(), input.size()));
+		TEST_CHECK(write(*parser.parseParallel(input.data(), input.size(), threadCount)) == expected);
+	}
+
+	/**
+	 * Returns the message of the exception parsing the input in parallel
+	 * throws, or an empty string if it does not throw
+	 */
+	std::string getParallelError(const std::string& input)
+	{
+		try
+		{
+			Json::Parser parser;
+			parser.parseParallel(input.data(), input.size(), 2);
+		}
+		catch (const Tests::Failure&)
+		{
+			throw;
+		}
+		catch (const std::exception& exception)
+		{
+			return exception.what();
+		}
+		return "";
+	}
+
+	bool isRejectedByParse(const std::string& input)
+	{
+		try
+		{
+			Json::Parser parser;
+			parser.parse(input.data(), input.size());
+		}
+		catch (const std::exception&)
+		{
+			return true;
+		}
+		return false;
+	}
+}
+
+std::vector<Tests::Test> Tests::getParseParallelTests()
+{
+	std::vector<Test> tests;
+
+	tests.push_back(Test{ "same-as-parse", []
+	{
+		const std::string input = makeList(2 * rangeSize + rangeSize / 2, 0);
+		for (unsigned threadCount : threadCounts)
+		{
+			checkSameAsParse(input, threadCount);
+		}
+	} });
+
+	// Shifting the elements moves the range boundaries through every part
+	// of them, the strings with brackets, commas and escaped quotes
+	// included.
+	tests.push_back(Test{ "shifted-boundaries", []
+	{
+		for (std::size_t shift = 0; shift < 48; shift += 7)
+		{
+			checkSameAsParse(makeList(rangeSize + 4096, shift), 2);
+		}
+	} });
+
+	tests.push_back(Test{ "string-across-boundary", []
+	{
+		std::string text;
+		while (text.size() < rangeSize + rangeSize / 2)
+		{
+			text += R"(, ] } { [ \" \\ )";
+		}
+		checkSameAsParse("[1, \"" + text + "\", 2, \"" + text + "\", 3]", 2);
+	} });
+
+	tests.push_back(Test{ "nested-list-across-boundary", []
+	{
+		std::string nested = "[0";
+		for (std::size_t i = 1; nested.size() < rangeSize + rangeSize / 8; i++)
+		{
+			nested += i % 100 == 0 ? ", [\"],\", {\"a\": [" + std::to_string(i) + "]}]" : ", " + std::to_string(i);
+		}
+		nested += "]";
+
+		checkSameAsParse("[" + nested + ", {\"last\": " + nested + "}]", 2);
+	} });
+
+	tests.push_back(Test{ "small-list-and-other-roots", []
+	{
+		checkSameAsParse("[]", 2);
+		checkSameAsParse(" [1, \"two\", [3]] \n", 2);
+		checkSameAsParse(makeList(rangeSize / 2, 0), 2);
+		checkSameAsParse("{\"list\": " + makeList(rangeSize + 100, 0) + "}", 2);
+	} });
+
+	tests.push_back(Test{ "error-in-late-range", []
+	{
+		const std::string valid = makeList(3 * rangeSize, 0);
+		const std::string input = valid.substr(0, valid.size() - 1) + R"(, {"a" 1}, 2])";
+		TEST_CHECK(isRejectedByParse(input));
+
+		const std::string error = getParallelError(input);
+		const std::string prefix = "starting at byte ";
+		const std::size_t position = error.find(prefix);
+		TEST_CHECK(position != std::string::npos);
+		TEST_CHECK(std::stoull(error.substr(position + prefix.size())) >= 2 * rangeSize);
+	} });
+
+	// An empty element right after the comma the list is split at must be
+	// found by the range that starts there.
+	tests.push_back(Test{ "empty-element-at-boundary", []
+	{
+		std::string list = "[";
+		while (list.size() < rangeSize + 16)
+		{
+			list += "1,";
+		}
+		list += "1]";
+
+		for (std::size_t position = rangeSize - 2; position <= rangeSize + 4; position += 2)
+		{
+			const std::string input = list.substr(0, position) + "," + list.substr(position);
+			TEST_CHECK(!getParallelError(input).empty());
+		}
+		TEST_CHECK(isRejectedByParse(list.substr(0, rangeSize) + "," + list.substr(rangeSize)));
+
+		TEST_CHECK(!getParallelError(makeList(rangeSize + 100, 0) + "]").empty());
+		const std::string trailing = makeList(rangeSize + 100, 0);
+		TEST_CHECK(!getParallelError(trailing.substr(0, trailing.size() - 1) + ",]").empty());
+	} });
+
+	tests.push_back(Test{ "unbalanced-late-range", []
+	{
+		const std::string valid = makeList(2 * rangeSize, 0);
+		TEST_CHECK(!getParallelError(valid.substr(0, valid.size() - 1) + ", [1}]").empty());
+		TEST_CHECK(!getParallelError(valid.substr(0, valid.size() - 1) + ", \"open]").empty());
+		TEST_CHECK(!getParallelError(valid.substr(0, valid.size() - 1)).empty());
+	} });
+
+	return tests;
+}
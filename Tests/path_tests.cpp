@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <vector>
+#include "headers/tests.h"
+#include "../JsonParser/headers/parser.h"
+#include "../JsonParser/headers/path.h"
+#include "../JsonParser/headers/writer.h"
+
+namespace
+{
+	const std::string input = R"({
+		"a/b": 1, "m~n": 2, "~1": 3, "": 4, "01": 5, "0": 6, "it's": 7,
+		"list": [10, 11, [12]],
+		"object": {"x": 1, "y": 2},
+		"users": [
+			{"id": 9007199254740993, "age": 30, "name": "ada", "admin": true, "note": null, "address": {"city": "paris"}},
+			{"id": 9007199254740992, "age": 17, "name": "bob", "admin": false, "note": "late", "address": {"city": "rome"}},
+			{"id": 9007199254740994, "age": 18, "name": "cy", "address": {"city": "oslo"}}
+		]
+	})";
+
+	template <typename Value>
+	std::string write(const Value& value)
+	{
+		std::string output;
+		Json::Writer writer(output);
+		writer.write(value);
+		writer.flush();
+		return output;
+	}
+
+	/**
+	 * Runs the path against a node tree and against documents with both
+	 * object storages, and checks that all of them select the expected
+	 * values, written as compact JSON
+	 *
+	 * @param isSorted whether the results are compared in sorted order,
+	 * for the children of an object, whose order depends on the storage
+	 */
+	void checkPath(const std::string& expression, std::vector<std::string> expected, bool isSorted = false)
+	{
+		const Json::Path path(expression);
+		Json::Parser parser;
+
+		std::vector<std::vector<std::string>> results(3);
+
+		const std::shared_ptr<Json::Node> root = parser.parseString(input);
+		for (const Json::Node* node : path.findAll(*root))
+			results[0].push_back(write(*node));
+
+		const Json::Document hashed = parser.parseDocument(input.data(), input.size(), Json::Document::ObjectStorage::Hashed);
+		for (const Json::Element& element : path.findAll(hashed.getRoot()))
+			results[1].push_back(write(element));
+
+		const Json::Document flat = parser.parseDocument(input.data(), input.size(), Json::Document::ObjectStorage::Flat);
+		for (const Json::Element& element : path.findAll(flat.getRoot()))
+			results[2].push_back(write(element));
+
+		if (isSorted)
+			std::sort(expected.begin(), expected.end());
+
+		for (std::vector<std::string>& result : results)
+		{
+			if (isSorted)
+				std::sort(result.begin(), result.end());
+			TEST_CHECK(result == expected);
+		}
+
+		const Json::Node* first = path.find(*root);
+		const std::optional<Json::Element> firstElement = path.find(hashed.getRoot());
+		TEST_CHECK((first != nullptr) == !expected.empty());
+		TEST_CHECK(firstElement.has_value() == !expected.empty());
+		if (!expected.empty() && !isSorted)
+		{
+			TEST_CHECK(write(*first) == expected[0]);
+			TEST_CHECK(write(*firstElement) == expected[0]);
+		}
+	}
+
+	bool isRejected(const std::string& expression)
+	{
+		try
+		{
+			Json::Path path(expression);
+		}
+		catch (const std::exception&)
+		{
+			return true;
+		}
+		return false;
+	}
+}
+
+std::vector<Tests::Test> Tests::getPathTests()
+{
+	std::vector<Test> tests;
+
+	tests.push_back(Test{ "pointer-escapes", []
+	{
+		checkPath("/a~1b", { "1" });
+		checkPath("/m~0n", { "2" });
+		checkPath("/~01", { "3" });
+		checkPath("/", { "4" });
+		checkPath("/a~1b/x", {});
+		TEST_CHECK(isRejected("/a~2b"));
+		TEST_CHECK(isRejected("/a~"));
+	} });
+
+	tests.push_back(Test{ "pointer-indexes", []
+	{
+		checkPath("/list/0", { "10" });
+		checkPath("/list/2/0", { "12" });
+		checkPath("/list/3", {});
+		checkPath("/list/01", {});
+		checkPath("/list/-1", {});
+		checkPath("/list/18446744073709551616", {});
+		checkPath("/list/18446744073709551617", {});
+		checkPath("/01", { "5" });
+		checkPath("/0", { "6" });
+	} });
+
+	tests.push_back(Test{ "pointer-root", []
+	{
+		Json::Parser parser;
+		const std::shared_ptr<Json::Node> root = parser.parseString(input);
+		TEST_CHECK(Json::Path("").find(*root) == root.get());
+	} });
+
+	tests.push_back(Test{ "members-and-indexes", []
+	{
+		checkPath("$.list", { "[10,11,[12]]" });
+		checkPath("$.list[1]", { "11" });
+		checkPath("$.list[2][0]", { "12" });
+		checkPath("$.list[3]", {});
+		checkPath("$.list[18446744073709551616]", {});
+		checkPath("$.users[0].address.city", { "\"paris\"" });
+		checkPath("$.missing", {});
+		checkPath("$.list.x", {});
+	} });
+
+	tests.push_back(Test{ "quoted-members", []
+	{
+		checkPath("$['a/b']", { "1" });
+		checkPath("$[\"m~n\"]", { "2" });
+		checkPath("$['it\\'s']", { "7" });
+		checkPath("$['object']['y']", { "2" });
+		checkPath("$['']", { "4" });
+	} });
+
+	tests.push_back(Test{ "wildcards", []
+	{
+		checkPath("$.list[*]", { "10", "11", "[12]" });
+		checkPath("$.list.*", { "10", "11", "[12]" });
+		checkPath("$.object.*", { "1", "2" }, true);
+		checkPath("$.object[*]", { "1", "2" }, true);
+		checkPath("$.users[*].name", { "\"ada\"", "\"bob\"", "\"cy\"" });
+		checkPath("$.users[*].address.city", { "\"paris\"", "\"rome\"", "\"oslo\"" });
+		checkPath("$.list[0].*", {});
+	} });
+
+	tests.push_back(Test{ "filter-operators", []
+	{
+		checkPath("$.users[?(@.age == 18)].name", { "\"cy\"" });
+		checkPath("$.users[?(@.age != 18)].name", { "\"ada\"", "\"bob\"" });
+		checkPath("$.users[?(@.age < 18)].name", { "\"bob\"" });
+		checkPath("$.users[?(@.age <= 18)].name", { "\"bob\"", "\"cy\"" });
+		checkPath("$.users[?(@.age > 18)].name", { "\"ada\"" });
+		checkPath("$.users[?(@.age >= 18)].name", { "\"ada\"", "\"cy\"" });
+		checkPath("$.users[?(@.age >= 17.5)].name", { "\"ada\"", "\"cy\"" });
+		checkPath("$.users[?( @.age>=18 )].name", { "\"ada\"", "\"cy\"" });
+	} });
+
+	// An element without the compared member never matches, not even with
+	// !=, so "cy", which has no "admin" or "note", is left out of those.
+	tests.push_back(Test{ "filter-literals", []
+	{
+		checkPath("$.users[?(@.name == 'bob')].age", { "17" });
+		checkPath("$.users[?(@.name == \"bob\")].age", { "17" });
+		checkPath("$.users[?(@.name > 'b')].age", { "17", "18" });
+		checkPath("$.users[?(@.admin == true)].name", { "\"ada\"" });
+		checkPath("$.users[?(@.admin == false)].name", { "\"bob\"" });
+		checkPath("$.users[?(@.admin != true)].name", { "\"bob\"" });
+		checkPath("$.users[?(@.note == null)].name", { "\"ada\"" });
+		checkPath("$.users[?(@.note != null)].name", { "\"bob\"" });
+		checkPath("$.users[?(@.note)].name", { "\"ada\"", "\"bob\"" });
+		checkPath("$.users[?(@.admin)].name", { "\"ada\"", "\"bob\"" });
+		checkPath("$.users[?(@.age == '18')].name", {});
+	} });
+
+	tests.push_back(Test{ "filter-nested-fields", []
+	{
+		checkPath("$.users[?(@.address.city == 'rome')].name", { "\"bob\"" });
+		checkPath("$.users[?(@['address']['city'] == 'oslo')].name", { "\"cy\"" });
+		checkPath("$.object[?(@ == 2)]", { "2" });
+	} });
+
+	// 2^53 + 1 and its neighbours are the same double, so they only stay
+	// apart if integers are compared exactly.
+	tests.push_back(Test{ "filter-integer-neighbours", []
+	{
+		checkPath("$.users[?(@.id == 9007199254740993)].name", { "\"ada\"" });
+		checkPath("$.users[?(@.id == 9007199254740992)].name", { "\"bob\"" });
+		checkPath("$.users[?(@.id == 9007199254740994)].name", { "\"cy\"" });
+		checkPath("$.users[?(@.id > 9007199254740992)].name", { "\"ada\"", "\"cy\"" });
+		checkPath("$.users[?(@.id < 9007199254740994)].name", { "\"ada\"", "\"bob\"" });
+		checkPath("$.users[?(@.id == 9007199254740993.0)].name", { "\"ada\"", "\"bob\"" });
+	} });
+
+	tests.push_back(Test{ "malformed", []
+	{
+		TEST_CHECK(isRejected("users"));
+		TEST_CHECK(isRejected("$."));
+		TEST_CHECK(isRejected("$["));
+		TEST_CHECK(isRejected("$[1"));
+		TEST_CHECK(isRejected("$['a"));
+		TEST_CHECK(isRejected("$.a b"));
+		TEST_CHECK(isRejected("$[?(@.a == )]"));
+		TEST_CHECK(isRejected("$[?(a == 1)]"));
+		TEST_CHECK(isRejected("$[?(@.a == 1]"));
+	} });
+
+	return tests;
+}
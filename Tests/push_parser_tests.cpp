@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include "headers/tests.h"
+#include "../JsonParser/headers/parser.h"
+#include "../JsonParser/headers/push_parser.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+	/**
+	 * Records the events of a parse as text, so the events of two parses
+	 * can be compared
+	 */
+	struct EventRecorder
+	{
+		std::vector<std::string> events;
+
+		void onObjectOpen() { events.push_back("{"); }
+		void onObjectClose() { events.push_back("}"); }
+		void onListOpen() { events.push_back("["); }
+		void onListClose() { events.push_back("]"); }
+		void onKey(std::string_view key) { events.push_back("key " + std::string(key)); }
+		void onValue(bool value) { events.push_back(value ? "true" : "false"); }
+		void onValue(std::int64_t value) { events.push_back("int " + std::to_string(value)); }
+		void onValue(std::uint64_t value) { events.push_back("unsigned " + std::to_string(value)); }
+		void onValue(double value) { events.push_back("double " + std::to_string(value)); }
+		void onValue(std::string_view value) { events.push_back("string " + std::string(value)); }
+		void onValue(std::nullptr_t) { events.push_back("null"); }
+	};
+
+	/**
+	 * A document with a token of every kind, escapes (\uXXXX and a
+	 * surrogate pair among them) and numbers that can be split anywhere
+	 */
+	const std::string sample = R"( {"name": "caf\u00e9 \"quoted\" back\\slash\/ \u0041",
+	"emoji": "\ud83d\ude00!", "tab\tkey": "line\nbreak",
+	"numbers": [0, -12, 3.25, -1.5e-3, 6.02E+23, 9223372036854775807, 18446744073709551615, 123456789012345678901234],
+	"literals": [true, false, null], "nested": {"empty": {}, "list": [[], [{}]]}} )";
+
+	class Pipe
+	{
+	public:
+		Pipe()
+		{
+#ifdef _WIN32
+			const int result = _pipe(descriptors, 1 << 16, _O_BINARY);
+#else
+			const int result = pipe(descriptors);
+#endif
+			if (result != 0)
+				throw Tests::Failure("Could not create a pipe");
+		}
+
+		~Pipe()
+		{
+			closeWriteEnd();
+			closeDescriptor(descriptors[0]);
+		}
+
+		void write(const char* data, std::size_t size)
+		{
+			while (size != 0)
+			{
+#ifdef _WIN32
+				const int written = _write(descriptors[1], data, unsigned(size));
+#else
+				const long written = ::write(descriptors[1], data, size);
+#endif
+				if (written <= 0)
+					return;
+				data += written;
+				size -= std::size_t(written);
+			}
+		}
+
+		std::size_t read(char* data, std::size_t size)
+		{
+#ifdef _WIN32
+			const int result = _read(descriptors[0], data, unsigned(size));
+#else
+			const long result = ::read(descriptors[0], data, size);
+#endif
+			return result > 0 ? std::size_t(result) : 0;
+		}
+
+		void closeWriteEnd()
+		{
+			closeDescriptor(descriptors[1]);
+		}
+
+	private:
+		int descriptors[2] = { -1, -1 };
+
+		static void closeDescriptor(int& descriptor)
+		{
+			if (descriptor == -1)
+				return;
+#ifdef _WIN32
+			_close(descriptor);
+#else
+			close(descriptor);
+#endif
+			descriptor = -1;
+		}
+	};
+
+	/**
+	 * Writes the text into a pipe from another thread, and feeds the push
+	 * parser with what each read returns
+	 *
+	 * @param readSizes the most bytes each read asks for, the last size is
+	 * used for every following read
+	 */
+	std::vector<std::string> pushThroughPipe(const std::string& text, const std::vector<std::size_t>& readSizes)
+	{
+		Pipe pipe;
+		std::thread writer([&pipe, &text]
+		{
+			pipe.write(text.data(), text.size());
+			pipe.closeWriteEnd();
+		});
+
+		EventRecorder recorder;
+		std::vector<char> buffer(*std::max_element(readSizes.begin(), readSizes.end()));
+
+		try
+		{
+			Json::PushParser<EventRecorder> pushParser(recorder);
+			for (std::size_t i = 0;; i++)
+			{
+				const std::size_t size = pipe.read(buffer.data(), readSizes[std::min(i, readSizes.size() - 1)]);
+				if (size == 0)
+					break;
+				pushParser.feed(buffer.data(), size);
+			}
+			pushParser.finish();
+		}
+		catch (...)
+		{
+			writer.join();
+			throw;
+		}
+
+		writer.join();
+		return recorder.events;
+	}
+
+	std::vector<std::string> parseAtOnce(const std::string& text)
+	{
+		Json::Parser parser;
+		EventRecorder recorder;
+		parser.parse(text.data(), text.size(), recorder);
+		return recorder.events;
+	}
+
+	bool throwsThroughPipe(const std::string& text, std::size_t readSize)
+	{
+		try
+		{
+			pushThroughPipe(text, { readSize });
+		}
+		catch (const Tests::Failure&)
+		{
+			throw;
+		}
+		catch (const std::exception&)
+		{
+			return true;
+		}
+		return false;
+	}
+}
+
+std::vector<Tests::Test> Tests::getPushParserTests()
+{
+	std::vector<Test> tests;
+
+	tests.push_back(Test{ "one-byte-chunks", []
+	{
+		const std::vector<std::string> expected = parseAtOnce(sample);
+		TEST_CHECK(!expected.empty());
+		TEST_CHECK(pushThroughPipe(sample, { 1 }) == expected);
+	} });
+
+	tests.push_back(Test{ "every-chunk-size", []
+	{
+		const std::vector<std::string> expected = parseAtOnce(sample);
+		for (std::size_t size = 1; size <= sample.size(); size++)
+		{
+			TEST_CHECK(pushThroughPipe(sample, { size }) == expected);
+		}
+	} });
+
+	// Splitting at every position cuts through each \uXXXX escape, the
+	// surrogate pair, the other escapes and every number.
+	tests.push_back(Test{ "every-split-position", []
+	{
+		const std::vector<std::string> expected = parseAtOnce(sample);
+		for (std::size_t position = 1; position < sample.size(); position++)
+		{
+			TEST_CHECK(pushThroughPipe(sample, { position, sample.size() }) == expected);
+		}
+	} });
+
+	tests.push_back(Test{ "varied-chunk-sizes", []
+	{
+		std::string text = "[";
+		for (unsigned i = 0; i < 2000; i++)
+		{
+			text += sample + ",";
+		}
+		text += sample + "]";
+
+		TEST_CHECK(pushThroughPipe(text, { 7, 1, 4096, 3, 65536, 2, 13 }) == parseAtOnce(text));
+	} });
+
+	tests.push_back(Test{ "invalid-input", []
+	{
+		for (std::size_t size : { 1, 3, 64 })
+		{
+			TEST_CHECK(throwsThroughPipe(R"({"a": [1, 2,]})", size));
+			TEST_CHECK(throwsThroughPipe(R"({"a": "\u12G4"})", size));
+			TEST_CHECK(throwsThroughPipe(R"({"a": [1, 2])", size));
+			TEST_CHECK(throwsThroughPipe(R"({"a": "unterminated})", size));
+		}
+	} });
+
+	return tests;
+}
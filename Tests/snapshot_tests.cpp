@@ -0,0 +1,293 @@
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+#include "headers/tests.h"
+#include "../JsonParser/headers/parser.h"
+#include "../JsonParser/headers/snapshot.h"
+#include "../JsonParser/headers/writer.h"
+
+namespace
+{
+	const std::string input = R"({
+		"name": "snapshot", "escaped": "caf\u00e9 \"quoted\"", "empty": "",
+		"integers": [0, -1, 2147483648, -9223372036854775808, 18446744073709551615, 9007199254740993],
+		"doubles": [0.5, -1e300, 2.5e-308],
+		"flags": [true, false, null],
+		"nested": {"list": [[], {}, [[1, {"deep": "value"}]]], "object": {"a": {"b": {"c": 1}}}},
+		"records": [{"id": 1, "tags": ["x", "y"]}, {"id": 2, "tags": []}]
+	})";
+
+	/**
+	 * The size of the header the words of a snapshot follow
+	 */
+	const std::size_t headerSize = 32;
+
+	/**
+	 * A snapshot file in the temporary directory, removed when the test
+	 * ends
+	 */
+	class TemporaryFile
+	{
+	public:
+		explicit TemporaryFile(const std::string& name) :
+			path((std::filesystem::temp_directory_path() / ("json_snapshot_tests_" + name)).string())
+		{
+		}
+
+		~TemporaryFile()
+		{
+			std::error_code error;
+			std::filesystem::remove(path, error);
+		}
+
+		std::string read() const
+		{
+			std::ifstream file(path, std::ios::binary);
+			return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		}
+
+		void write(const std::string& content) const
+		{
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			file.write(content.data(), std::streamsize(content.size()));
+		}
+
+		const std::string path;
+	};
+
+	std::string write(const Json::TapeElement& element)
+	{
+		std::string output;
+		Json::Writer writer(output);
+		writer.write(element);
+		writer.flush();
+		return output;
+	}
+
+	std::string write(const Json::Node& node)
+	{
+		std::string output;
+		Json::Writer writer(output);
+		writer.write(node);
+		writer.flush();
+		return output;
+	}
+
+	/**
+	 * Checks that the element holds the same value as the node, reading it
+	 * through at() and getAs<T>()
+	 */
+	void checkSame(const Json::Node& node, const Json::TapeElement& element)
+	{
+		TEST_CHECK(element.getType() == node.getType());
+
+		switch (node.getType())
+		{
+			case Json::Node::Type::Object:
+				for (const auto& [key, child] : node.items())
+				{
+					checkSame(*child, element.at(key));
+				}
+				break;
+			case Json::Node::Type::List:
+				for (unsigned i = 0; i < node.size(); i++)
+				{
+					checkSame(*node.at(i), element.at(i));
+				}
+				break;
+			case Json::Node::Type::String:
+				TEST_CHECK(element.getAs<std::string>() == std::string(node));
+				TEST_CHECK(element.getAs<std::string_view>() == std::string_view(node));
+				break;
+			case Json::Node::Type::Boolean:
+				TEST_CHECK(element.getAs<bool>() == bool(node));
+				break;
+			case Json::Node::Type::Number:
+			{
+				const Json::Value value = node.getRawValue();
+				if (std::holds_alternative<double>(value))
+				{
+					TEST_CHECK(element.getAs<double>() == double(node));
+				}
+				else if (std::holds_alternative<std::uint64_t>(value))
+				{
+					TEST_CHECK(element.getAs<std::uint64_t>() == std::uint64_t(node));
+				}
+				else
+				{
+					TEST_CHECK(element.getAs<std::int64_t>() == std::int64_t(node));
+				}
+				break;
+			}
+			default:
+				break;
+		}
+	}
+
+	bool isRejected(const std::string& path)
+	{
+		try
+		{
+			Json::Snapshot snapshot(path);
+		}
+		catch (const std::exception&)
+		{
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Returns the byte offset of the first word with the tag in the file
+	 */
+	std::size_t findWord(const std::string& file, char tag)
+	{
+		for (std::size_t offset = headerSize; offset + 8 <= file.size(); offset += 8)
+		{
+			std::uint64_t word;
+			std::memcpy(&word, file.data() + offset, sizeof(word));
+			if (char(word >> 56) == tag)
+				return offset;
+		}
+		return std::string::npos;
+	}
+}
+
+std::vector<Tests::Test> Tests::getSnapshotTests()
+{
+	std::vector<Test> tests;
+
+	tests.push_back(Test{ "round-trip-tape", []
+	{
+		Json::Parser parser;
+		const std::shared_ptr<Json::Node> root = parser.parseString(input);
+		const Json::Tape tape = parser.parseTape(input.data(), input.size());
+
+		TemporaryFile file("tape");
+		Json::Snapshot::save(tape, file.path);
+
+		const Json::Snapshot snapshot(file.path);
+		TEST_CHECK(snapshot.getSizeInBytes() == file.read().size());
+		checkSame(*root, snapshot.getRoot());
+		TEST_CHECK(write(snapshot.getRoot()) == write(tape.getRoot()));
+		TEST_CHECK(snapshot.getRoot().at("nested").at("list").at(2).at(0).at(1).at("deep").getAs<std::string>() == "value");
+		TEST_CHECK(snapshot.getRoot().at("integers").at(5).getAs<std::int64_t>() == 9007199254740993);
+	} });
+
+	tests.push_back(Test{ "round-trip-node", []
+	{
+		Json::Parser parser;
+		const std::shared_ptr<Json::Node> root = parser.parseString(input);
+
+		TemporaryFile file("node");
+		Json::Snapshot::save(*root, file.path);
+
+		const Json::Snapshot snapshot(file.path);
+		checkSame(*root, snapshot.getRoot());
+		TEST_CHECK(write(snapshot.getRoot()) == write(*root));
+	} });
+
+	tests.push_back(Test{ "round-trip-list-root", []
+	{
+		Json::Parser parser;
+		const std::shared_ptr<Json::Node> root = parser.parseString("[1, \"two\", [3.5, null], {}]");
+
+		TemporaryFile file("list");
+		Json::Snapshot::save(*root, file.path);
+
+		const Json::Snapshot snapshot(file.path);
+		checkSame(*root, snapshot.getRoot());
+	} });
+
+	tests.push_back(Test{ "rejects-bad-magic", []
+	{
+		Json::Parser parser;
+		TemporaryFile file("magic");
+		Json::Snapshot::save(*parser.parseString(input), file.path);
+
+		std::string content = file.read();
+		content[0] = 'X';
+		file.write(content);
+		TEST_CHECK(isRejected(file.path));
+	} });
+
+	tests.push_back(Test{ "rejects-bad-version", []
+	{
+		Json::Parser parser;
+		TemporaryFile file("version");
+		Json::Snapshot::save(*parser.parseString(input), file.path);
+
+		std::string content = file.read();
+		const std::uint32_t version = 2;
+		std::memcpy(&content[8], &version, sizeof(version));
+		file.write(content);
+		TEST_CHECK(isRejected(file.path));
+	} });
+
+	tests.push_back(Test{ "rejects-truncated-file", []
+	{
+		Json::Parser parser;
+		TemporaryFile file("truncated");
+		Json::Snapshot::save(*parser.parseString(input), file.path);
+		const std::string content = file.read();
+
+		const std::size_t sizes[] = { 0, 7, headerSize - 1, headerSize, headerSize + 8, content.size() - 9, content.size() - 1 };
+		for (std::size_t size : sizes)
+		{
+			file.write(content.substr(0, size));
+			TEST_CHECK(isRejected(file.path));
+		}
+
+		file.write(content + "x");
+		TEST_CHECK(isRejected(file.path));
+
+		file.write(content);
+		TEST_CHECK(!isRejected(file.path));
+	} });
+
+	// The open and close words of a container point at each other, so a
+	// flipped bit in either link is found before the tape is read.
+	tests.push_back(Test{ "rejects-flipped-container-link", []
+	{
+		Json::Parser parser;
+		TemporaryFile file("link");
+		Json::Snapshot::save(*parser.parseString(input), file.path);
+		const std::string content = file.read();
+
+		for (char tag : { ']', '}', '[', '{' })
+		{
+			const std::size_t offset = findWord(content, tag);
+			TEST_CHECK(offset != std::string::npos);
+
+			for (unsigned bit = 0; bit < 4; bit++)
+			{
+				std::string corrupted = content;
+				corrupted[offset] = char(corrupted[offset] ^ (1 << bit));
+				file.write(corrupted);
+				TEST_CHECK(isRejected(file.path));
+			}
+		}
+	} });
+
+	tests.push_back(Test{ "rejects-string-outside-buffer", []
+	{
+		Json::Parser parser;
+		TemporaryFile file("string");
+		Json::Snapshot::save(*parser.parseString(input), file.path);
+
+		std::string content = file.read();
+		const std::size_t offset = findWord(content, '"');
+		TEST_CHECK(offset != std::string::npos);
+		content[offset + 4] = char(0x7f);
+		file.write(content);
+		TEST_CHECK(isRejected(file.path));
+	} });
+
+	return tests;
+}
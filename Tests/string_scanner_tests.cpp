@@ -0,0 +1,216 @@
+#include <exception>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "headers/tests.h"
+#include "../JsonParser/headers/string_scanner.h"
+
+namespace
+{
+	using Implementation = Json::StringScanner::Implementation;
+
+	/**
+	 * Long enough that a piece placed at any offset of the first block is
+	 * followed by a second block and a scalar tail
+	 */
+	const std::size_t bodySize = 100;
+
+	/**
+	 * Returns every implementation the processor can run, so each of them
+	 * is checked against the same strings
+	 */
+	std::vector<Implementation> getImplementations()
+	{
+		std::vector<Implementation> implementations = { Implementation::Scalar };
+		const Implementation best = Json::StructuralIndex::getBestImplementation();
+		if (best == Implementation::Sse2 || best == Implementation::Avx2)
+			implementations.push_back(Implementation::Sse2);
+		if (best == Implementation::Avx2)
+			implementations.push_back(Implementation::Avx2);
+		return implementations;
+	}
+
+	/**
+	 * Builds a quoted string of about bodySize characters with the piece
+	 * at the given offset
+	 */
+	std::string makeString(std::string_view piece, std::size_t offset)
+	{
+		std::string body(offset, 'a');
+		body += piece;
+		body.append(bodySize - offset, 'b');
+		return "\"" + body + "\"";
+	}
+
+	struct Result
+	{
+		bool isValid = false;
+		std::string decoded;
+		bool isView = false;
+	};
+
+	Result read(const std::string& input, Implementation implementation)
+	{
+		Result result;
+		std::string output;
+		std::string_view text;
+
+		try
+		{
+			const char* begin = input.data() + 1;
+			const char* next = Json::StringScanner::read(begin, input.data() + input.size(), output, text, input.data(), implementation);
+			TEST_CHECK(next == input.data() + input.size());
+		}
+		catch (const Tests::Failure&)
+		{
+			throw;
+		}
+		catch (const std::exception&)
+		{
+			return result;
+		}
+
+		result.isValid = true;
+		result.decoded = std::string(text);
+		result.isView = (text.data() == input.data() + 1);
+		return result;
+	}
+
+	/**
+	 * Checks that the piece decodes to the expected text at every offset
+	 * of the first 64 byte block, with every implementation
+	 */
+	void checkDecoded(std::string_view piece, std::string_view expected)
+	{
+		for (Implementation implementation : getImplementations())
+		{
+			for (std::size_t offset = 0; offset < 64; offset++)
+			{
+				const Result result = read(makeString(piece, offset), implementation);
+				const std::string wanted = std::string(offset, 'a') + std::string(expected) + std::string(bodySize - offset, 'b');
+				TEST_CHECK(result.isValid);
+				TEST_CHECK(result.decoded == wanted);
+			}
+		}
+	}
+
+	/**
+	 * Checks that the piece is rejected at every offset of the first 64
+	 * byte block, with every implementation
+	 */
+	void checkRejected(std::string_view piece)
+	{
+		for (Implementation implementation : getImplementations())
+		{
+			for (std::size_t offset = 0; offset < 64; offset++)
+			{
+				TEST_CHECK(!read(makeString(piece, offset), implementation).isValid);
+			}
+		}
+	}
+}
+
+std::vector<Tests::Test> Tests::getStringScannerTests()
+{
+	std::vector<Test> tests;
+
+	tests.push_back(Test{ "plain-string-is-view", []
+	{
+		for (Implementation implementation : getImplementations())
+		{
+			for (std::size_t offset = 0; offset < 64; offset++)
+			{
+				const Result result = read(makeString("caf\xc3\xa9 \xf0\x9f\x98\x80", offset), implementation);
+				TEST_CHECK(result.isValid);
+				TEST_CHECK(result.isView);
+			}
+		}
+	} });
+
+	tests.push_back(Test{ "escaped-quote-and-backslash", []
+	{
+		checkDecoded(R"(\")", "\"");
+		checkDecoded(R"(\\)", "\\");
+		checkDecoded(R"(\\\")", "\\\"");
+		checkDecoded(R"(\/\b\f\n\r\t)", "/\b\f\n\r\t");
+	} });
+
+	tests.push_back(Test{ "unicode-escape", []
+	{
+		checkDecoded(R"(\u0041)", "A");
+		checkDecoded(R"(\u00e9)", "\xc3\xa9");
+		checkDecoded(R"(\u20AC)", "\xe2\x82\xac");
+	} });
+
+	tests.push_back(Test{ "surrogate-pair", []
+	{
+		checkDecoded(R"(\ud83d\ude00)", "\xf0\x9f\x98\x80");
+	} });
+
+	tests.push_back(Test{ "lone-surrogate", []
+	{
+		checkRejected(R"(\ud83d)");
+		checkRejected(R"(\ud83dx)");
+		checkRejected(R"(\ud83dA)");
+		checkRejected(R"(\ude00)");
+	} });
+
+	tests.push_back(Test{ "invalid-escape", []
+	{
+		checkRejected(R"(\x)");
+		checkRejected(R"(\u12G4)");
+		checkRejected(R"(\u12x)");
+	} });
+
+	tests.push_back(Test{ "invalid-utf8", []
+	{
+		checkRejected("\xc0\xaf");
+		checkRejected("\xed\xa0\x80");
+		checkRejected("\xf4\x90\x80\x80");
+		checkRejected("\xff");
+		checkRejected("\x80");
+	} });
+
+	tests.push_back(Test{ "truncated-utf8", []
+	{
+		checkRejected("\xe2\x82");
+		checkRejected("\xf0\x9f\x98");
+		checkRejected("\xc3");
+	} });
+
+	// A truncated sequence directly before the closing quote must not be
+	// completed by the quote or whatever follows it.
+	tests.push_back(Test{ "truncated-utf8-at-end", []
+	{
+		for (Implementation implementation : getImplementations())
+		{
+			for (std::size_t length = 0; length < 64; length++)
+			{
+				TEST_CHECK(!read("\"" + std::string(length, 'a') + "\xe2\x82\"", implementation).isValid);
+				TEST_CHECK(!read("\"" + std::string(length, 'a') + "\xf0\"", implementation).isValid);
+			}
+		}
+	} });
+
+	tests.push_back(Test{ "control-character", []
+	{
+		checkRejected(std::string_view("\x00", 1));
+		checkRejected("\x01");
+		checkRejected("\n");
+		checkRejected("\x1f");
+	} });
+
+	tests.push_back(Test{ "unterminated", []
+	{
+		for (Implementation implementation : getImplementations())
+		{
+			for (std::size_t length = 0; length < 130; length++)
+			{
+				TEST_CHECK(!read("\"" + std::string(length, 'a'), implementation).isValid);
+				TEST_CHECK(!read("\"" + std::string(length, 'a') + "\\\"", implementation).isValid);
+			}
+		}
+	} });
+
+	return tests;
+}
@@ -0,0 +1,189 @@
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "headers/tests.h"
+#include "../JsonParser/headers/parser.h"
+
+namespace
+{
+	const std::string input = R"({
+		"name": "tape", "escaped": "a\"b\\c\n", "empty": "",
+		"integers": [0, -1, 2147483647, 2147483648, -9223372036854775808, 18446744073709551615],
+		"doubles": [0.5, -2.75, 1e300],
+		"flags": [true, false, null],
+		"nested": [[], {}, [[1, {"deep": [2, 3]}], 4], {"a": {"b": 5}}, 6],
+		"last": 7
+	})";
+
+	Json::Tape parseTape(const std::string& text)
+	{
+		Json::Parser parser;
+		return parser.parseTape(text.data(), text.size());
+	}
+
+	template <typename Function>
+	bool throws(Function function)
+	{
+		try
+		{
+			function();
+		}
+		catch (const Tests::Failure&)
+		{
+			throw;
+		}
+		catch (const std::exception&)
+		{
+			return true;
+		}
+		return false;
+	}
+}
+
+std::vector<Tests::Test> Tests::getTapeTests()
+{
+	std::vector<Test> tests;
+
+	tests.push_back(Test{ "types", []
+	{
+		const Json::Tape tape = parseTape(input);
+		const Json::TapeElement root = tape.getRoot();
+
+		TEST_CHECK(root.getType() == Json::Node::Type::Object);
+		TEST_CHECK(root.at("name").getType() == Json::Node::Type::String);
+		TEST_CHECK(root.at("integers").getType() == Json::Node::Type::List);
+		TEST_CHECK(root.at("integers").at(0).getType() == Json::Node::Type::Number);
+		TEST_CHECK(root.at("doubles").at(0).getType() == Json::Node::Type::Number);
+		TEST_CHECK(root.at("flags").at(0).getType() == Json::Node::Type::Boolean);
+		TEST_CHECK(root.at("flags").at(2).getType() == Json::Node::Type::Null);
+	} });
+
+	// Containers are skipped by their links, so the values after nested
+	// ones are found at the right positions.
+	tests.push_back(Test{ "skips-nested-containers", []
+	{
+		const Json::Tape tape = parseTape(input);
+		const Json::TapeElement nested = tape.getRoot().at("nested");
+
+		TEST_CHECK(nested.at(0).getType() == Json::Node::Type::List);
+		TEST_CHECK(nested.at(1).getType() == Json::Node::Type::Object);
+		TEST_CHECK(nested.at(2).at(0).at(1).at("deep").at(1).getAs<int>() == 3);
+		TEST_CHECK(nested.at(2).at(1).getAs<int>() == 4);
+		TEST_CHECK(nested.at(3).at("a").at("b").getAs<int>() == 5);
+		TEST_CHECK(nested.at(4).getAs<int>() == 6);
+		TEST_CHECK(nested[4].getAs<int>() == 6);
+		TEST_CHECK(tape.getRoot().at("last").getAs<int>() == 7);
+		TEST_CHECK(tape.getRoot()["last"].getAs<int>() == 7);
+	} });
+
+	tests.push_back(Test{ "strings", []
+	{
+		const Json::Tape tape = parseTape(input);
+		const Json::TapeElement root = tape.getRoot();
+
+		TEST_CHECK(root.at("name").getAs<std::string>() == "tape");
+		TEST_CHECK(root.at("escaped").getAs<std::string_view>() == "a\"b\\c\n");
+		TEST_CHECK(root.at("empty").getAs<std::string>().empty());
+		TEST_CHECK(throws([&] { (void)root.at("integers").at(0).getAs<std::string>(); }));
+	} });
+
+	tests.push_back(Test{ "integers", []
+	{
+		const Json::Tape tape = parseTape(input);
+		const Json::TapeElement integers = tape.getRoot().at("integers");
+
+		TEST_CHECK(integers.at(1).getAs<int>() == -1);
+		TEST_CHECK(integers.at(2).getAs<int>() == 2147483647);
+		TEST_CHECK(throws([&] { (void)integers.at(3).getAs<int>(); }));
+		TEST_CHECK(integers.at(3).getAs<std::int64_t>() == 2147483648);
+		TEST_CHECK(integers.at(4).getAs<std::int64_t>() == std::numeric_limits<std::int64_t>::min());
+		TEST_CHECK(throws([&] { (void)integers.at(4).getAs<std::uint64_t>(); }));
+		TEST_CHECK(integers.at(5).getAs<std::uint64_t>() == std::numeric_limits<std::uint64_t>::max());
+		TEST_CHECK(throws([&] { (void)integers.at(5).getAs<std::int64_t>(); }));
+		TEST_CHECK(throws([&] { (void)integers.at(5).getAs<int>(); }));
+		TEST_CHECK(integers.at(5).getAs<double>() == 18446744073709551615.0);
+	} });
+
+	tests.push_back(Test{ "doubles", []
+	{
+		const Json::Tape tape = parseTape(input);
+		const Json::TapeElement doubles = tape.getRoot().at("doubles");
+
+		TEST_CHECK(doubles.at(0).getAs<double>() == 0.5);
+		TEST_CHECK(doubles.at(1).getAs<int>() == -2);
+		TEST_CHECK(doubles.at(1).getAs<std::int64_t>() == -2);
+		TEST_CHECK(throws([&] { (void)doubles.at(1).getAs<std::uint64_t>(); }));
+		TEST_CHECK(throws([&] { (void)doubles.at(2).getAs<std::int64_t>(); }));
+		TEST_CHECK(throws([&] { (void)doubles.at(0).getAs<bool>(); }));
+	} });
+
+	tests.push_back(Test{ "booleans-and-null", []
+	{
+		const Json::Tape tape = parseTape(input);
+		const Json::TapeElement flags = tape.getRoot().at("flags");
+
+		TEST_CHECK(flags.at(0).getAs<bool>());
+		TEST_CHECK(!flags.at(1).getAs<bool>());
+		TEST_CHECK(throws([&] { (void)flags.at(2).getAs<bool>(); }));
+		TEST_CHECK(throws([&] { (void)flags.at(2).getAs<double>(); }));
+	} });
+
+	tests.push_back(Test{ "invalid-accesses", []
+	{
+		const Json::Tape tape = parseTape(input);
+		const Json::TapeElement root = tape.getRoot();
+
+		TEST_CHECK(throws([&] { root.at("missing"); }));
+		TEST_CHECK(throws([&] { root.at(0); }));
+		TEST_CHECK(throws([&] { root.at("integers").at("name"); }));
+		TEST_CHECK(throws([&] { root.at("integers").at(6); }));
+		TEST_CHECK(throws([&] { root.at("nested").at(0).at(0); }));
+		TEST_CHECK(throws([&] { root.at("nested").at(1).at(""); }));
+		TEST_CHECK(throws([&] { root.at("name").at(0); }));
+	} });
+
+	tests.push_back(Test{ "keys-are-not-values", []
+	{
+		const Json::Tape tape = parseTape(R"({"a": "b", "b": "a"})");
+		TEST_CHECK(tape.getRoot().at("a").getAs<std::string>() == "b");
+		TEST_CHECK(tape.getRoot().at("b").getAs<std::string>() == "a");
+		TEST_CHECK(throws([&] { tape.getRoot().at("c"); }));
+	} });
+
+	tests.push_back(Test{ "built-from-node", []
+	{
+		Json::Parser parser;
+		const std::shared_ptr<Json::Node> root = parser.parseString(input);
+
+		Json::Tape tape;
+		Json::TapeBuilder builder(tape);
+		builder.write(*root);
+
+		TEST_CHECK(tape.getRoot().at("nested").at(2).at(0).at(1).at("deep").at(0).getAs<int>() == 2);
+		TEST_CHECK(tape.getRoot().at("escaped").getAs<std::string>() == "a\"b\\c\n");
+		TEST_CHECK(tape.getRoot().toString() == parseTape(root->toString()).getRoot().toString());
+	} });
+
+	// The length of a string is stored in 32 bits, so a longer string is
+	// rejected before anything is copied. The view is never read.
+	tests.push_back(Test{ "rejects-too-long-string", []
+	{
+		if constexpr (sizeof(std::size_t) > sizeof(std::uint32_t))
+		{
+			const char text[] = "x";
+			const std::string_view tooLong(text, std::size_t(std::numeric_limits<std::uint32_t>::max()) + 1);
+
+			Json::Tape tape;
+			Json::TapeBuilder builder(tape);
+			builder.onListOpen();
+			TEST_CHECK(throws([&] { builder.onValue(tooLong); }));
+			TEST_CHECK(tape.getStrings().empty());
+		}
+	} });
+
+	return tests;
+}
@@ -0,0 +1,97 @@
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "headers/tests.h"
+#include "../JsonParser/headers/parser.h"
+
+namespace
+{
+	/**
+	 * Builds the input at run time, so its strings are on the heap where
+	 * a use after free of them is caught by AddressSanitizer
+	 */
+	std::string makeInput()
+	{
+		return std::string(R"({"users": [{"name": "Ada", "id": 9007199254740993}, {"name": "Grace", "id": 2}],)")
+			+ R"( "title": "view", "escaped": "caf\u00e9"})";
+	}
+}
+
+std::vector<Tests::Test> Tests::getViewDocumentTests()
+{
+	std::vector<Test> tests;
+
+	tests.push_back(Test{ "child-outlives-document", []
+	{
+		std::shared_ptr<Json::Node> name;
+		std::shared_ptr<Json::Node> title;
+		{
+			Json::Parser parser;
+			const Json::ViewDocument document = parser.parseViewString(makeInput());
+			const std::shared_ptr<Json::Node> root = document.getRoot();
+			name = root->at("users")->at(1)->at("name");
+			title = (*root)["title"];
+		}
+		TEST_CHECK(std::string_view(*name) == "Grace");
+		TEST_CHECK(std::string_view(*title) == "view");
+	} });
+
+	tests.push_back(Test{ "elements-outlive-document", []
+	{
+		Json::List users;
+		{
+			Json::Parser parser;
+			users = parser.parseViewString(makeInput()).getRoot()->at("users")->elements();
+		}
+		TEST_CHECK(users.size() == 2);
+		TEST_CHECK(std::string_view(*users[0]->at("name")) == "Ada");
+		TEST_CHECK(std::string_view(*users[1]->at("name")) == "Grace");
+	} });
+
+	tests.push_back(Test{ "lazy-number-outlives-document", []
+	{
+		std::shared_ptr<Json::Node> id;
+		{
+			Json::Parser parser;
+			id = parser.parseViewString(makeInput(), Json::Parser::NumberConversion::Lazy).getRoot()->at("users")->at(0)->at("id");
+		}
+		TEST_CHECK(std::int64_t(*id) == 9007199254740993);
+		TEST_CHECK(id->toString() == "9007199254740993");
+	} });
+
+	tests.push_back(Test{ "lazy-number-refers-to-input", []
+	{
+		Json::Parser parser;
+		const Json::ViewDocument document = parser.parseViewString(makeInput(), Json::Parser::NumberConversion::Lazy);
+		const Json::Value id = document.getRoot()->at("users")->at(0)->at("id")->getRawValue();
+		TEST_CHECK(std::holds_alternative<Json::LazyNumber>(id));
+
+		const std::string_view text = std::get<Json::LazyNumber>(id).getText();
+		const std::string_view input = document.getInput();
+		TEST_CHECK(text == "9007199254740993");
+		TEST_CHECK(input.data() <= text.data() && text.data() + text.size() <= input.data() + input.size());
+	} });
+
+	// The nodes own the input but the input does not own the nodes, so a
+	// kept node does not keep the rest of the tree alive, and no cycle is
+	// left behind for the leak checker.
+	tests.push_back(Test{ "tree-released-without-kept-node", []
+	{
+		std::weak_ptr<Json::Node> root;
+		std::shared_ptr<Json::Node> title;
+		std::shared_ptr<Json::Node> escaped;
+		{
+			Json::Parser parser;
+			const Json::ViewDocument document = parser.parseViewString(makeInput());
+			root = document.getRoot();
+			title = document.getRoot()->at("title");
+			escaped = document.getRoot()->at("escaped");
+		}
+		TEST_CHECK(root.expired());
+		TEST_CHECK(std::string_view(*title) == "view");
+		TEST_CHECK(std::string_view(*escaped) == "caf\xc3\xa9");
+	} });
+
+	return tests;
+}
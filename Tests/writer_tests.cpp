@@ -0,0 +1,254 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "headers/tests.h"
+#include "../JsonParser/headers/parser.h"
+#include "../JsonParser/headers/writer.h"
+
+namespace
+{
+	/**
+	 * The size of the buffer the writer hands to its destination
+	 */
+	const std::size_t bufferSize = 1 << 16;
+
+	template <typename Value>
+	std::string write(const Value& value, Json::Writer::Style style = Json::Writer::Style::Compact)
+	{
+		std::string output;
+		Json::Writer writer(output, style);
+		writer.write(value);
+		writer.flush();
+		return output;
+	}
+
+	std::string writeDouble(double value)
+	{
+		std::string output;
+		Json::Writer writer(output);
+		writer.onValue(value);
+		writer.flush();
+		return output;
+	}
+
+	/**
+	 * Writes the value, reads it back from the output and returns it
+	 */
+	double roundTrip(double value)
+	{
+		Json::Parser parser;
+		return double(*parser.parseString("[" + writeDouble(value) + "]")->at(0));
+	}
+
+	template <typename Function>
+	bool throws(Function function)
+	{
+		try
+		{
+			function();
+		}
+		catch (const Tests::Failure&)
+		{
+			throw;
+		}
+		catch (const std::exception&)
+		{
+			return true;
+		}
+		return false;
+	}
+}
+
+std::vector<Tests::Test> Tests::getWriterTests()
+{
+	std::vector<Test> tests;
+
+	tests.push_back(Test{ "escapes-quotes-and-backslashes", []
+	{
+		TEST_CHECK(Json::Writer::escape("a\"b\\c") == "a\\\"b\\\\c");
+		TEST_CHECK(Json::Writer::escape("\\\"") == "\\\\\\\"");
+		TEST_CHECK(Json::Writer::escape("/") == "/");
+		TEST_CHECK(Json::Writer::escape("caf\xc3\xa9 \xf0\x9f\x98\x80 \x7f") == "caf\xc3\xa9 \xf0\x9f\x98\x80 \x7f");
+	} });
+
+	tests.push_back(Test{ "escapes-control-characters", []
+	{
+		TEST_CHECK(Json::Writer::escape("\b\f\n\r\t") == "\\b\\f\\n\\r\\t");
+		TEST_CHECK(Json::Writer::escape(std::string_view("\x00", 1)) == "\\u0000");
+		TEST_CHECK(Json::Writer::escape("\x01\x1f") == "\\u0001\\u001f");
+
+		std::string controls;
+		for (int c = 0; c < 0x20; c++)
+		{
+			controls += char(c);
+		}
+		controls += "\"\\ end";
+
+		Json::Parser parser;
+		const std::shared_ptr<Json::Node> root = parser.parseString("[" + std::string("\"") + Json::Writer::escape(controls) + "\"]");
+		TEST_CHECK(std::string(*root->at(0)) == controls);
+
+		const std::string written = write(*root);
+		for (char c : written)
+		{
+			TEST_CHECK((unsigned char)c >= 0x20);
+		}
+		TEST_CHECK(std::string(*parser.parseString(written)->at(0)) == controls);
+	} });
+
+	tests.push_back(Test{ "escapes-keys", []
+	{
+		Json::Parser parser;
+		const std::shared_ptr<Json::Node> root = parser.parseString(R"({"a\"b\n": 1})");
+		TEST_CHECK(write(*root) == R"({"a\"b\n":1})");
+	} });
+
+	tests.push_back(Test{ "shortest-round-trip-doubles", []
+	{
+		TEST_CHECK(writeDouble(0.1) == "0.1");
+		TEST_CHECK(writeDouble(1.5) == "1.5");
+		TEST_CHECK(writeDouble(1.0) == "1.0");
+		TEST_CHECK(writeDouble(-3.0) == "-3.0");
+		TEST_CHECK(writeDouble(0.0) == "0.0");
+		TEST_CHECK(writeDouble(-0.0) == "-0.0");
+		TEST_CHECK(writeDouble(1e300) == "1e+300");
+		TEST_CHECK(writeDouble(1e-7) == "1e-07");
+		TEST_CHECK(writeDouble(123456789012345680.0) == "123456789012345680.0");
+
+		const double values[] = { 0.1, 1.0 / 3, 2.0 / 3, 1e300, -1e-300, 5e-324, 2.2250738585072014e-308,
+			std::numeric_limits<double>::max(), 9007199254740993.0, 0.30000000000000004, 100.0, -0.0 };
+		for (double value : values)
+		{
+			const double read = roundTrip(value);
+			TEST_CHECK(std::memcmp(&read, &value, sizeof(value)) == 0);
+		}
+	} });
+
+	tests.push_back(Test{ "non-finite-doubles-are-null", []
+	{
+		TEST_CHECK(writeDouble(std::numeric_limits<double>::infinity()) == "null");
+		TEST_CHECK(writeDouble(-std::numeric_limits<double>::infinity()) == "null");
+		TEST_CHECK(writeDouble(std::numeric_limits<double>::quiet_NaN()) == "null");
+
+		std::string output;
+		Json::Writer writer(output);
+		writer.onListOpen();
+		writer.onValue(std::nan(""));
+		writer.onValue(1.0);
+		writer.onValue(std::numeric_limits<double>::infinity());
+		writer.onListClose();
+		writer.flush();
+		TEST_CHECK(output == "[null,1.0,null]");
+	} });
+
+	tests.push_back(Test{ "integers", []
+	{
+		Json::Parser parser;
+		const std::string input = "[0,-1,2147483648,-9223372036854775808,18446744073709551615]";
+		TEST_CHECK(write(*parser.parseString(input)) == input);
+	} });
+
+	tests.push_back(Test{ "compact-and-pretty", []
+	{
+		Json::Parser parser;
+		const std::shared_ptr<Json::Node> root = parser.parseString(R"({"a": [1, {}, []], "b": {"c": null}, "d": []})");
+
+		TEST_CHECK(write(*root) == R"({"a":[1,{},[]],"b":{"c":null},"d":[]})");
+		TEST_CHECK(write(*root, Json::Writer::Style::Pretty) ==
+			"{\n"
+			"  \"a\": [\n"
+			"    1,\n"
+			"    {},\n"
+			"    []\n"
+			"  ],\n"
+			"  \"b\": {\n"
+			"    \"c\": null\n"
+			"  },\n"
+			"  \"d\": []\n"
+			"}");
+
+		TEST_CHECK(write(*parser.parseString("[]"), Json::Writer::Style::Pretty) == "[]");
+		TEST_CHECK(write(*parser.parseString(write(*root, Json::Writer::Style::Pretty))) == write(*root));
+	} });
+
+	tests.push_back(Test{ "same-output-for-every-representation", []
+	{
+		const std::string input = R"([{"id": 1, "name": "caf\u00e9", "tags": ["x", "y\n"]}, 2.5, -0.0, true, null, []])";
+
+		Json::Parser parser;
+		const std::string expected = write(*parser.parseString(input));
+		const Json::Document document = parser.parseDocument(input.data(), input.size());
+		const Json::Tape tape = parser.parseTape(input.data(), input.size());
+
+		TEST_CHECK(write(document.getRoot()) == expected);
+		TEST_CHECK(write(tape.getRoot()) == expected);
+	} });
+
+	// The writer hands the text to the sink in pieces of at most one buffer,
+	// except for a single string that does not fit, which is passed on as
+	// it is.
+	tests.push_back(Test{ "large-output-through-sink", []
+	{
+		std::string input = "[";
+		for (int i = 0; i < 20000; i++)
+		{
+			input += (i == 0 ? "" : ",") + std::string("{\"id\":") + std::to_string(i) + ",\"text\":\"line\\n\\\"" + std::to_string(i) + "\"}";
+		}
+		input += ",\"" + std::string(3 * bufferSize, 'x') + "\"]";
+		TEST_CHECK(input.size() > 4 * bufferSize);
+
+		Json::Parser parser;
+		const std::shared_ptr<Json::Node> root = parser.parseString(input);
+
+		std::string collected;
+		std::size_t calls = 0;
+		bool isChunked = true;
+		{
+			Json::Writer writer([&](const char* data, std::size_t size)
+			{
+				isChunked = isChunked && (size <= bufferSize || size == 3 * bufferSize);
+				collected.append(data, size);
+				calls++;
+			});
+			writer.write(*root);
+		}
+
+		TEST_CHECK(collected == input);
+		TEST_CHECK(calls > 2);
+		TEST_CHECK(isChunked);
+
+		std::ostringstream stream;
+		{
+			Json::Writer writer(stream);
+			writer.write(*root);
+		}
+		TEST_CHECK(stream.str() == input);
+	} });
+
+	tests.push_back(Test{ "lazy-numbers-verbatim", []
+	{
+		const std::string input = "[1.50,1e2,-0,0.1000000000000000055511151231257827,12345678901234567890123,1E-2]";
+
+		Json::Parser parser;
+		TEST_CHECK(write(*parser.parseString(input, Json::Parser::NumberConversion::Lazy)) == input);
+		TEST_CHECK(write(*parser.parseString(input)) != input);
+	} });
+
+	tests.push_back(Test{ "rejects-misplaced-tokens", []
+	{
+		std::string output;
+		TEST_CHECK(throws([&] { Json::Writer writer(output); writer.onKey("a"); }));
+		TEST_CHECK(throws([&] { Json::Writer writer(output); writer.onObjectOpen(); writer.onValue(true); }));
+		TEST_CHECK(throws([&] { Json::Writer writer(output); writer.onListOpen(); writer.onObjectClose(); }));
+		TEST_CHECK(throws([&] { Json::Writer writer(output); writer.onObjectOpen(); writer.onKey("a"); writer.onObjectClose(); }));
+		TEST_CHECK(throws([&] { Json::Writer writer(output); writer.onListClose(); }));
+	} });
+
+	return tests;
+}